@@ -57,6 +57,8 @@ struct gl_multi_buffer : public gl_buffer {
     vector<GLsizei> counts;
     /// The beginning of all index buffer inside this multi buffer.
     vector<GLsizeiptr> indices;
+    /// The base vertex of all buffers inside this multi buffer, which is added to their indices.
+    vector<GLint> base_vertices;
 };
 
 }
@@ -2,17 +2,31 @@
 #define TSE_GRID_HPP
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 #include <tsl/geometry/vector.hpp>
+#include <tsl/geometry/tmesh/handles.hpp>
+#include <tsl/evaluation/border_stitching.hpp>
+#include <tsl/evaluation/eval_sink.hpp>
+#include <tsl/evaluation/surface_bvh.hpp>
+#include <tsl/evaluation/surface_evaluator.hpp>
 #include <tsl/grid.hpp>
 
 #include "tse/gl_buffer.hpp"
+#include "tse/rendering/lod.hpp"
 #include "tse/rendering/picking_map.hpp"
 
+using std::optional;
 using std::vector;
 
+using tsl::border_stitch;
 using tsl::regular_grid;
+using tsl::eval_sink;
+using tsl::surface_bvh;
+using tsl::surface_evaluator;
+using tsl::face_handle;
+using tsl::vec3;
 
 namespace tse {
 
@@ -31,6 +45,135 @@ gl_buffer add_to_render_buffer(const regular_grid& grid, gl_buffer& buffer, pick
  */
 gl_multi_buffer get_multi_render_buffer(const vector<regular_grid>& grids, picking_map& picking_map);
 
+/**
+ * @brief The evaluated surface in the layout of the surface vertex buffer, so it can be uploaded without conversion.
+ *
+ * Each face is evaluated with its own resolution and occupies `(res + 1)^2` vertices. Faces with the same resolution
+ * share the same indices (see `get_multi_index_buffer`).
+ */
+struct surface_data {
+    /// The resolution the surface was requested with. If `adaptive` is set, this is the max resolution of the faces.
+    uint32_t res;
+    /// True, if the resolution of each face was selected from its size on the screen (see `select_face_res`).
+    bool adaptive;
+    /// The evaluated faces sorted by their handles.
+    vector<face_handle> faces;
+    /// The resolution of each face.
+    vector<uint32_t> face_res;
+    /// The index of the first vertex of each face.
+    vector<size_t> first_vertices;
+    /// The vertices of all faces. The vertices of each face are stored row by row.
+    vector<vertex_element> vertices;
+    /// The moves of border vertices, which close the cracks between the faces (see `tsl::get_border_stitches`). The
+    /// faces of the stitches are indices in `faces`.
+    vector<border_stitch> stitches;
+    /// Size and flatness of each face, which was used to select its resolution. Empty, if `adaptive` is false.
+    vector<face_lod> lods;
+
+    surface_data() : res(0), adaptive(false) {}
+
+    /**
+     * @brief Returns the number of vertices of the face with the given index.
+     */
+    size_t num_vertices(size_t face) const;
+
+    /**
+     * @brief Returns the index of the given face or none, if the face was not evaluated.
+     */
+    optional<size_t> find_face(face_handle handle) const;
+
+    /**
+     * @brief Appends a face with the given resolution and returns its index. The positions and normals of its vertices
+     *        have to be set afterwards, the picking ids are set to `picking_map::FIRST_ID + index`.
+     */
+    size_t add_face(face_handle handle, uint32_t res);
+
+    /**
+     * @brief Returns the distinct resolutions of all faces in ascending order.
+     */
+    vector<uint32_t> get_resolutions() const;
+
+    /**
+     * @brief Removes all faces, but keeps the allocated memory to be reused by the next evaluation.
+     */
+    void clear();
+};
+
+/**
+ * @brief Writes evaluated faces directly into the vertices of a `surface_data`.
+ *
+ * The picking id of the i-th face is `picking_map::FIRST_ID + i`, so the faces have to be added to a cleared picking
+ * map in the same order to resolve the ids.
+ */
+class surface_sink : public eval_sink {
+public:
+    /**
+     * @brief Appends every evaluated face to the given surface.
+     */
+    explicit surface_sink(surface_data& surface) : surface(surface), first_vertex(0), num_points_x(0) {}
+
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override;
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override;
+
+private:
+    surface_data& surface;
+    /// First vertex of the current face.
+    size_t first_vertex;
+    /// Number of points of the current face in x direction.
+    size_t num_points_x;
+};
+
+/**
+ * @brief Overwrites the vertices of faces, which are already contained in a `surface_data`, and keeps their picking
+ *        ids. Faces, which are not contained or have a different size, are ignored.
+ */
+class surface_patch_sink : public eval_sink {
+public:
+    /**
+     * @brief Patches the faces of the given surface.
+     */
+    explicit surface_patch_sink(surface_data& surface) : surface(surface), first_vertex(0), num_points_x(0) {}
+
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override;
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override;
+
+    /// Indices (in `surface_data::faces`) of the patched faces in the order they were patched.
+    vector<size_t> patched;
+
+private:
+    surface_data& surface;
+    /// First vertex of the current face or none, if the current face is ignored.
+    optional<size_t> first_vertex;
+    /// Number of points of the current face in x direction.
+    size_t num_points_x;
+};
+
+/**
+ * @brief Creates a `gl_multi_buffer` without vertices for the faces of the given surface.
+ *
+ * The index buffer contains the indices of a single grid for each distinct resolution, which are shared by all faces
+ * with this resolution. Thus the buffer has to be drawn with `glMultiDrawElementsBaseVertex`. The index buffer only
+ * changes, if the distinct resolutions of the faces (see `surface_data::get_resolutions`) change.
+ */
+gl_multi_buffer get_multi_index_buffer(const surface_data& surface);
+
+/**
+ * @brief Builds a `surface_bvh` over the triangles of the given surface, which was evaluated by the given evaluator.
+ *        The triangles are the same as the rendered ones.
+ */
+surface_bvh get_surface_bvh(const surface_evaluator& evaluator, const surface_data& surface);
+
+/**
+ * @brief Copies the vertices of the faces with the given indices (in `surface_data::faces`) into the given hierarchy,
+ *        which was built by `get_surface_bvh` for the given surface, and refits it.
+ */
+void refit_surface_bvh(
+    surface_bvh& bvh,
+    const surface_evaluator& evaluator,
+    const surface_data& surface,
+    const vector<size_t>& faces
+);
+
 }
 
 #endif //TSE_GRID_HPP
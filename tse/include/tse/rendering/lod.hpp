@@ -0,0 +1,151 @@
+#ifndef TSE_LOD_HPP
+#define TSE_LOD_HPP
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <tsl/geometry/vector.hpp>
+#include <tsl/geometry/tmesh/handles.hpp>
+#include <tsl/grid.hpp>
+#include <tsl/evaluation/eval_cache.hpp>
+#include <tsl/evaluation/surface_evaluator.hpp>
+#include <tsl/util/lru_cache.hpp>
+
+#include "tse/gl_buffer.hpp"
+
+using std::map;
+using std::pair;
+using std::vector;
+
+using tsl::eval_cache_key;
+using tsl::eval_cache_key_hash;
+using tsl::face_handle;
+using tsl::lru_cache;
+using tsl::regular_grid;
+using tsl::surface_evaluator;
+using tsl::vec3;
+
+namespace tse {
+
+struct surface_data;
+
+/// Resolution, which is used to measure the bounds and flatness of a face.
+constexpr uint32_t LOD_MEASURE_RES = 2;
+
+/// Max number of bytes used by the vertices in a `face_grid_cache`.
+constexpr size_t FACE_GRID_CACHE_SIZE = 256 * 1024 * 1024;
+
+/**
+ * @brief POD type to hold the size and flatness of a face, which are used to select its resolution.
+ */
+struct face_lod {
+    /// Center of the bounding sphere of the face.
+    vec3 center;
+    /// Radius of the bounding sphere of the face.
+    double radius;
+    /// Max distance between the surface of the face and the bilinear patch through its corners. The distance between
+    /// the surface and its triangles at resolution `res` is approximately `flatness / res^2`.
+    double flatness;
+
+    face_lod() : center(0, 0, 0), radius(0), flatness(0) {}
+};
+
+/**
+ * @brief POD type to hold the camera parameters, which are needed to select the resolution of the faces.
+ */
+struct lod_view {
+    /// Position of the camera.
+    vec3 camera_pos;
+    /// Number of pixels, which are covered by an object of size 1 in distance 1 to the camera.
+    double pixels_per_unit;
+    /// The max distance between the surface and its triangles in pixels.
+    double max_error;
+    /// The max resolution of a face. Only powers of two are used, so smaller values are rounded down to one.
+    uint32_t max_res;
+
+    lod_view(const vec3& camera_pos, double pixels_per_unit, double max_error, uint32_t max_res)
+        : camera_pos(camera_pos), pixels_per_unit(pixels_per_unit), max_error(max_error), max_res(max_res) {}
+};
+
+/**
+ * @brief Calculates the size and flatness of a face from its grid evaluated with `LOD_MEASURE_RES`.
+ */
+face_lod calc_face_lod(const regular_grid& grid);
+
+/**
+ * @brief Selects the smallest resolution for the face, at which the projected distance between the surface and its
+ *        triangles is smaller than the max error of the view. The resolution is a power of two.
+ */
+uint32_t select_face_res(const face_lod& lod, const lod_view& view);
+
+/**
+ * @brief Finds the moves of border vertices, which remove the cracks between the faces of the given surface, and
+ *        stores them in `surface_data::stitches`. The surface has to be evaluated by the given evaluator.
+ *
+ * @see tsl::get_border_stitches
+ */
+void update_stitches(const surface_evaluator& evaluator, surface_data& surface);
+
+/**
+ * @brief Moves the border vertices of all faces of the given surface by its stitches (see `update_stitches`).
+ */
+void stitch_borders(surface_data& surface);
+
+/**
+ * @brief Applies the stitches of the given surface again, which read or move vertices of the given faces, e.g.
+ *        because these faces were evaluated again. Returns the given faces and all faces, whose vertices were moved,
+ *        as indices in `surface_data::faces` in ascending order.
+ */
+vector<size_t> stitch_borders(surface_data& surface, const vector<size_t>& faces);
+
+/**
+ * @brief Caches the evaluated vertices of each face and resolution, so faces don't have to be evaluated again, when
+ *        they switch back to a resolution. The cached vertices are not stitched.
+ *
+ * The faces are identified by their version (see `surface_evaluator::get_face_version`), so the cache doesn't have to
+ * be cleared, when the evaluator is changed or replaced. When the cache is full, the least recently used faces are
+ * evicted.
+ */
+class face_grid_cache {
+public:
+    /**
+     * @brief Creates an empty cache, whose vertices use at most `max_bytes` bytes.
+     */
+    explicit face_grid_cache(size_t max_bytes = FACE_GRID_CACHE_SIZE);
+
+    /**
+     * @brief Returns the cached vertices of the given face, resolution and version or nullptr, if there are none.
+     */
+    const vector<vertex_element>* find(face_handle handle, uint32_t res, uint64_t version);
+
+    /**
+     * @brief Caches the vertices of the given face, resolution and version.
+     */
+    void insert(face_handle handle, uint32_t res, uint64_t version, vector<vertex_element>&& vertices);
+
+    /**
+     * @brief Returns the cached lod infos of the given face and version or nullptr, if there are none.
+     */
+    const face_lod* find_lod(face_handle handle, uint64_t version) const;
+
+    /**
+     * @brief Caches the lod infos of the given face and version.
+     */
+    void insert_lod(face_handle handle, uint64_t version, const face_lod& lod);
+
+    /**
+     * @brief Removes everything from the cache.
+     */
+    void clear();
+
+private:
+    lru_cache<eval_cache_key, vector<vertex_element>, eval_cache_key_hash> grids;
+    /// The latest lod infos of each face with their version.
+    map<face_handle, pair<uint64_t, face_lod>> lods;
+};
+
+}
+
+#endif //TSE_LOD_HPP
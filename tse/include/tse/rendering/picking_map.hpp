@@ -51,7 +51,10 @@ private:
     /// Map to store relation between id and elements.
     unordered_map<uint32_t, picking_element> map;
 public:
-    picking_map() : next(1) {}
+    /// Id of the first element, which is added after construction or after `clear()`.
+    static constexpr uint32_t FIRST_ID = 1;
+
+    picking_map() : next(FIRST_ID) {}
 
     /**
      * @brief Adds an object to the picking map with the given type and the given handle and returns the id of the
@@ -65,7 +68,7 @@ public:
     optional<picking_element> get_object(uint32_t idx) const;
 
     /**
-     * @brief Clears the map and removes all entries.
+     * @brief Clears the map and removes all entries. The ids are given out from `FIRST_ID` again.
      */
     void clear();
 };
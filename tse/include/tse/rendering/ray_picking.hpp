@@ -0,0 +1,62 @@
+#ifndef TSE_RAY_PICKING_HPP
+#define TSE_RAY_PICKING_HPP
+
+#include <optional>
+
+#include <tsl/evaluation/surface_bvh.hpp>
+#include <tsl/geometry/line.hpp>
+#include <tsl/geometry/vector.hpp>
+#include <tsl/geometry/tmesh/control_polygon_bvh.hpp>
+
+#include "tse/rendering/picking_map.hpp"
+
+using std::optional;
+
+using tsl::control_polygon_bvh;
+using tsl::line;
+using tsl::surface_bvh;
+using tsl::vec3;
+
+namespace tse {
+
+/// Max distance between a ray and a control vertex to pick the vertex. Matches `POINT_THICKNESS` of the vertex shader.
+constexpr double VERTEX_PICKING_RADIUS = 0.02;
+
+/// Max distance between a ray and a control edge to pick the edge. Matches `LINE_THICKNESS` of the polygon shader.
+constexpr double EDGE_PICKING_RADIUS = 0.01;
+
+/**
+ * @brief POD type to hold an element, which was hit by a picking ray.
+ */
+struct ray_pick {
+    /// The picked element.
+    picking_element element;
+    /// The point on the element, which was hit.
+    vec3 point;
+    /// The parameter of the hit point on the ray.
+    double t;
+
+    ray_pick(const picking_element& element, const vec3& point, double t) : element(element), point(point), t(t) {}
+};
+
+/**
+ * @brief Returns the vertex or edge of the control polygon in the given hierarchy, which is hit first by the given
+ *        ray. The normal of the ray has to be normalized.
+ *
+ * Vertices and edges are hit, if the ray passes them closer than `VERTEX_PICKING_RADIUS` and `EDGE_PICKING_RADIUS`.
+ * Edges are only hit within the parameter range [0, t_max]. Vertices are preferred to edges and are hit even
+ * behind `t_max`, so vertices, which are hidden by the surface, can still be selected.
+ */
+optional<ray_pick> pick_control_polygon(const control_polygon_bvh& polygon, const line& ray, double t_max);
+
+/**
+ * @brief Returns the face of the given surface hierarchy, which is hit first by the given ray, or the element of the
+ *        given control polygon, which is picked in front of this face (see `pick_control_polygon`).
+ *
+ * The surface or the control polygon is skipped, if its hierarchy is `nullptr`.
+ */
+optional<ray_pick> pick_element(const surface_bvh* bvh, const control_polygon_bvh* polygon, const line& ray);
+
+}
+
+#endif //TSE_RAY_PICKING_HPP
@@ -1,6 +1,7 @@
 #ifndef TSE_RENDERING_TMESH_HPP
 #define TSE_RENDERING_TMESH_HPP
 
+#include <optional>
 #include <vector>
 #include <set>
 
@@ -9,7 +10,9 @@
 
 #include "tse/rendering/picking_map.hpp"
 #include "tse/gl_buffer.hpp"
+#include "tse/rendering/grid.hpp"
 
+using std::optional;
 using std::vector;
 using std::set;
 
@@ -19,21 +22,40 @@ using tsl::tmesh;
 namespace tse
 {
 
+/// Value of picked elements in the buffers created by `get_picked_*_buffer`.
+constexpr uint8_t PICKED_VALUE = 1;
+/// Value of the hovered element in the buffers created by `get_picked_*_buffer`, if it isn't picked.
+constexpr uint8_t HOVERED_VALUE = 2;
+
 /**
- * @brief Creates a buffer with picking ids for faces from the given vector of
- * regular grids and a set of picked elements.
+ * @brief Creates a buffer with picking ids for faces from the given evaluated surface, a set of picked elements and
+ *        the hovered element.
  */
-vector<uint8_t> get_picked_faces_buffer(const vector<regular_grid>& faces, const set<picking_element>& picked);
+vector<uint8_t> get_picked_faces_buffer(
+    const surface_data& surface,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+);
 
 /**
- * @brief Creates a buffer with picking ids for edges from the given tmesh and a set of picked elements.
+ * @brief Creates a buffer with picking ids for edges from the given tmesh, a set of picked elements and the hovered
+ *        element.
  */
-vector<uint8_t> get_picked_edges_buffer(const tmesh& mesh, const set<picking_element>& picked);
+vector<uint8_t> get_picked_edges_buffer(
+    const tmesh& mesh,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+);
 
 /**
- * @brief Creates a buffer with picking ids for vertices from the given tmesh and a set of picked elements.
+ * @brief Creates a buffer with picking ids for vertices from the given tmesh, a set of picked elements and the
+ *        hovered element.
  */
-vector<uint8_t> get_picked_vertices_buffer(const tmesh& mesh, const set<picking_element>& picked);
+vector<uint8_t> get_picked_vertices_buffer(
+    const tmesh& mesh,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+);
 
 /**
  * @brief Generates an OpenGL ready buffer for picking edges from the given tmesh and picking map.
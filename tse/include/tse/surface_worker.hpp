@@ -0,0 +1,203 @@
+#ifndef TSE_SURFACE_WORKER_HPP
+#define TSE_SURFACE_WORKER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tsl/evaluation/surface_bvh.hpp>
+#include <tsl/evaluation/surface_evaluator.hpp>
+#include <tsl/geometry/tmesh/tmesh.hpp>
+
+#include "tse/rendering/grid.hpp"
+#include "tse/rendering/lod.hpp"
+
+using std::atomic;
+using std::condition_variable;
+using std::function;
+using std::mutex;
+using std::nullopt;
+using std::optional;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::vector;
+
+using tsl::evaluator_config;
+using tsl::surface_bvh;
+using tsl::surface_evaluator;
+using tsl::tmesh;
+
+namespace tse {
+
+/**
+ * @brief The result of a job of the `surface_worker`.
+ */
+struct surface_result {
+    /// The newly created evaluator, if the job created one. `nullptr` if the job evaluated an existing evaluator.
+    shared_ptr<surface_evaluator> evaluator;
+    /// The evaluated surface.
+    surface_data surface;
+    /// Hierarchy over the triangles of `surface`, which is used to pick faces on the cpu.
+    surface_bvh bvh;
+    /// If this is not none, the job failed with this message and `evaluator` and `surface` are empty.
+    optional<string> error;
+    /// The evaluator, which was evaluated by the job (the new one for loading jobs). `nullptr`, if the job failed
+    /// before. Only used to compare it with other evaluators, it is not kept alive by the result.
+    const surface_evaluator* evaluated;
+
+    surface_result() : evaluator(nullptr), evaluated(nullptr) {}
+};
+
+/**
+ * @brief Builds surface evaluators and evaluates surfaces on a background thread.
+ *
+ * The worker holds at most one job. Submitting a job cancels the job which is currently running or waiting, because
+ * its result would be obsolete anyway. Only the result of the latest job is handed out by `take_result()`.
+ *
+ * The hierarchy used for picking (`surface_result::bvh`) is built on the worker thread as well, so the main thread
+ * never has to walk all triangles of a new surface.
+ *
+ * The evaluator of an evaluation job is read by the worker thread while the job runs. It may be read by other threads
+ * as well, but before it is changed, `cancel()` has to be called.
+ *
+ * If a job is given a `lod_view`, the resolution of each face is selected from its size on the screen. The evaluated
+ * faces are cached for each resolution and version of the face, so jobs for a moved camera or a resolution, which was
+ * used before, only evaluate the faces, which were not evaluated before or have changed since.
+ */
+class surface_worker {
+public:
+    /**
+     * @brief Starts the worker thread.
+     */
+    surface_worker();
+    surface_worker(const surface_worker&) = delete;
+    surface_worker(surface_worker&&) = delete;
+    surface_worker& operator=(const surface_worker&) = delete;
+    surface_worker& operator=(surface_worker&&) = delete;
+
+    /**
+     * @brief Cancels the current job and stops the worker thread.
+     */
+    ~surface_worker();
+
+    /**
+     * @brief Evaluates the surface of the given evaluator with the given resolution. If a view is given, the
+     *        resolution of each face is selected for this view and `res` is ignored.
+     */
+    void evaluate(shared_ptr<const surface_evaluator> evaluator, uint32_t res, optional<lod_view> view = nullopt);
+
+    /**
+     * @brief Creates a mesh with `create_mesh`, builds a new evaluator with the given config for it and evaluates it
+     *        like `evaluate`. Exceptions thrown while doing so are reported as `surface_result::error`.
+     */
+    void load(
+        function<tmesh()> create_mesh,
+        evaluator_config config,
+        uint32_t res,
+        optional<lod_view> view = nullopt
+    );
+
+    /**
+     * @brief Cancels the current job and blocks until the worker does not access any evaluator anymore.
+     */
+    void cancel();
+
+    /**
+     * @brief Returns true, if a job is running or waiting, whose result was not taken yet.
+     */
+    bool is_busy() const;
+
+    /**
+     * @brief Returns true, if the current job will create a new evaluator.
+     */
+    bool is_loading() const;
+
+    /**
+     * @brief Returns the result of the latest job, if it is finished. Each result is returned only once.
+     */
+    optional<surface_result> take_result();
+
+    /**
+     * @brief Hands a surface, which is not needed anymore, back to the worker. Its memory is reused by the next job
+     *        instead of allocating a new vertex buffer for every evaluation.
+     */
+    void recycle(surface_data&& surface);
+
+private:
+    /// A job of the worker. If `create_mesh` is set, a new evaluator is built, otherwise `evaluator` is evaluated.
+    struct job {
+        shared_ptr<const surface_evaluator> evaluator;
+        function<tmesh()> create_mesh;
+        evaluator_config config;
+        uint32_t res;
+        optional<lod_view> view;
+    };
+
+    /// Guards all members below.
+    mutable mutex lock;
+    /// Notifies the worker about a new job and the main thread about a finished or cancelled job.
+    condition_variable changed;
+
+    /// The job which waits to be processed.
+    optional<job> pending;
+    /// True, while the worker processes a job.
+    bool running;
+    /// True, if the running job creates a new evaluator.
+    bool running_load;
+    /// The result of the latest finished job.
+    optional<surface_result> result;
+    /// True, if the worker thread should stop.
+    bool stop;
+    /// Memory for the surface of the next job.
+    surface_data spare;
+
+    /// Set to abort the running job.
+    atomic<bool> cancelled;
+
+    /// Evaluated faces of all evaluators. Only accessed by the worker thread.
+    face_grid_cache cache;
+
+    thread worker;
+
+    /**
+     * @brief Submits the given job and cancels the running and pending job.
+     */
+    void submit(job&& next);
+
+    /**
+     * @brief The main loop of the worker thread.
+     */
+    void run();
+
+    /**
+     * @brief Processes the given job.
+     */
+    surface_result process(const job& current, surface_data&& surface);
+
+    /**
+     * @brief Evaluates all faces of the given evaluator with the given resolution.
+     */
+    void eval_uniform(const surface_evaluator& evaluator, uint32_t res, surface_data& surface);
+
+    /**
+     * @brief Evaluates the faces of the given evaluator with the resolutions selected for the given view.
+     */
+    void eval_adaptive(const surface_evaluator& evaluator, const lod_view& view, surface_data& surface);
+
+    /**
+     * @brief Appends the given face with the given resolution to the surface. The face is taken from the cache or
+     *        evaluated and cached. Returns false, if the face can't be evaluated.
+     */
+    bool add_face(const surface_evaluator& evaluator, face_handle handle, uint32_t res, surface_data& surface);
+};
+
+}
+
+#endif //TSE_SURFACE_WORKER_HPP
@@ -10,23 +10,35 @@
 
 #include <GLFW/glfw3.h>
 
+#include <tsl/evaluation/surface_bvh.hpp>
 #include <tsl/evaluation/surface_evaluator.hpp>
+#include <tsl/geometry/tmesh/control_polygon_bvh.hpp>
 
 #include "tse/mouse_pos.hpp"
 #include "tse/application.hpp"
 #include "tse/camera.hpp"
 #include "tse/gl_buffer.hpp"
 #include "tse/resolution.hpp"
+#include "tse/surface_worker.hpp"
 #include "tse/rendering/picking_map.hpp"
+#include "tse/rendering/ray_picking.hpp"
 #include "tse/rendering/grid.hpp"
+#include "tse/rendering/lod.hpp"
 
 using std::string;
 using std::reference_wrapper;
 using std::set;
 using std::unique_ptr;
+using std::shared_ptr;
+using std::function;
 
 using tsl::vec3;
+using tsl::surface_bvh;
+using tsl::control_polygon_bvh;
 using tsl::surface_evaluator;
+using tsl::evaluator_config;
+using tsl::tmesh;
+using tsl::vertex_handle;
 
 namespace tse {
 
@@ -43,6 +55,29 @@ struct request_pick_data {
     request_pick_data(const mouse_pos& pos, bool single_select) : pos(pos), single_select(single_select) {}
 };
 
+/**
+ * @brief POD type to represent the input of the last hover pick. The element under the mouse cursor only has to be
+ *        picked again, if one of these changed (or the picked geometry, which resets the query).
+ */
+struct hover_query {
+    /// Mouse position, at which was picked.
+    mouse_pos pos;
+    /// View projection matrix of the camera, with which was picked.
+    mat4 vp;
+    /// True, if the surface was picked.
+    bool surface;
+    /// True, if the control polygon was picked.
+    bool control_polygon;
+
+    hover_query(const mouse_pos& pos, const mat4& vp, bool surface, bool control_polygon) :
+        pos(pos), vp(vp), surface(surface), control_polygon(control_polygon) {}
+
+    bool operator==(const hover_query& other) const {
+        return pos.x == other.pos.x && pos.y == other.pos.y && vp == other.vp && surface == other.surface
+            && control_polygon == other.control_polygon;
+    }
+};
+
 /**
  * @brief POD type to represent the direction along which should be moved.
  */
@@ -67,7 +102,10 @@ struct show_dialogs {
     /// True, if the remove edges dialog should be shown, false otherwise.
     bool remove_edges;
 
-    show_dialogs() : settings(false), selected_elements(false), remove_edges(false) {}
+    /// True, if the memory dialog should be shown, false otherwise.
+    bool memory;
+
+    show_dialogs() : settings(false), selected_elements(false), remove_edges(false), memory(false) {}
 };
 
 struct glfw_window_destructor {
@@ -171,24 +209,18 @@ private:
     // picking stuff
     /// Picking map-
     class picking_map picking_map;
-    GLuint vertex_picking_program;
-    GLuint edge_picking_program;
-    GLuint surface_picking_program;
 
-    GLuint control_picking_edges_vertex_array;
-    GLuint control_picking_vertices_vertex_array;
-    GLuint surface_picking_vertex_array;
-
-    GLuint picking_frame;
-    GLuint picking_texture;
-    GLuint picking_render;
-
-    /// If this is not none, it contains the start position of the currently moving object.
+    /// If this is not none, it contains the point on the plane, in which the currently moving object is moved, at
+    /// the last mouse position. When the move starts, this is the point of the object, which was hit by the pick.
     optional<vec3> start_move;
     /// If this is not none, it contains the currently requested element pick.
     optional<request_pick_data> request_pick;
     /// Set of currently picked elements.
     set<picking_element> picked_elements;
+    /// The element under the mouse cursor, if it isn't picked, or none.
+    optional<picking_element> hovered;
+    /// Input of the pick, which found `hovered`. Reset to none, when the picked geometry or the selection changes.
+    optional<hover_query> last_hover;
     /// If this is not none, it contains the elements which should be removed.
     optional<picking_element> request_remove;
     /// The current direction along wich the currently moved object should be moved.
@@ -219,18 +251,38 @@ private:
 
     /// Percentage of edges which should be removed.
     float edge_remove_percentage;
-    /// Resolution of the surface.
+    /// Resolution of the surface. If `adaptive_resolution` is set, this is the max resolution of the faces.
     resolution<uint32_t> surface_resolution;
+    /// True, if the resolution of each face should be selected from its size on the screen.
+    bool adaptive_resolution;
+    /// Max distance between the surface and its triangles in pixels, if `adaptive_resolution` is set.
+    float max_pixel_error;
     /// Size of cube loaded at start
     int cube_size;
-    /// Surface evaluator.
-    surface_evaluator evaluator;
-
-    /// Evaluated grids of the surface.
-    vector<regular_grid> tmesh_faces;
+    /// Config used for the surface evaluator.
+    evaluator_config config;
+    /// Surface evaluator. It is shared with `worker` while the surface is evaluated in the background.
+    shared_ptr<surface_evaluator> evaluator;
+    /// Builds evaluators and evaluates the surface in the background.
+    unique_ptr<surface_worker> worker;
+
+    /// Evaluated surface, which is currently uploaded to the surface buffer.
+    surface_data surface;
+    /// Hierarchy over the triangles of `surface`, which is used to pick faces.
+    surface_bvh bvh;
+    /// Hierarchy over the control polygon of the mesh of `evaluator`, which is used to pick vertices and edges.
+    control_polygon_bvh control_bvh;
+    /// True, if the last background update failed and `surface` doesn't match the evaluator.
+    bool surface_outdated;
+    /// Resolutions of the indices in the surface index buffer.
+    vector<uint32_t> surface_index_res;
 
     /// Camera
     class camera camera;
+    /// Vertical field of view of the camera in degrees.
+    static constexpr float FIELD_OF_VIEW = 45.0f;
+    /// File the trace is written to (see `toggle_trace`).
+    static constexpr const char* TRACE_PATH = "tse_trace.json";
 
     friend class application;
 
@@ -240,49 +292,91 @@ private:
     void update_buffer();
 
     /**
-     * @brief Updates the surface buffer.
+     * @brief Uploads the current `surface` to the surface buffer. The index buffer is only uploaded, if the
+     *        resolutions of the faces have changed.
      */
     void update_surface_buffer();
 
     /**
-     * @brief Updates the control polygon buffers.
+     * @brief Updates the control polygon buffers and the picked buffer, but keeps the surface buffer.
+     *
+     * The picking map is rebuilt in the same order as in `update_buffer`, so the picking ids stored in the surface
+     * buffer stay valid and the picked elements are kept.
      */
-    void update_control_buffer();
+    void update_control_and_picked_buffer();
 
     /**
-     * @brief Updates the picking buffer.
+     * @brief Evaluates the faces depending on the moved vertices and patches their ranges in the surface buffer.
+     *
+     * The picking ids, the picked elements and the resolutions of the faces are kept. This requires `surface` to
+     * match the structure of the current evaluator.
      */
-    void update_picked_buffer();
+    void update_moved_surface(const set<vertex_handle>& moved);
 
     /**
-     * @brief Updates the sizes of the used textures.
+     * @brief Returns the view to select the resolution of each face or none, if all faces use the same resolution.
      */
-    void update_texture_sizes() const;
+    optional<lod_view> get_lod_view() const;
 
     /**
-     * @brief Draws the surface.
+     * @brief Requests a new evaluation, if the resolutions selected for the current camera differ from the ones of
+     *        the displayed surface.
      */
-    void draw_surface(const mat4& model, const mat4& vp) const;
+    void update_lod();
 
     /**
-     * @brief Draws the surface normals.
+     * @brief Patches the positions of the moved vertices and their edges in the control polygon buffers and refits
+     *        `control_bvh` to them.
      */
-    void draw_surface_normals(const mat4& model, const mat4& vp) const;
+    void update_moved_control_polygon(const set<vertex_handle>& moved);
 
     /**
-     * @brief Draws the surface into the offscreen framebuffer used for picking.
+     * @brief Requests a new evaluation of the current evaluator in the background. The result is applied in
+     *        `apply_surface_result`.
      */
-    void draw_surface_picking(const mat4& model, const mat4& vp) const;
+    void request_surface_update();
 
     /**
-     * @brief Draws the control polygon.
+     * @brief Requests to build a new evaluator for the mesh created by `create_mesh` in the background. The current
+     *        evaluator is replaced in `apply_surface_result`, when the new one is ready.
      */
-    void draw_control_polygon(const mat4& model, const mat4& vp) const;
+    void request_load(function<tmesh()> create_mesh);
+
+    /**
+     * @brief Returns the evaluator for changing it. This cancels the background evaluation, which would be obsolete
+     *        after the change anyway.
+     */
+    surface_evaluator& edit_evaluator();
 
     /**
-     * @brief Draws the control polygon into the offscreen framebuffer used for picking.
+     * @brief Applies the result of the background worker (if there is one) and updates all buffers.
      */
-    void draw_control_polygon_picking(const mat4& model, const mat4& vp) const;
+    void apply_surface_result();
+
+    /**
+     * @brief Updates the control polygon buffers and rebuilds `control_bvh`.
+     */
+    void update_control_buffer();
+
+    /**
+     * @brief Updates the picking buffer.
+     */
+    void update_picked_buffer();
+
+    /**
+     * @brief Draws the surface.
+     */
+    void draw_surface(const mat4& model, const mat4& vp) const;
+
+    /**
+     * @brief Draws the surface normals.
+     */
+    void draw_surface_normals(const mat4& model, const mat4& vp) const;
+
+    /**
+     * @brief Draws the control polygon.
+     */
+    void draw_control_polygon(const mat4& model, const mat4& vp) const;
 
     /**
      * @brief Draws the GUI.
@@ -300,19 +394,42 @@ private:
     vec3 get_ray(const mouse_pos& mouse_pos, const mat4& vp) const;
 
     /**
-     * @brief Reads the pixel at the given position.
+     * @brief Returns the visible element under the given mouse position or none, if there is none.
+     *
+     * The faces are intersected with `bvh` and the control polygon with its vertices and edges on the cpu. The surface
+     * is skipped, while it is updated, because `bvh` may belong to an outdated mesh then.
+     */
+    optional<ray_pick> pick(const mouse_pos& pos, const mat4& vp) const;
+
+    /**
+     * @brief Returns true, if `bvh` matches the current mesh and the surface is shown, so it can be picked.
      */
-    uint32_t read_pixel(const mouse_pos& pos) const;
+    bool is_surface_pickable() const;
 
     /**
-     * @brief Handles the picking request.
+     * @brief Selects the given picked element like requested by the given pick and starts to move it at the picked
+     *        point, if the mouse button is still pressed.
      */
-    void picking_phase(const mat4& model, const mat4& vp);
+    void apply_pick(const request_pick_data& request, const optional<ray_pick>& picked);
+
+    /**
+     * @brief Handles the picking request and updates the hovered element.
+     *
+     * The hovered element is only picked again, if the mouse, the camera or the picked geometry changed since the last
+     * frame (see `last_hover`).
+     */
+    void picking_phase(const mat4& vp);
 
     /**
      * @brief Opens a file selection dialog and loads the selected quadmesh into a tmesh.
      */
     void open_file_dialog_and_load_selected_file();
+
+    /**
+     * @brief Starts recording a trace of the editor or stops it and writes the trace to `TRACE_PATH`, if it's
+     *        recording. Only works, if tsl was compiled with the trace zones (CMake option `TSL_TRACE`).
+     */
+    void toggle_trace();
 };
 
 }
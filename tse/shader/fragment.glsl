@@ -5,14 +5,17 @@ flat in uint picked_forward;
 out vec4 fragment_color;
 
 const float TINT_FACTOR = 0.5f;
+const float HOVER_TINT_FACTOR = 0.25f;
 
 void main()
 {
    vec3 color_calculated = color;
 
-   if (picked_forward != 0u) {
+   if (picked_forward == 1u) {
       color_calculated = color_calculated + (vec3(1) - color_calculated) * TINT_FACTOR;
       // fragment_color = vec4(1, 1, 1, 1.0f);
+   } else if (picked_forward == 2u) {
+      color_calculated = color_calculated + (vec3(1) - color_calculated) * HOVER_TINT_FACTOR;
    }
 
    fragment_color = vec4(color_calculated, 1.0f);
@@ -10,6 +10,7 @@ uniform vec3 camera_pos;
 uniform bool show_reflection_lines;
 
 const float TINT_FACTOR = 0.5f;
+const float HOVER_TINT_FACTOR = 0.25f;
 const float REFLECTION_LINES_DENSITY = 30;
 
 vec3 light_pos = camera_pos + vec3(0, 1, 0);
@@ -36,9 +37,11 @@ void main()
     float angle_light_direction = clamp(dot(inverse_light_direction, normalize(normal)), 0, 1);
     float specular_factor = clamp(dot(inverse_camera_direction, reflected_light_direction), 0, 1);
 
-    if (picked != 0u) {
+    if (picked == 1u) {
         color_calculated = tint(color_calculated, TINT_FACTOR);
         // color_calculated = vec3(1, 1, 1);
+    } else if (picked == 2u) {
+        color_calculated = tint(color_calculated, HOVER_TINT_FACTOR);
     }
 
     // Relfection lines
@@ -1,22 +1,39 @@
+#include <algorithm>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include <tsl/geometry/vector.hpp>
+#include <tsl/geometry/tmesh/handles.hpp>
+#include <tsl/evaluation/surface_bvh.hpp>
+#include <tsl/evaluation/surface_evaluator.hpp>
 #include <tsl/grid.hpp>
+#include <tsl/util/trace.hpp>
 
 #include "tse/rendering/grid.hpp"
 #include "tse/gl_buffer.hpp"
 #include "tse/rendering/picking_map.hpp"
 
 using std::vector;
+using std::lower_bound;
+using std::sort;
+using std::unique;
+using std::distance;
+using std::nullopt;
+using std::optional;
+using std::move;
 
 using glm::cross;
 using glm::normalize;
 using glm::fvec3;
 
 using tsl::regular_grid;
+using tsl::face_handle;
+using tsl::vec3;
+using tsl::surface_bvh;
+using tsl::surface_evaluator;
 
 namespace tse {
 
@@ -134,6 +151,7 @@ gl_buffer add_to_render_buffer(const regular_grid& grid, gl_buffer& buffer, pick
 }
 
 gl_multi_buffer get_multi_render_buffer(const vector<regular_grid>& grids, picking_map& picking_map) {
+    TSL_TRACE_ZONE("build_render_buffer");
     gl_multi_buffer buffer;
 
     for (const auto& grid: grids) {
@@ -146,4 +164,167 @@ gl_multi_buffer get_multi_render_buffer(const vector<regular_grid>& grids, picki
     return buffer;
 }
 
+size_t surface_data::num_vertices(size_t face) const {
+    auto res = static_cast<size_t>(face_res[face]);
+    return (res + 1) * (res + 1);
+}
+
+optional<size_t> surface_data::find_face(face_handle handle) const {
+    // The faces are sorted by their handles
+    auto it = lower_bound(faces.begin(), faces.end(), handle);
+    if (it == faces.end() || *it != handle) {
+        return nullopt;
+    }
+    return static_cast<size_t>(distance(faces.begin(), it));
+}
+
+size_t surface_data::add_face(face_handle handle, uint32_t res) {
+    auto index = faces.size();
+    auto first_vertex = vertices.size();
+    faces.push_back(handle);
+    face_res.push_back(res);
+    first_vertices.push_back(first_vertex);
+
+    vertex_element elem;
+    elem.picking_index = picking_map::FIRST_ID + static_cast<uint32_t>(index);
+    vertices.resize(first_vertex + num_vertices(index), elem);
+    return index;
+}
+
+vector<uint32_t> surface_data::get_resolutions() const {
+    vector<uint32_t> out(face_res);
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+void surface_data::clear() {
+    res = 0;
+    adaptive = false;
+    faces.clear();
+    face_res.clear();
+    first_vertices.clear();
+    vertices.clear();
+    stitches.clear();
+    lods.clear();
+}
+
+void surface_sink::begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) {
+    // The evaluator only creates square grids
+    auto index = surface.add_face(handle, static_cast<uint32_t>(num_points_x - 1));
+    first_vertex = surface.first_vertices[index];
+    this->num_points_x = num_points_x;
+}
+
+void surface_sink::add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) {
+    auto& elem = surface.vertices[first_vertex + y * num_points_x + x];
+    elem.pos = fvec3(pos);
+    elem.normal = fvec3(normal);
+}
+
+void surface_patch_sink::begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) {
+    auto face_index = surface.find_face(handle);
+    if (!face_index || num_points_x * num_points_y != surface.num_vertices(*face_index)) {
+        first_vertex = nullopt;
+        return;
+    }
+
+    first_vertex = surface.first_vertices[*face_index];
+    this->num_points_x = num_points_x;
+    patched.push_back(*face_index);
+}
+
+void surface_patch_sink::add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) {
+    if (!first_vertex) {
+        return;
+    }
+
+    // The picking id of the vertex stays the same
+    auto& elem = surface.vertices[*first_vertex + y * num_points_x + x];
+    elem.pos = fvec3(pos);
+    elem.normal = fvec3(normal);
+}
+
+gl_multi_buffer get_multi_index_buffer(const surface_data& surface) {
+    TSL_TRACE_ZONE("build_index_buffer");
+    gl_multi_buffer buffer;
+
+    // The indices of each resolution start at the offset of the resolution
+    auto resolutions = surface.get_resolutions();
+    vector<GLsizeiptr> offsets;
+    offsets.reserve(resolutions.size());
+    for (auto res: resolutions) {
+        offsets.push_back(static_cast<GLsizeiptr>(buffer.index_buffer.size() * sizeof(GLuint)));
+        auto x = static_cast<GLuint>(res + 1);
+
+        // 2 triangles per field and 3 indices per triangle
+        buffer.index_buffer.reserve(buffer.index_buffer.size() + res * res * 6);
+        for (GLuint i = 0; i < res; ++i) {
+            for (GLuint j = 0; j < res; ++j) {
+
+                const GLuint current_index = j + (i * x);
+
+                buffer.index_buffer.push_back(current_index);
+                buffer.index_buffer.push_back(current_index + x);
+                buffer.index_buffer.push_back(current_index + 1);
+
+                buffer.index_buffer.push_back(current_index + 1);
+                buffer.index_buffer.push_back(current_index + x);
+                buffer.index_buffer.push_back(current_index + x + 1);
+            }
+        }
+    }
+
+    // Faces with the same resolution use the same indices, only their base vertex differs
+    auto num_faces = surface.faces.size();
+    buffer.counts.reserve(num_faces);
+    buffer.indices.reserve(num_faces);
+    buffer.base_vertices.reserve(num_faces);
+    for (size_t i = 0; i < num_faces; ++i) {
+        auto res = surface.face_res[i];
+        auto level = distance(resolutions.begin(), lower_bound(resolutions.begin(), resolutions.end(), res));
+        buffer.counts.push_back(static_cast<GLsizei>(res * res * 6));
+        buffer.indices.push_back(offsets[level]);
+        buffer.base_vertices.push_back(static_cast<GLint>(surface.first_vertices[i]));
+    }
+
+    return buffer;
+}
+
+surface_bvh get_surface_bvh(const surface_evaluator& evaluator, const surface_data& surface) {
+    TSL_TRACE_ZONE("build_surface_bvh");
+    vector<size_t> sizes;
+    sizes.reserve(surface.faces.size());
+    for (auto res: surface.face_res) {
+        sizes.push_back(res + 1);
+    }
+
+    vector<vec3> points;
+    points.reserve(surface.vertices.size());
+    for (const auto& elem: surface.vertices) {
+        points.emplace_back(elem.pos);
+    }
+    return surface_bvh(evaluator, surface.faces, sizes, move(points));
+}
+
+void refit_surface_bvh(
+    surface_bvh& bvh,
+    const surface_evaluator& evaluator,
+    const surface_data& surface,
+    const vector<size_t>& faces
+) {
+    TSL_TRACE_ZONE("refit_surface_bvh");
+    vector<face_handle> handles;
+    handles.reserve(faces.size());
+    vector<vec3> points;
+    for (auto face: faces) {
+        handles.push_back(surface.faces[face]);
+        auto first = surface.first_vertices[face];
+        for (size_t i = first; i < first + surface.num_vertices(face); ++i) {
+            points.emplace_back(surface.vertices[i].pos);
+        }
+    }
+    bvh.refit(evaluator, handles, points);
+}
+
 }
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <tsl/geometry/vector.hpp>
+#include <tsl/geometry/tmesh/handles.hpp>
+#include <tsl/grid.hpp>
+#include <tsl/evaluation/border_stitching.hpp>
+#include <tsl/evaluation/eval_cache.hpp>
+#include <tsl/evaluation/surface_evaluator.hpp>
+#include <tsl/util/trace.hpp>
+
+#include "tse/rendering/lod.hpp"
+#include "tse/rendering/grid.hpp"
+
+using std::max;
+using std::make_pair;
+using std::make_tuple;
+using std::move;
+using std::pair;
+using std::set;
+using std::sort;
+using std::tuple;
+using std::unique;
+using std::vector;
+
+using glm::distance;
+using glm::mix;
+using glm::normalize;
+
+using tsl::border_stitch;
+using tsl::eval_cache_key;
+using tsl::face_handle;
+using tsl::get_border_stitches;
+using tsl::grid_vertex;
+using tsl::regular_grid;
+using tsl::surface_evaluator;
+using tsl::vec3;
+
+namespace tse {
+
+namespace {
+
+/// Min distance to the camera, which is used for faces containing the camera.
+constexpr double MIN_VIEW_DISTANCE = 1e-3;
+
+vertex_element& get_vertex(surface_data& surface, const grid_vertex& v) {
+    auto res = surface.face_res[v.face];
+    return surface.vertices[surface.first_vertices[v.face] + v.y * (res + 1) + v.x];
+}
+
+void apply_stitch(surface_data& surface, const border_stitch& stitch) {
+    auto t = static_cast<float>(stitch.t);
+    auto first = get_vertex(surface, stitch.first);
+    auto second = get_vertex(surface, stitch.second);
+    auto& target = get_vertex(surface, stitch.target);
+    target.pos = mix(first.pos, second.pos, t);
+    target.normal = normalize(mix(first.normal, second.normal, t));
+}
+
+}
+
+face_lod calc_face_lod(const regular_grid& grid) {
+    face_lod out;
+    if (grid.points.empty() || grid.points[0].empty()) {
+        return out;
+    }
+
+    auto nx = grid.num_points_x;
+    auto ny = grid.num_points_y;
+    const auto& p00 = grid.points[0][0];
+    const auto& p10 = grid.points[0][nx - 1];
+    const auto& p01 = grid.points[ny - 1][0];
+    const auto& p11 = grid.points[ny - 1][nx - 1];
+
+    // The flatness is the max distance of the samples to the bilinear patch through the corners
+    vec3 min_corner = p00;
+    vec3 max_corner = p00;
+    for (size_t y = 0; y < ny; ++y) {
+        for (size_t x = 0; x < nx; ++x) {
+            const auto& p = grid.points[y][x];
+            min_corner = glm::min(min_corner, p);
+            max_corner = glm::max(max_corner, p);
+
+            auto u = static_cast<double>(x) / (nx - 1);
+            auto v = static_cast<double>(y) / (ny - 1);
+            auto bilinear = mix(mix(p00, p10, u), mix(p01, p11, u), v);
+            out.flatness = max(out.flatness, distance(p, bilinear));
+        }
+    }
+
+    // The surface between the samples may bulge out of the bounding sphere of the samples by about the flatness
+    out.center = (min_corner + max_corner) * 0.5;
+    for (const auto& row: grid.points) {
+        for (const auto& p: row) {
+            out.radius = max(out.radius, distance(p, out.center));
+        }
+    }
+    out.radius += out.flatness;
+
+    return out;
+}
+
+uint32_t select_face_res(const face_lod& lod, const lod_view& view) {
+    auto dist = max(distance(lod.center, view.camera_pos) - lod.radius, MIN_VIEW_DISTANCE);
+
+    // Halving the size of the fields reduces the distance between the surface and its triangles to a quarter
+    auto error = lod.flatness * view.pixels_per_unit / dist;
+    uint32_t res = 1;
+    while (res * 2 <= view.max_res && error / (res * res) > view.max_error) {
+        res *= 2;
+    }
+    return res;
+}
+
+void update_stitches(const surface_evaluator& evaluator, surface_data& surface) {
+    surface.stitches = get_border_stitches(evaluator, surface.faces, surface.face_res);
+}
+
+void stitch_borders(surface_data& surface) {
+    TSL_TRACE_ZONE("stitch_borders");
+    for (const auto& stitch: surface.stitches) {
+        apply_stitch(surface, stitch);
+    }
+}
+
+vector<size_t> stitch_borders(surface_data& surface, const vector<size_t>& faces) {
+    TSL_TRACE_ZONE("stitch_borders");
+    vector<bool> changed_faces(surface.faces.size(), false);
+    for (auto face: faces) {
+        changed_faces[face] = true;
+    }
+
+    // A stitch has to be applied again, if it reads or writes a changed vertex. Then its target is changed as well.
+    set<tuple<uint32_t, uint32_t, uint32_t>> moved;
+    auto is_changed = [&](const grid_vertex& v) {
+        return changed_faces[v.face] || moved.count(make_tuple(v.face, v.x, v.y)) > 0;
+    };
+    vector<size_t> out(faces);
+    for (const auto& stitch: surface.stitches) {
+        if (is_changed(stitch.target) || is_changed(stitch.first) || is_changed(stitch.second)) {
+            apply_stitch(surface, stitch);
+            moved.emplace(stitch.target.face, stitch.target.x, stitch.target.y);
+            out.push_back(stitch.target.face);
+        }
+    }
+
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+face_grid_cache::face_grid_cache(size_t max_bytes) : grids(max_bytes) {}
+
+const vector<vertex_element>* face_grid_cache::find(face_handle handle, uint32_t res, uint64_t version) {
+    return grids.find(eval_cache_key(handle, res, version));
+}
+
+void face_grid_cache::insert(face_handle handle, uint32_t res, uint64_t version, vector<vertex_element>&& vertices) {
+    auto size = sizeof(vertices) + vertices.size() * sizeof(vertex_element);
+    grids.insert(eval_cache_key(handle, res, version), move(vertices), size);
+}
+
+const face_lod* face_grid_cache::find_lod(face_handle handle, uint64_t version) const {
+    auto it = lods.find(handle);
+    return it == lods.end() || it->second.first != version ? nullptr : &it->second.second;
+}
+
+void face_grid_cache::insert_lod(face_handle handle, uint64_t version, const face_lod& lod) {
+    lods[handle] = make_pair(version, lod);
+}
+
+void face_grid_cache::clear() {
+    grids.clear();
+    lods.clear();
+}
+
+}
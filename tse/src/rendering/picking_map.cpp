@@ -22,6 +22,7 @@ optional<picking_element> picking_map::get_object(uint32_t idx) const {
 void picking_map::clear()
 {
     map.clear();
+    next = FIRST_ID;
 }
 
 bool picking_element::operator<(const picking_element& r) const {
@@ -0,0 +1,44 @@
+#include <limits>
+#include <optional>
+
+#include <tsl/util/trace.hpp>
+
+#include "tse/rendering/ray_picking.hpp"
+
+using std::nullopt;
+using std::numeric_limits;
+
+namespace tse {
+
+optional<ray_pick> pick_control_polygon(const control_polygon_bvh& polygon, const line& ray, double t_max) {
+    TSL_TRACE_ZONE("pick_control_polygon");
+    // Vertices are picked regardless of `t_max`, so they can be selected even if they are hidden
+    if (auto hit = polygon.pick_vertex(ray, VERTEX_PICKING_RADIUS)) {
+        return ray_pick(picking_element(object_type::vertex, hit->handle), hit->point, hit->t);
+    }
+    if (auto hit = polygon.pick_edge(ray, EDGE_PICKING_RADIUS, t_max)) {
+        return ray_pick(picking_element(object_type::edge, hit->handle), hit->point, hit->t);
+    }
+    return nullopt;
+}
+
+optional<ray_pick> pick_element(const surface_bvh* bvh, const control_polygon_bvh* polygon, const line& ray) {
+    TSL_TRACE_ZONE("pick_element");
+    optional<ray_pick> closest;
+    if (bvh != nullptr) {
+        if (auto hit = bvh->intersect(ray)) {
+            closest = ray_pick(picking_element(object_type::face, hit->face), hit->point, hit->t);
+        }
+    }
+
+    if (polygon != nullptr) {
+        auto t_max = closest ? closest->t : numeric_limits<double>::infinity();
+        if (auto hit = pick_control_polygon(*polygon, ray, t_max)) {
+            closest = hit;
+        }
+    }
+
+    return closest;
+}
+
+}
@@ -1,7 +1,11 @@
+#include <optional>
+
 #include <tsl/geometry/tmesh/handles.hpp>
 
 #include "tse/rendering/tmesh.hpp"
 
+using std::nullopt;
+
 using tsl::face_handle;
 using tsl::edge_handle;
 using tsl::vertex_handle;
@@ -9,20 +13,47 @@ using tsl::vertex_handle;
 namespace tse
 {
 
-vector<uint8_t> get_picked_faces_buffer(const vector<regular_grid>& faces, const set<picking_element>& picked) {
+namespace {
+
+/**
+ * @brief Returns the index of the hovered element, if it has the given type, or none otherwise.
+ */
+optional<tsl::index> get_hovered(const optional<picking_element>& hovered, object_type type) {
+    if (!hovered || hovered->type != type) {
+        return nullopt;
+    }
+    return hovered->handle.get_idx();
+}
+
+/**
+ * @brief Returns the value of the given element in a picked buffer.
+ */
+template<typename handle_t>
+uint8_t get_picked_value(const vector<handle_t>& picked, optional<tsl::index> hovered, handle_t handle) {
+    if (find(picked.begin(), picked.end(), handle) != picked.end()) {
+        return PICKED_VALUE;
+    }
+    return hovered == handle.get_idx() ? HOVERED_VALUE : 0;
+}
+
+}
+
+vector<uint8_t> get_picked_faces_buffer(
+    const surface_data& surface,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+) {
     // Filter type faces
     vector<reference_wrapper<const picking_element>> faces_picked;
     copy_if(picked.begin(), picked.end(), back_inserter(faces_picked), [](const picking_element& elem) {
         return elem.type == object_type::face;
     });
 
-    size_t num_vertices = 0;
-    for (const auto& face: faces) {
-        num_vertices += face.num_points_y * face.num_points_x;
-    }
+    auto num_vertices = surface.vertices.size();
+    auto hovered_face = get_hovered(hovered, object_type::face);
 
     // If no faces are selected, return all zero vec
-    if (faces_picked.empty()) {
+    if (faces_picked.empty() && !hovered_face) {
         return vector<uint8_t>(num_vertices, 0);
     }
 
@@ -35,16 +66,19 @@ vector<uint8_t> get_picked_faces_buffer(const vector<regular_grid>& faces, const
     // Get selected faces
     vector<uint8_t> out;
     out.reserve(num_vertices);
-    for (const auto& face: faces) {
-        auto found = find(picked_handles.begin(), picked_handles.end(), face.handle);
-        auto picked_val = static_cast<uint8_t>(found != picked_handles.end());
-        out.insert(out.end(), face.num_points_x * face.num_points_y, picked_val);
+    for (size_t i = 0; i < surface.faces.size(); ++i) {
+        auto picked_val = get_picked_value(picked_handles, hovered_face, surface.faces[i]);
+        out.insert(out.end(), surface.num_vertices(i), picked_val);
     }
 
     return out;
 }
 
-vector<uint8_t> get_picked_edges_buffer(const tmesh& mesh, const set<picking_element>& picked) {
+vector<uint8_t> get_picked_edges_buffer(
+    const tmesh& mesh,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+) {
 
     // Filter type edges
     vector<reference_wrapper<const picking_element>> edges_picked;
@@ -52,8 +86,10 @@ vector<uint8_t> get_picked_edges_buffer(const tmesh& mesh, const set<picking_ele
         return elem.type == object_type::edge;
     });
 
+    auto hovered_edge = get_hovered(hovered, object_type::edge);
+
     // If no edges are selected, return all zero vec
-    if (edges_picked.empty()) {
+    if (edges_picked.empty() && !hovered_edge) {
         return vector<uint8_t>(mesh.num_edges() * 2, 0);
     }
 
@@ -67,8 +103,7 @@ vector<uint8_t> get_picked_edges_buffer(const tmesh& mesh, const set<picking_ele
     vector<uint8_t> out;
     out.reserve(mesh.num_edges() * 2);
     for (const auto& eh: mesh.get_edges()) {
-        auto found = find(picked_handles.begin(), picked_handles.end(), eh);
-        auto picked_val = static_cast<uint8_t>(found != picked_handles.end());
+        auto picked_val = get_picked_value(picked_handles, hovered_edge, eh);
         auto vertices = mesh.get_vertices_of_edge(eh);
         out.insert(out.end(), vertices.size(), picked_val);
     }
@@ -76,15 +111,21 @@ vector<uint8_t> get_picked_edges_buffer(const tmesh& mesh, const set<picking_ele
     return out;
 }
 
-vector<uint8_t> get_picked_vertices_buffer(const tmesh& mesh, const set<picking_element>& picked) {
+vector<uint8_t> get_picked_vertices_buffer(
+    const tmesh& mesh,
+    const set<picking_element>& picked,
+    const optional<picking_element>& hovered
+) {
     // Filter type vertices
     vector<reference_wrapper<const picking_element>> vertices_picked;
     copy_if(picked.begin(), picked.end(), back_inserter(vertices_picked), [](const picking_element& elem) {
         return elem.type == object_type::vertex;
     });
 
+    auto hovered_vertex = get_hovered(hovered, object_type::vertex);
+
     // If no vertices are selected, return all zero vec
-    if (vertices_picked.empty()) {
+    if (vertices_picked.empty() && !hovered_vertex) {
         return vector<uint8_t>(mesh.num_vertices(), 0);
     }
 
@@ -98,9 +139,7 @@ vector<uint8_t> get_picked_vertices_buffer(const tmesh& mesh, const set<picking_
     vector<uint8_t> out;
     out.reserve(mesh.num_vertices());
     for (const auto& vh: mesh.get_vertices()) {
-        auto found = find(picked_handles.begin(), picked_handles.end(), vh);
-        auto picked_val = static_cast<uint8_t>(found != picked_handles.end());
-        out.push_back(picked_val);
+        out.push_back(get_picked_value(picked_handles, hovered_vertex, vh));
     }
 
     return out;
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+
+#include <tsl/evaluation/border_stitching.hpp>
+#include <tsl/util/trace.hpp>
+
+#include "tse/surface_worker.hpp"
+
+using std::unique_lock;
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::nullopt;
+using std::exception;
+using std::max;
+using std::ptrdiff_t;
+
+using tsl::get_min_stitch_res;
+
+namespace tse {
+
+surface_worker::surface_worker() :
+    pending(nullopt),
+    running(false),
+    running_load(false),
+    result(nullopt),
+    stop(false),
+    cancelled(false),
+    worker([this]() { run(); })
+{}
+
+surface_worker::~surface_worker() {
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+        pending = nullopt;
+        cancelled = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+void surface_worker::evaluate(shared_ptr<const surface_evaluator> evaluator, uint32_t res, optional<lod_view> view) {
+    job next;
+    next.evaluator = move(evaluator);
+    next.res = res;
+    next.view = view;
+    submit(move(next));
+}
+
+void surface_worker::load(
+    function<tmesh()> create_mesh,
+    evaluator_config config,
+    uint32_t res,
+    optional<lod_view> view
+) {
+    job next;
+    next.create_mesh = move(create_mesh);
+    next.config = config;
+    next.res = res;
+    next.view = view;
+    submit(move(next));
+}
+
+void surface_worker::submit(job&& next) {
+    {
+        lock_guard<mutex> guard(lock);
+        pending = move(next);
+        result = nullopt;
+        if (running) {
+            cancelled = true;
+        }
+    }
+    changed.notify_all();
+}
+
+void surface_worker::cancel() {
+    unique_lock<mutex> guard(lock);
+    pending = nullopt;
+    result = nullopt;
+    if (running) {
+        cancelled = true;
+    }
+    changed.wait(guard, [this]() { return !running; });
+}
+
+bool surface_worker::is_busy() const {
+    lock_guard<mutex> guard(lock);
+    return running || pending || result;
+}
+
+bool surface_worker::is_loading() const {
+    lock_guard<mutex> guard(lock);
+    return pending ? static_cast<bool>(pending->create_mesh) : running_load;
+}
+
+void surface_worker::recycle(surface_data&& surface) {
+    lock_guard<mutex> guard(lock);
+    if (surface.vertices.capacity() > spare.vertices.capacity()) {
+        spare = move(surface);
+    }
+}
+
+optional<surface_result> surface_worker::take_result() {
+    lock_guard<mutex> guard(lock);
+    if (running || pending) {
+        return nullopt;
+    }
+    auto out = move(result);
+    result = nullopt;
+    return out;
+}
+
+void surface_worker::run() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        changed.wait(guard, [this]() { return stop || pending; });
+        if (stop) {
+            return;
+        }
+
+        auto current = move(*pending);
+        pending = nullopt;
+        running = true;
+        running_load = static_cast<bool>(current.create_mesh);
+        cancelled = false;
+        auto surface = move(spare);
+
+        guard.unlock();
+        auto current_result = process(current, move(surface));
+        // Release the evaluator before the job is marked as finished, so that it can be changed afterwards
+        current = job();
+        guard.lock();
+
+        running = false;
+        running_load = false;
+        if (!cancelled && !pending) {
+            result = move(current_result);
+        } else {
+            spare = move(current_result.surface);
+        }
+        changed.notify_all();
+    }
+}
+
+surface_result surface_worker::process(const job& current, surface_data&& surface) {
+    TSL_TRACE_ZONE("surface_worker_process");
+    surface_result out;
+    out.surface = move(surface);
+    out.surface.clear();
+    out.surface.res = current.res;
+    try {
+        auto evaluator = current.evaluator;
+        if (current.create_mesh) {
+            auto created = make_shared<surface_evaluator>(current.create_mesh(), current.config);
+            out.evaluator = created;
+            evaluator = created;
+        }
+        out.evaluated = evaluator.get();
+
+        if (!cancelled && current.view) {
+            eval_adaptive(*evaluator, *current.view, out.surface);
+        } else if (!cancelled) {
+            eval_uniform(*evaluator, current.res, out.surface);
+        }
+        if (!cancelled) {
+            update_stitches(*evaluator, out.surface);
+            stitch_borders(out.surface);
+        }
+        if (!cancelled) {
+            out.bvh = get_surface_bvh(*evaluator, out.surface);
+        }
+    } catch (const exception& e) {
+        out.evaluator = nullptr;
+        out.surface.clear();
+        out.bvh = surface_bvh();
+        out.error = e.what();
+    }
+    return out;
+}
+
+void surface_worker::eval_uniform(const surface_evaluator& evaluator, uint32_t res, surface_data& surface) {
+    TSL_TRACE_ZONE("eval_uniform");
+    for (const auto& fh: evaluator.get_frozen_tmesh().get_faces()) {
+        if (cancelled) {
+            return;
+        }
+        add_face(evaluator, fh, res, surface);
+    }
+}
+
+void surface_worker::eval_adaptive(const surface_evaluator& evaluator, const lod_view& view, surface_data& surface) {
+    TSL_TRACE_ZONE("eval_adaptive");
+    surface.adaptive = true;
+    for (const auto& fh: evaluator.get_frozen_tmesh().get_faces()) {
+        if (cancelled) {
+            return;
+        }
+
+        auto version = evaluator.get_face_version(fh);
+        auto lod = cache.find_lod(fh, version);
+        if (lod == nullptr) {
+            auto grids = evaluator.eval_faces(LOD_MEASURE_RES, {fh});
+            if (grids.empty()) {
+                // The face can't be evaluated
+                continue;
+            }
+            cache.insert_lod(fh, version, calc_face_lod(grids[0]));
+            lod = cache.find_lod(fh, version);
+        }
+
+        // T-junctions on the sides of the face need a fine enough resolution to be stitched
+        auto res = max(select_face_res(*lod, view), get_min_stitch_res(evaluator, fh, view.max_res));
+        if (add_face(evaluator, fh, res, surface)) {
+            surface.lods.push_back(*lod);
+        }
+    }
+}
+
+bool surface_worker::add_face(
+    const surface_evaluator& evaluator,
+    face_handle handle,
+    uint32_t res,
+    surface_data& surface
+) {
+    auto version = evaluator.get_face_version(handle);
+    auto cached = cache.find(handle, res, version);
+    if (cached != nullptr) {
+        // Only copy the positions and normals, the picking id depends on the index of the face
+        auto face = surface.add_face(handle, res);
+        auto first_vertex = surface.first_vertices[face];
+        for (size_t i = 0; i < cached->size(); ++i) {
+            surface.vertices[first_vertex + i].pos = (*cached)[i].pos;
+            surface.vertices[first_vertex + i].normal = (*cached)[i].normal;
+        }
+        return true;
+    }
+
+    auto num_faces = surface.faces.size();
+    surface_sink sink(surface);
+    evaluator.eval_face(res, handle, sink);
+    if (surface.faces.size() == num_faces) {
+        return false;
+    }
+    auto first = surface.vertices.begin() + static_cast<ptrdiff_t>(surface.first_vertices.back());
+    cache.insert(handle, res, version, vector<vertex_element>(first, surface.vertices.end()));
+    return true;
+}
+
+}
@@ -4,6 +4,8 @@
 #include <functional>
 #include <algorithm>
 #include <iterator>
+#include <cmath>
+#include <optional>
 
 #include <GL/glew.h>
 
@@ -22,6 +24,7 @@
 #include <fmt/format.h>
 
 #include <tsl/util/println.hpp>
+#include <tsl/util/trace.hpp>
 #include <tsl/geometry/tmesh/tmesh.hpp>
 #include <tsl/geometry/line.hpp>
 #include <tsl/geometry/plane.hpp>
@@ -43,6 +46,8 @@ using std::reference_wrapper;
 using std::find;
 using std::copy_if;
 using std::inserter;
+using std::optional;
+using std::nullopt;
 
 using glm::radians;
 using glm::fvec3;
@@ -67,6 +72,12 @@ using tsl::face_handle;
 using tsl::edge_direction;
 using tsl::read_obj_into_tmesh;
 using tsl::vec4;
+using tsl::TRACE_COMPILED;
+using tsl::is_tracing;
+using tsl::clear_trace;
+using tsl::start_trace;
+using tsl::stop_trace;
+using tsl::write_trace;
 
 namespace tse {
 
@@ -83,8 +94,15 @@ window::window(string&& title, uint32_t width, uint32_t height) :
     dialogs(),
     edge_remove_percentage(10.0f),
     surface_resolution(1),
+    adaptive_resolution(false),
+    max_pixel_error(0.5f),
     cube_size(5),
-    evaluator(tmesh_cube(static_cast<size_t>(cube_size))),
+    config(),
+    evaluator(std::make_shared<surface_evaluator>(tmesh_cube(static_cast<size_t>(cube_size)), config)),
+    worker(std::make_unique<surface_worker>()),
+    surface(),
+    surface_outdated(false),
+    surface_index_res(),
     camera()
 {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -136,35 +154,9 @@ window::window(string&& title, uint32_t width, uint32_t height) :
     // get framebuffer size
     glfwGetFramebufferSize(glfw_window.get(), &frame_width, &frame_height);
 
-    // picking
-    glGenFramebuffers(1, &picking_frame);
-    glBindFramebuffer(GL_FRAMEBUFFER, picking_frame);
-
-    glGenTextures(1, &picking_texture);
-    glBindTexture(GL_TEXTURE_2D, picking_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-
-    glGenRenderbuffers(1, &picking_render);
-    glBindRenderbuffer(GL_RENDERBUFFER, picking_render);
-
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, picking_render);
-
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, picking_texture, 0);
-
-    glReadBuffer(GL_NONE);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
     auto vertex_shader = create_shader("shader/vertex.glsl", GL_VERTEX_SHADER);
     auto fragment_shader = create_shader("shader/fragment.glsl", GL_FRAGMENT_SHADER);
 
-    auto vertex_picking_shader = create_shader("shader/picking/vertex.glsl", GL_VERTEX_SHADER);
-    auto vertex_wogeom_picking_shader = create_shader("shader/picking/vertex_without_geometry.glsl", GL_VERTEX_SHADER);
-    auto fragment_picking_shader = create_shader("shader/picking/fragment.glsl", GL_FRAGMENT_SHADER);
-
     auto edge_geometry_shader = create_shader("shader/polygon/geometry.glsl", GL_GEOMETRY_SHADER);
     auto vertex_geometry_shader = create_shader("shader/vertex/geometry.glsl", GL_GEOMETRY_SHADER);
 
@@ -177,41 +169,36 @@ window::window(string&& title, uint32_t width, uint32_t height) :
 
     edge_program = create_program({vertex_shader, fragment_shader, edge_geometry_shader});
     vertex_program = create_program({vertex_shader, fragment_shader, vertex_geometry_shader});
-    edge_picking_program = create_program({vertex_picking_shader, fragment_picking_shader, edge_geometry_shader});
-    vertex_picking_program = create_program({vertex_picking_shader, fragment_picking_shader, vertex_geometry_shader});
     phong_program = create_program({phong_vertex_shader, phong_fragment_shader});
-    surface_picking_program = create_program({vertex_wogeom_picking_shader, fragment_picking_shader});
     normal_program = create_program({normal_vertex_shader, normal_geometry_shader, normal_fragment_shader});
 
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
-    glDeleteShader(vertex_picking_shader);
-    glDeleteShader(fragment_picking_shader);
     glDeleteShader(edge_geometry_shader);
     glDeleteShader(vertex_geometry_shader);
     glDeleteShader(phong_vertex_shader);
     glDeleteShader(phong_fragment_shader);
-    glDeleteShader(vertex_wogeom_picking_shader);
 
     glGenVertexArrays(1, &surface_normal_vertex_array);
-    glGenVertexArrays(1, &surface_picking_vertex_array);
     glGenVertexArrays(1, &surface_vertex_array);
     glGenBuffers(1, &surface_vertex_buffer);
     glGenBuffers(1, &surface_index_buffer);
     glGenBuffers(1, &surface_picked_buffer);
 
     glGenVertexArrays(1, &control_edges_vertex_array);
-    glGenVertexArrays(1, &control_picking_edges_vertex_array);
     glGenBuffers(1, &control_edges_vertex_buffer);
     glGenBuffers(1, &control_edges_index_buffer);
     glGenBuffers(1, &edges_picked_buffer);
 
     glGenVertexArrays(1, &control_vertices_vertex_array);
-    glGenVertexArrays(1, &control_picking_vertices_vertex_array);
     glGenBuffers(1, &control_vertices_vertex_buffer);
     glGenBuffers(1, &control_vertices_index_buffer);
     glGenBuffers(1, &vertices_picked_buffer);
 
+    surface.res = surface_resolution.get();
+    surface_sink sink(surface);
+    evaluator->eval_per_face(surface.res, sink);
+    bvh = get_surface_bvh(*evaluator, surface);
     update_buffer();
 
     glEnable(GL_DEPTH_TEST);
@@ -260,14 +247,19 @@ void window::glfw_key_callback(int key, int scancode, int action, int mods) {
                 case GLFW_KEY_R:
                     camera.reset_position();
                     break;
+                case GLFW_KEY_T:
+                    if ((mods & GLFW_MOD_CONTROL) != 0) {
+                        toggle_trace();
+                    }
+                    break;
                 // TODO: switch to keyboard layout independent version! (use `glfwSetCharCallback`)
                 case GLFW_KEY_RIGHT_BRACKET:
                     surface_resolution.increment();
-                    update_buffer();
+                    request_surface_update();
                     break;
                 case GLFW_KEY_SLASH:
                     surface_resolution.decrement();
-                    update_buffer();
+                    request_surface_update();
                     break;
                 case GLFW_KEY_X:
                     move_direction.x = true;
@@ -339,16 +331,6 @@ void window::glfw_key_callback(int key, int scancode, int action, int mods) {
 void window::glfw_framebuffer_size_callback(int width, int height) {
     frame_width = width;
     frame_height = height;
-
-    update_texture_sizes();
-}
-
-void window::update_texture_sizes() const {
-    glBindTexture(GL_TEXTURE_2D, picking_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, frame_width, frame_height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
-
-    glBindRenderbuffer(GL_RENDERBUFFER, picking_render);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, frame_width, frame_height);
 }
 
 void window::glfw_window_size_callback(int width, int height) {
@@ -391,6 +373,7 @@ void window::glfw_mouse_button_callback(int button, int action, int mods) {
                         auto elem = *request_remove;
                         if (picked_elements.find(elem) != picked_elements.end()) {
                             picked_elements.erase(elem);
+                            last_hover = nullopt;
                             update_picked_buffer();
                         }
                         request_remove = nullopt;
@@ -407,20 +390,23 @@ void window::glfw_mouse_button_callback(int button, int action, int mods) {
 }
 
 void window::render() {
+    TSL_TRACE_ZONE("frame");
+    apply_surface_result();
+    update_lod();
     draw_gui();
 
     glfwMakeContextCurrent(glfw_window.get());
     camera.handle_moving_direction(get_mouse_pos());
 
     // projection
-    auto projection = perspective(radians(45.0f), static_cast<float>(width) / height, 0.1f, 1000.0f);
+    auto projection = perspective(radians(FIELD_OF_VIEW), static_cast<float>(width) / height, 0.1f, 1000.0f);
     auto view = camera.get_view_matrix();
 
     auto model = mat4(1.0f);
     auto vp = projection * view;
 
     // Picking phase
-    picking_phase(model, vp);
+    picking_phase(vp);
     handle_object_move(model, vp);
 
     // Render phase
@@ -442,54 +428,88 @@ void window::render() {
     glfwPollEvents();
 }
 
-void window::picking_phase(const mat4& model, const mat4& vp) {
+void window::picking_phase(const mat4& vp) {
+    TSL_TRACE_ZONE("picking");
     if (request_pick) {
-        auto data = *request_pick;
-        auto id = read_pixel(data.pos);
-        if (id != 0) {
-            if (data.single_select) {
-                picked_elements.clear();
-                picked_elements.insert(*picking_map.get_object(id));
-            } else {
-                auto [it, inserted] = picked_elements.insert(*picking_map.get_object(id));
-                // If element already picked, remove selection
-                if (!inserted) {
-                    request_remove = *it;
-                }
-            }
-            update_picked_buffer();
-            move_object = true;
+        apply_pick(*request_pick, pick(request_pick->pos, vp));
+        request_pick = nullopt;
+    }
+
+    // Moved objects and the camera moved by the mouse are not hovered
+    optional<picking_element> under_mouse;
+    if (!move_object && !camera.moving_direction.mouse && !ImGui::GetIO().WantCaptureMouse) {
+        // The element under the mouse can only change, if the mouse, the camera or the picked geometry changed
+        hover_query query(get_mouse_pos(), vp, is_surface_pickable(), control_mode);
+        if (last_hover && *last_hover == query) {
+            return;
         }
+        last_hover = query;
 
-        request_pick = nullopt;
+        auto picked = pick(query.pos, vp);
+        if (picked && picked_elements.count(picked->element) == 0) {
+            under_mouse = picked->element;
+        }
+    } else {
+        last_hover = nullopt;
     }
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, picking_frame);
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    if (surface_mode) {
-        draw_surface_picking(model, vp);
+    auto changed = static_cast<bool>(under_mouse) != static_cast<bool>(hovered);
+    if (under_mouse && hovered) {
+        changed = under_mouse->type != hovered->type || under_mouse->handle != hovered->handle;
     }
-    if (control_mode) {
-        draw_control_polygon_picking(model, vp);
+    if (changed) {
+        hovered = under_mouse;
+        update_picked_buffer();
+    }
+}
+
+optional<ray_pick> window::pick(const mouse_pos& pos, const mat4& vp) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) {
+        return nullopt;
     }
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-    glViewport(0, 0, frame_width, frame_height);
+
+    line ray(camera.get_pos(), get_ray(pos, vp));
+    return pick_element(is_surface_pickable() ? &bvh : nullptr, control_mode ? &control_bvh : nullptr, ray);
 }
 
-uint32_t window::read_pixel(const mouse_pos& pos) const {
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, picking_frame);
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    uint32_t data = 0;
-    auto x = static_cast<GLint>(pos.x);
-    auto y = static_cast<GLint>(height - pos.y);
-    glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &data);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-    return data;
+bool window::is_surface_pickable() const {
+    // While the surface is updated, `bvh` may belong to an outdated mesh
+    return surface_mode && !worker->is_busy() && !surface_outdated;
+}
+
+void window::apply_pick(const request_pick_data& request, const optional<ray_pick>& picked) {
+    if (!picked) {
+        return;
+    }
+
+    auto pressed = glfwGetMouseButton(glfw_window.get(), GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    if (request.single_select) {
+        picked_elements.clear();
+        picked_elements.insert(picked->element);
+    } else {
+        auto [it, inserted] = picked_elements.insert(picked->element);
+        // If element already picked, remove selection
+        if (!inserted) {
+            if (pressed) {
+                request_remove = *it;
+            } else {
+                picked_elements.erase(it);
+            }
+        }
+    }
+    hovered = nullopt;
+    last_hover = nullopt;
+    update_picked_buffer();
+
+    // The picked point is moved with the mouse, so it stays under the cursor
+    move_object = pressed;
+    if (move_object) {
+        start_move = picked->point;
+    }
 }
 
 void window::draw_gui() {
+    TSL_TRACE_ZONE("draw_gui");
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -523,6 +543,9 @@ void window::draw_gui() {
             if (ImGui::MenuItem("Remove Edges")) {
                 dialogs.remove_edges = !dialogs.remove_edges;
             }
+            if (ImGui::MenuItem("Memory")) {
+                dialogs.memory = !dialogs.memory;
+            }
             ImGui::EndMenu();
         }
         ImGui::EndMenu();
@@ -567,14 +590,30 @@ void window::draw_gui() {
             ImGui::Checkbox("Show surface", &surface_mode);
             ImGui::Checkbox("Show surface normals", &normal_mode);
             ImGui::Checkbox("Show reflection lines", &show_reflection_lines);
-            ImGui::Checkbox("Prevent broken meshes to be imported", &evaluator.config.panic_at_integrity_violations);
+            if (ImGui::Checkbox("Prevent broken meshes to be imported", &config.panic_at_integrity_violations)) {
+                if (!worker->is_loading()) {
+                    edit_evaluator().config = config;
+                    request_surface_update();
+                }
+            }
 
             ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.3f);
             if (ImGui::InputInt("Resolution", (int*) surface_resolution.data(), 1, 1)) {
                 if (surface_resolution.get() < 1) {
                     surface_resolution.set(1);
                 }
-                update_buffer();
+                request_surface_update();
+            }
+            if (ImGui::Checkbox("Adaptive resolution", &adaptive_resolution)) {
+                request_surface_update();
+            }
+            if (adaptive_resolution) {
+                ImGui::SameLine();
+                if (ImGui::InputFloat("Max error (px)", &max_pixel_error, 0.1f, 1.0f, "%.1f")) {
+                    if (max_pixel_error < 0.1f) {
+                        max_pixel_error = 0.1f;
+                    }
+                }
             }
 
             if (ImGui::InputInt("Cube size", &cube_size, 1, 1)) {
@@ -586,8 +625,10 @@ void window::draw_gui() {
             }
             ImGui::SameLine();
             if (ImGui::Button("Load")) {
-                evaluator = surface_evaluator(tmesh_cube(static_cast<size_t>(cube_size)));
-                update_buffer();
+                auto size = static_cast<size_t>(cube_size);
+                request_load([size]() {
+                    return tmesh_cube(size);
+                });
             }
 
             auto& app = application::get_instance();
@@ -599,6 +640,11 @@ void window::draw_gui() {
             } else {
                 ImGui::Text("Rendering: / ms/frame (%.1f FPS, sleeping: / ms)", ImGui::GetIO().Framerate);
             }
+            if (worker->is_loading()) {
+                ImGui::Text("Loading mesh...");
+            } else if (worker->is_busy()) {
+                ImGui::Text("Evaluating surface...");
+            }
 
             ImGui::End();
         }
@@ -616,7 +662,10 @@ void window::draw_gui() {
                 });
 
                 bool continue_after_warn = true;
-                if (edges_picked.empty()) {
+                if (worker->is_loading()) {
+                    pfd::message("Problem", "Wait until the mesh is loaded!", pfd::choice::ok, pfd::icon::warning);
+                    continue_after_warn = false;
+                } else if (edges_picked.empty()) {
                     pfd::message("Problem", "No edges selected!", pfd::choice::ok, pfd::icon::warning);
                 } else {
                     auto button = pfd::message("Warning", format("Are you sure you want to delete: {} edges?", edges_picked.size()), pfd::choice::yes_no, pfd::icon::question).result();
@@ -624,6 +673,9 @@ void window::draw_gui() {
                 }
 
                 if (continue_after_warn) {
+                    // Update the caches only once after all edges are removed
+                    auto& evaluator = edit_evaluator();
+                    evaluator.begin_edits();
                     vector<edge_handle> removed_egdes;
                     for (const auto& edge: edges_picked) {
                         edge_handle handle(edge.get().handle.get_idx());
@@ -633,6 +685,7 @@ void window::draw_gui() {
                             pfd::message("Problem", format("Edge with id: {} could not be deleted!", handle), pfd::choice::ok, pfd::icon::error);
                         }
                     }
+                    evaluator.commit_edits();
 
                     if (!removed_egdes.empty()) {
 
@@ -646,25 +699,25 @@ void window::draw_gui() {
                             return true;
                         });
 
-                        // Update all buffers
-                        update_buffer();
-
-                        // Restore the picked elements and update the picked buffer to make them visible
-                        picked_elements.insert(old_picked.begin(), old_picked.end());
-                        update_picked_buffer();
+                        // Update the control polygon now and the surface in the background
+                        picked_elements = move(old_picked);
+                        update_control_and_picked_buffer();
+                        request_surface_update();
                     }
                 }
             }
             ImGui::Separator();
             ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.3f);
             ImGui::SliderFloat("Percentage of edges to be removed", &edge_remove_percentage, 0.0f, 100.0f, "%.1f %%");
-            if (ImGui::Button("Remove % of edges")) {
+            if (ImGui::Button("Remove % of edges") && !worker->is_loading()) {
                 bool continue_after_warn = true;
                 auto button = pfd::message("Warning", format("Are you sure you want to delete {}% of the edges?", edge_remove_percentage), pfd::choice::yes_no, pfd::icon::question).result();
                 continue_after_warn = button == pfd::button::yes;
                 if (continue_after_warn) {
-                    evaluator.remove_edges(edge_remove_percentage);
-                    update_buffer();
+                    edit_evaluator().remove_edges(edge_remove_percentage);
+                    picked_elements.clear();
+                    update_control_and_picked_buffer();
+                    request_surface_update();
                 }
             }
 
@@ -676,7 +729,7 @@ void window::draw_gui() {
         auto picked_elem_window_width = 200;
         ImGui::SetNextWindowPos(ImVec2(this->width - picked_elem_window_width, 30), ImGuiCond_FirstUseEver);
         ImGui::SetNextWindowSizeConstraints(ImVec2(picked_elem_window_width, 100), ImVec2(width, height));
-        const auto& mesh = evaluator.get_tmesh();
+        const auto& mesh = evaluator->get_tmesh();
 
         auto draw_edge_information = [&] (const half_edge_handle& eh) {
 
@@ -697,10 +750,10 @@ void window::draw_gui() {
                     } else {
                         ImGui::BulletText("points into face corner: %s", *mesh.corner(eh) ? "true" : "false");
                         ImGui::BulletText("knot interval: %.2f", *mesh.get_knot_interval(eh));
-                        const auto& coords = evaluator.get_coord_map()[eh];
+                        const auto& coords = evaluator->get_coord_map()[eh];
                         ImGui::BulletText("local coords (uv) of vertex for current half edge: (%.0f, %.0f)", coords.x, coords.y);
-                        ImGui::BulletText("direction (dir) of vertex for current half edge: %u", evaluator.get_dir_map()[eh]);
-                        auto& trans = evaluator.get_edge_trans_map()[eh];
+                        ImGui::BulletText("direction (dir) of vertex for current half edge: %u", evaluator->get_dir_map()[eh]);
+                        auto& trans = evaluator->get_edge_trans_map()[eh];
                         ImGui::BulletText("transition: scale: %.2f, rotate: %u, translate: (%.2f, %.2f)", trans.f, trans.r, trans.t.x, trans.t.y);
                     }
 
@@ -761,17 +814,18 @@ void window::draw_gui() {
                     case object_type::face: {
                         face_handle fh(elem.handle.get_idx());
                         if (ImGui::TreeNode((void*)(intptr_t) fh.get_idx(), "Face (id: %u)", elem.handle.get_idx())) {
-                            auto max_local_coords = evaluator.get_max_coords(fh);
+                            auto max_local_coords = evaluator->get_max_coords(fh);
                             ImGui::BulletText("local coordinates: (%.2f, %.2f)", max_local_coords.x, max_local_coords.y);
                             ImGui::BulletText("edge: %u", mesh.get_edge(fh).get_idx());
 
                             ImGui::Separator();
 
-                            const auto& support = evaluator.get_support_map()[fh];
+                            const auto& support = evaluator->get_support_map()[fh];
                             if (ImGui::TreeNode((void*) nullptr, "supporting basis functions: (%lu)", support.size())) {
-                                for (const auto& [vh, index, trans]: support) {
+                                for (const auto& entry: support) {
+                                    auto vh = entry.vertex;
                                     if (ImGui::TreeNode((void*)(intptr_t) vh.get_idx(), "vertex: %u", vh.get_idx())) {
-                                        auto [uv, vv] = evaluator.get_knot_vectors()[vh][index];
+                                        const auto& [uv, vv] = evaluator->get_knot_vectors()[vh][entry.handle_index];
                                         if (ImGui::TreeNode("knot vector u")) {
                                             for (const auto& u: uv) {
                                                 ImGui::BulletText("%.2f", u);
@@ -802,6 +856,7 @@ void window::draw_gui() {
             if (!picked_elements.empty()) {
                 if (ImGui::Button("Clear (deselect all)")) {
                     picked_elements.clear();
+                    last_hover = nullopt;
                     update_picked_buffer();
                 }
             }
@@ -810,43 +865,45 @@ void window::draw_gui() {
         }
     }
 
-    ImGui::Render();
-}
-
-void window::draw_control_polygon_picking(const mat4& model, const mat4& vp) const {
-    // Render control polygon
-    glUseProgram(edge_picking_program);
-
-    auto vp_location = glGetUniformLocation(edge_picking_program, "VP");
-    auto m_location = glGetUniformLocation(edge_picking_program, "M");
-    auto camera_location = glGetUniformLocation(edge_picking_program, "camera_pos");
-
-    glUniformMatrix4fv(vp_location, 1, GL_FALSE, value_ptr(vp));
-    glUniformMatrix4fv(m_location, 1, GL_FALSE, value_ptr(model));
-    glUniform3fv(camera_location, 1, value_ptr(camera.get_pos()));
-
-    glBindVertexArray(control_picking_edges_vertex_array);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glDrawElements(GL_LINES, static_cast<GLsizei>(control_edges_buffer.index_buffer.size()), GL_UNSIGNED_INT, (void*) (sizeof(float) * 0));
-
-    // Render vertices
-    glDepthFunc(GL_ALWAYS);
-    glUseProgram(vertex_picking_program);
+    if (dialogs.memory) {
+        ImGui::SetNextWindowPos(ImVec2(0, 30), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSizeConstraints(ImVec2(400, 100), ImVec2(width, height));
+
+        if (ImGui::Begin("Memory", &dialogs.memory)) {
+            auto report = evaluator->memory_report();
+            ImGui::Columns(4);
+            ImGui::Text("structure");
+            ImGui::NextColumn();
+            ImGui::Text("used (KiB)");
+            ImGui::NextColumn();
+            ImGui::Text("deleted (KiB)");
+            ImGui::NextColumn();
+            ImGui::Text("reserved (KiB)");
+            ImGui::NextColumn();
+            ImGui::Separator();
 
-    auto vertex_vp_location = glGetUniformLocation(vertex_picking_program, "VP");
-    auto vertex_m_location = glGetUniformLocation(vertex_picking_program, "M");
-    auto vertex_camera_location = glGetUniformLocation(vertex_picking_program, "camera_pos");
-    auto vertex_camera_up_location = glGetUniformLocation(vertex_picking_program, "camera_up");
+            auto add_row = [](const string& name, const tsl::memory_usage& usage) {
+                ImGui::Text("%s", name.c_str());
+                ImGui::NextColumn();
+                ImGui::Text("%.1f", usage.used_bytes / 1024.0);
+                ImGui::NextColumn();
+                ImGui::Text("%.1f", usage.deleted_bytes / 1024.0);
+                ImGui::NextColumn();
+                ImGui::Text("%.1f", usage.reserved_bytes / 1024.0);
+                ImGui::NextColumn();
+            };
+            for (const auto& [name, usage]: report.get_entries()) {
+                add_row(name, usage);
+            }
+            ImGui::Separator();
+            add_row("total", report.get_total());
+            ImGui::Columns(1);
 
-    glUniformMatrix4fv(vertex_vp_location, 1, GL_FALSE, value_ptr(vp));
-    glUniformMatrix4fv(vertex_m_location, 1, GL_FALSE, value_ptr(model));
-    glUniform3fv(vertex_camera_location, 1, value_ptr(camera.get_pos()));
-    glUniform3fv(vertex_camera_up_location, 1, value_ptr(camera.get_up()));
+            ImGui::End();
+        }
+    }
 
-    glBindVertexArray(control_picking_vertices_vertex_array);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glDrawElements(GL_POINTS, static_cast<GLsizei>(control_vertices_buffer.index_buffer.size()), GL_UNSIGNED_INT, (void*) (sizeof(float) * 0));
-    glDepthFunc(GL_LESS);
+    ImGui::Render();
 }
 
 void window::draw_control_polygon(const mat4& model, const mat4& vp) const {
@@ -910,12 +967,13 @@ void window::draw_surface(const mat4& model, const mat4& vp) const {
     } else {
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
-    glMultiDrawElements(
+    glMultiDrawElementsBaseVertex(
         GL_TRIANGLES,
         surface_buffer.counts.data(),
         GL_UNSIGNED_INT,
         (void**) surface_buffer.indices.data(),
-        static_cast<GLsizei>(surface_buffer.counts.size())
+        static_cast<GLsizei>(surface_buffer.counts.size()),
+        surface_buffer.base_vertices.data()
     );
 }
 
@@ -934,32 +992,13 @@ void window::draw_surface_normals(const mat4& model, const mat4& vp) const {
 
     glBindVertexArray(surface_normal_vertex_array);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glMultiDrawElements(
+    glMultiDrawElementsBaseVertex(
         GL_POINTS,
         surface_buffer.counts.data(),
         GL_UNSIGNED_INT,
         (void**) surface_buffer.indices.data(),
-        static_cast<GLsizei>(surface_buffer.counts.size())
-    );
-}
-
-void window::draw_surface_picking(const mat4& model, const mat4& vp) const {
-    glUseProgram(surface_picking_program);
-
-    auto vp_location_phong = glGetUniformLocation(phong_program, "VP");
-    auto m_location_phong = glGetUniformLocation(phong_program, "M");
-
-    glUniformMatrix4fv(vp_location_phong, 1, GL_FALSE, value_ptr(vp));
-    glUniformMatrix4fv(m_location_phong, 1, GL_FALSE, value_ptr(model));
-
-    glBindVertexArray(surface_picking_vertex_array);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glMultiDrawElements(
-        GL_TRIANGLES,
-        surface_buffer.counts.data(),
-        GL_UNSIGNED_INT,
-        (void**) surface_buffer.indices.data(),
-        static_cast<GLsizei>(surface_buffer.counts.size())
+        static_cast<GLsizei>(surface_buffer.counts.size()),
+        surface_buffer.base_vertices.data()
     );
 }
 
@@ -972,9 +1011,6 @@ window::~window() {
 
         glDeleteVertexArrays(1, &control_edges_vertex_array);
         glDeleteVertexArrays(1, &control_vertices_vertex_array);
-        glDeleteVertexArrays(1, &control_picking_edges_vertex_array);
-        glDeleteVertexArrays(1, &control_picking_vertices_vertex_array);
-        glDeleteVertexArrays(1, &surface_picking_vertex_array);
         glDeleteVertexArrays(1, &surface_normal_vertex_array);
 
         glDeleteBuffers(1, &control_edges_vertex_buffer);
@@ -985,10 +1021,6 @@ window::~window() {
         glDeleteBuffers(1, &edges_picked_buffer);
         glDeleteBuffers(1, &vertices_picked_buffer);
 
-        glDeleteFramebuffers(1, &picking_frame);
-        glDeleteRenderbuffers(1, &picking_render);
-        glDeleteTextures(1, &picking_texture);
-
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -1007,18 +1039,27 @@ mouse_pos window::get_mouse_pos() const {
 }
 
 void window::update_surface_buffer() {
-    tmesh_faces = evaluator.eval_per_face(surface_resolution.get());
-    surface_buffer = get_multi_render_buffer(tmesh_faces, picking_map);
+    TSL_TRACE_ZONE("upload_surface_buffer");
+    // The picking ids were already written by `surface_sink`, so the faces are registered in the same order
+    for (const auto& fh: surface.faces) {
+        picking_map.add_object(object_type::face, fh);
+    }
 
-    auto vec_data = surface_buffer.get_combined_vec_data();
+    // The indices are shared by all faces with the same resolution
+    auto resolutions = surface.get_resolutions();
+    auto index_outdated = surface_index_res != resolutions;
+    surface_buffer = get_multi_index_buffer(surface);
 
     glBindVertexArray(surface_vertex_array);
 
     glBindBuffer(GL_ARRAY_BUFFER, surface_vertex_buffer);
-    glBufferData(GL_ARRAY_BUFFER, vec_data.size() * sizeof(vertex_element), vec_data.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, surface.vertices.size() * sizeof(vertex_element), surface.vertices.data(), GL_DYNAMIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surface_index_buffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, surface_buffer.index_buffer.size() * sizeof(GLuint), surface_buffer.index_buffer.data(), GL_STATIC_DRAW);
+    if (index_outdated) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, surface_buffer.index_buffer.size() * sizeof(GLuint), surface_buffer.index_buffer.data(), GL_STATIC_DRAW);
+        surface_index_res = move(resolutions);
+    }
 
     // pointer binding
     auto vpos_location = static_cast<GLuint>(glGetAttribLocation(phong_program, "pos_in"));
@@ -1029,17 +1070,6 @@ void window::update_surface_buffer() {
     glVertexAttribPointer(vnormal_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, normal));
     glEnableVertexAttribArray(vnormal_location);
 
-    glBindVertexArray(surface_picking_vertex_array);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surface_index_buffer);
-
-    auto surface_picking_vpos_location = static_cast<GLuint>(glGetAttribLocation(surface_picking_program, "pos"));
-    glVertexAttribPointer(surface_picking_vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, pos));
-    glEnableVertexAttribArray(surface_picking_vpos_location);
-
-    auto surface_picking_vpicking_id_location = static_cast<GLuint>(glGetAttribLocation(surface_picking_program, "picking_id_in"));
-    glVertexAttribIPointer(surface_picking_vpicking_id_location, 1, GL_UNSIGNED_INT, sizeof(vertex_element), (void*) offsetof(vertex_element, picking_index));
-    glEnableVertexAttribArray(surface_picking_vpicking_id_location);
-
     glBindVertexArray(surface_normal_vertex_array);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surface_index_buffer);
 
@@ -1053,8 +1083,10 @@ void window::update_surface_buffer() {
 }
 
 void window::update_control_buffer() {
-    control_edges_buffer = get_edges_buffer(evaluator.get_tmesh(), picking_map);
-    control_vertices_buffer = get_vertices_buffer(evaluator.get_tmesh(), picking_map);
+    TSL_TRACE_ZONE("upload_control_buffer");
+    control_edges_buffer = get_edges_buffer(evaluator->get_tmesh(), picking_map);
+    control_vertices_buffer = get_vertices_buffer(evaluator->get_tmesh(), picking_map);
+    control_bvh = control_polygon_bvh(evaluator->get_tmesh());
 
     // control edges polygon
     glBindVertexArray(control_edges_vertex_array);
@@ -1071,17 +1103,6 @@ void window::update_control_buffer() {
     glVertexAttribPointer(control_vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, pos));
     glEnableVertexAttribArray(control_vpos_location);
 
-    glBindVertexArray(control_picking_edges_vertex_array);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, control_edges_index_buffer);
-
-    auto control_picking_vpos_location = static_cast<GLuint>(glGetAttribLocation(edge_picking_program, "pos"));
-    glVertexAttribPointer(control_picking_vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, pos));
-    glEnableVertexAttribArray(control_picking_vpos_location);
-
-    auto control_picking_vpicking_id_location = static_cast<GLuint>(glGetAttribLocation(edge_picking_program, "picking_id_in"));
-    glVertexAttribIPointer(control_picking_vpicking_id_location, 1, GL_UNSIGNED_INT, sizeof(vertex_element), (void*) offsetof(vertex_element, picking_index));
-    glEnableVertexAttribArray(control_picking_vpicking_id_location);
-
     // control vertices polygon
     glBindVertexArray(control_vertices_vertex_array);
 
@@ -1096,23 +1117,13 @@ void window::update_control_buffer() {
     auto control_vertrex_vpos_location = static_cast<GLuint>(glGetAttribLocation(vertex_program, "pos"));
     glVertexAttribPointer(control_vertrex_vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, pos));
     glEnableVertexAttribArray(control_vertrex_vpos_location);
-
-    glBindVertexArray(control_picking_vertices_vertex_array);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, control_vertices_index_buffer);
-
-    auto control_vertrex_picking_vpos_location = static_cast<GLuint>(glGetAttribLocation(vertex_picking_program, "pos"));
-    glVertexAttribPointer(control_vertrex_picking_vpos_location, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_element), (void*) offsetof(vertex_element, pos));
-    glEnableVertexAttribArray(control_vertrex_picking_vpos_location);
-
-    auto control_vertrex_picking_vpicking_id_location = static_cast<GLuint>(glGetAttribLocation(vertex_picking_program, "picking_id_in"));
-    glVertexAttribIPointer(control_vertrex_picking_vpicking_id_location, 1, GL_UNSIGNED_INT, sizeof(vertex_element), (void*) offsetof(vertex_element, picking_index));
-    glEnableVertexAttribArray(control_vertrex_picking_vpicking_id_location);
 }
 
 void window::update_picked_buffer()
 {
+    TSL_TRACE_ZONE("upload_picked_buffer");
     // Edges
-    auto picked_edges = get_picked_edges_buffer(evaluator.get_tmesh(), picked_elements);
+    auto picked_edges = get_picked_edges_buffer(evaluator->get_tmesh(), picked_elements, hovered);
 
     glBindVertexArray(control_edges_vertex_array);
     glBindBuffer(GL_ARRAY_BUFFER, edges_picked_buffer);
@@ -1123,7 +1134,7 @@ void window::update_picked_buffer()
     glEnableVertexAttribArray(picked_edges_location);
 
     // Vertices
-    auto picked_vertices = get_picked_vertices_buffer(evaluator.get_tmesh(), picked_elements);
+    auto picked_vertices = get_picked_vertices_buffer(evaluator->get_tmesh(), picked_elements, hovered);
 
     glBindVertexArray(control_vertices_vertex_array);
     glBindBuffer(GL_ARRAY_BUFFER, vertices_picked_buffer);
@@ -1134,7 +1145,7 @@ void window::update_picked_buffer()
     glEnableVertexAttribArray(picked_vertices_location);
 
     // Faces
-    auto picked_faces = get_picked_faces_buffer(tmesh_faces, picked_elements);
+    auto picked_faces = get_picked_faces_buffer(surface, picked_elements, hovered);
 
     glBindVertexArray(surface_vertex_array);
     glBindBuffer(GL_ARRAY_BUFFER, surface_picked_buffer);
@@ -1150,6 +1161,8 @@ void window::update_buffer()
     // This needs to be cleared because the picking map will be cleared
     // otherwise the old indices stored here are invalid
     picked_elements.clear();
+    hovered = nullopt;
+    last_hover = nullopt;
 
     picking_map.clear();
     update_surface_buffer();
@@ -1157,8 +1170,177 @@ void window::update_buffer()
     update_picked_buffer();
 }
 
+void window::update_control_and_picked_buffer() {
+    // Register the faces in the same order as `update_surface_buffer` to get the same ids
+    picking_map.clear();
+    hovered = nullopt;
+    last_hover = nullopt;
+    for (const auto& fh: surface.faces) {
+        picking_map.add_object(object_type::face, fh);
+    }
+    update_control_buffer();
+    update_picked_buffer();
+}
+
+void window::update_moved_surface(const set<vertex_handle>& moved) {
+    TSL_TRACE_ZONE("update_moved_surface");
+    // Each face keeps its resolution
+    surface_patch_sink sink(surface);
+    for (const auto& fh: evaluator->get_affected_faces(moved)) {
+        auto face_index = surface.find_face(fh);
+        if (!face_index) {
+            continue;
+        }
+        evaluator->eval_face(surface.face_res[*face_index], fh, sink);
+        if (surface.adaptive) {
+            auto grids = evaluator->eval_faces(LOD_MEASURE_RES, {fh});
+            if (!grids.empty()) {
+                surface.lods[*face_index] = calc_face_lod(grids[0]);
+            }
+        }
+    }
+
+    // The patched faces and the faces stitched to them have to be stitched again
+    auto stitched = stitch_borders(surface, sink.patched);
+    refit_surface_bvh(bvh, *evaluator, surface, stitched);
+
+    glBindBuffer(GL_ARRAY_BUFFER, surface_vertex_buffer);
+    for (const auto& face_index: stitched) {
+        auto first_vertex = surface.first_vertices[face_index];
+        auto num_vertices = surface.num_vertices(face_index);
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            static_cast<GLintptr>(first_vertex * sizeof(vertex_element)),
+            static_cast<GLsizeiptr>(num_vertices * sizeof(vertex_element)),
+            surface.vertices.data() + first_vertex
+        );
+    }
+}
+
+void window::update_moved_control_polygon(const set<vertex_handle>& moved) {
+    TSL_TRACE_ZONE("update_moved_control_polygon");
+    const auto& mesh = evaluator->get_tmesh();
+
+    // Replaces the element at the given position in the buffer and uploads it
+    auto patch_element = [](gl_buffer& buffer, GLuint buffer_id, size_t i, const vec3& pos) {
+        buffer.vertex_buffer[i] = fvec3(pos);
+        vertex_element element(buffer.vertex_buffer[i]);
+        element.picking_index = (*buffer.picking_buffer)[i];
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer_id);
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(i * sizeof(vertex_element)), sizeof(vertex_element), &element);
+    };
+
+    // The elements are in the same order as in `get_vertices_buffer` and `get_edges_buffer`
+    size_t i = 0;
+    for (const auto& vh: mesh.get_vertices()) {
+        if (moved.find(vh) != moved.end()) {
+            patch_element(control_vertices_buffer, control_vertices_vertex_buffer, i, mesh.get_vertex_position(vh));
+        }
+        i += 1;
+    }
+
+    i = 0;
+    for (const auto& eh: mesh.get_edges()) {
+        auto vertices = mesh.get_vertices_of_edge(eh);
+        if (moved.find(vertices[0]) != moved.end() || moved.find(vertices[1]) != moved.end()) {
+            patch_element(control_edges_buffer, control_edges_vertex_buffer, i, mesh.get_vertex_position(vertices[0]));
+            patch_element(control_edges_buffer, control_edges_vertex_buffer, i + 1, mesh.get_vertex_position(vertices[1]));
+        }
+        i += 2;
+    }
+
+    // The structure of the mesh didn't change, so the hierarchy is only refitted
+    control_bvh.refit(mesh, moved);
+}
+
+void window::request_surface_update() {
+    if (worker->is_loading()) {
+        // The resolution is checked again, when the new evaluator is applied
+        return;
+    }
+    worker->evaluate(evaluator, surface_resolution.get(), get_lod_view());
+}
+
+void window::request_load(function<tmesh()> create_mesh) {
+    worker->load(move(create_mesh), config, surface_resolution.get(), get_lod_view());
+}
+
+surface_evaluator& window::edit_evaluator() {
+    worker->cancel();
+    return *evaluator;
+}
+
+optional<lod_view> window::get_lod_view() const {
+    if (!adaptive_resolution) {
+        return nullopt;
+    }
+
+    // An object of size 1 in distance 1 covers this many pixels in the perspective projection
+    auto pixels_per_unit = height / (2.0 * std::tan(radians(FIELD_OF_VIEW / 2.0)));
+    return lod_view(vec3(camera.get_pos()), pixels_per_unit, max_pixel_error, surface_resolution.get());
+}
+
+void window::update_lod() {
+    // While the worker is busy, its result will be checked, when it is applied
+    if (!surface.adaptive || surface_outdated || worker->is_busy()) {
+        return;
+    }
+
+    auto view = get_lod_view();
+    if (!view) {
+        return;
+    }
+    for (size_t i = 0; i < surface.faces.size(); ++i) {
+        if (select_face_res(surface.lods[i], *view) != surface.face_res[i]) {
+            request_surface_update();
+            return;
+        }
+    }
+}
+
+void window::apply_surface_result() {
+    TSL_TRACE_ZONE("apply_surface_result");
+    auto result = worker->take_result();
+    if (!result) {
+        return;
+    }
+
+    if (result->error) {
+        // The displayed surface is only outdated, if the current evaluator couldn't be evaluated. After a failed load
+        // it still shows the current evaluator.
+        if (result->evaluated == evaluator.get()) {
+            surface_outdated = true;
+        }
+        pfd::message("Problem", format("An error occurred while updating the surface:\n{}", *result->error), pfd::choice::ok, pfd::icon::error);
+        return;
+    }
+
+    // The old surface is already uploaded, so its memory can be reused for the next evaluation
+    worker->recycle(move(surface));
+    surface = move(result->surface);
+    bvh = move(result->bvh);
+    last_hover = nullopt;
+    surface_outdated = false;
+    if (result->evaluator) {
+        // A new mesh was loaded, so all picked elements are invalid
+        evaluator = move(result->evaluator);
+        update_buffer();
+    } else {
+        // Restore the picked elements after updating, because the structure of the mesh is the same
+        set<picking_element> old_picked(picked_elements);
+        update_buffer();
+        picked_elements = move(old_picked);
+        update_picked_buffer();
+    }
+
+    if (surface.res != surface_resolution.get() || surface.adaptive != adaptive_resolution) {
+        request_surface_update();
+    }
+}
+
 void window::handle_object_move(const mat4& model, const mat4& vp) {
-    if (picked_elements.empty() || !move_object) {
+    if (picked_elements.empty() || !move_object || worker->is_loading()) {
         return;
     }
 
@@ -1172,12 +1354,12 @@ void window::handle_object_move(const mat4& model, const mat4& vp) {
             }
             case object_type::edge: {
                 edge_handle eh(elem.handle.get_idx());
-                evaluator.get_tmesh().get_vertices_of_edge(eh, vertices_to_move);
+                evaluator->get_tmesh().get_vertices_of_edge(eh, vertices_to_move);
                 break;
             }
             case object_type::face: {
                 face_handle fh(elem.handle.get_idx());
-                evaluator.get_tmesh().get_vertices_of_face(fh, vertices_to_move);
+                evaluator->get_tmesh().get_vertices_of_face(fh, vertices_to_move);
                 break;
             }
             default:
@@ -1185,20 +1367,21 @@ void window::handle_object_move(const mat4& model, const mat4& vp) {
         }
     }
 
-    // Calc the support vector of the move plane
-    vector<reference_wrapper<vec3>> positions;
-    positions.reserve(vertices_to_move.size());
-    vec3 center(0, 0, 0);
-    for (const auto& vh: vertices_to_move) {
-        auto& pos = evaluator.get_vertex_pos(vh);
-        positions.emplace_back(pos);
-        center += pos;
+    // Calc the support vector of the move plane. The plane goes through the picked point of the object (see
+    // `apply_pick`), so this point stays under the cursor. Without it, the center of the moved vertices is used.
+    vec3 support(0, 0, 0);
+    if (start_move) {
+        support = *start_move;
+    } else {
+        for (const auto& vh: vertices_to_move) {
+            support += evaluator->get_vertex_pos(vh);
+        }
+        support /= vertices_to_move.size();
     }
-    center /= positions.size();
 
     // Create plane and ray
     line ray(camera.get_pos(), get_ray(get_mouse_pos(), vp));
-    plane move_plane(center, camera.get_direction());
+    plane move_plane(support, camera.get_direction());
 
     // Cast ray and move all points by the offset between the last intersection and the current
     auto intersection = *(ray.intersect(move_plane));
@@ -1216,27 +1399,30 @@ void window::handle_object_move(const mat4& model, const mat4& vp) {
             offset *= vec3(0, 0, 1);
         }
 
-        // If we actually moved, delete the request to deselect the clicked element
+        // If we actually moved, delete the request to deselect the clicked element and move the points. Frames
+        // without movement don't need any update.
         if (length(offset) > 0) {
             request_remove = nullopt;
-        }
 
-        // Actually move points
-        for (const auto& pos: positions) {
-            pos.get() -= offset;
+            // If the worker is busy, the displayed surface will be replaced anyway and can't be patched
+            auto patch_buffers = !worker->is_busy() && !surface_outdated;
+
+            auto& moved_evaluator = edit_evaluator();
+            for (const auto& vh: vertices_to_move) {
+                moved_evaluator.set_vertex_pos(vh, moved_evaluator.get_vertex_pos(vh) - offset);
+            }
+
+            if (patch_buffers) {
+                update_moved_surface(vertices_to_move);
+                update_moved_control_polygon(vertices_to_move);
+            } else {
+                // Update the control polygon now and the surface in the background
+                update_control_and_picked_buffer();
+                request_surface_update();
+            }
         }
         start_move = intersection;
     }
-
-    // Save picked elements
-    set<picking_element> old_picked(picked_elements);
-
-    // Update all buffers
-    update_buffer();
-
-    // Restore the picked elements and update the picked buffer to make them visible
-    picked_elements.insert(old_picked.begin(), old_picked.end());
-    update_picked_buffer();
 }
 
 vec3 window::get_ray(const mouse_pos& mouse_pos, const mat4& vp) const {
@@ -1253,12 +1439,33 @@ vec3 window::get_ray(const mouse_pos& mouse_pos, const mat4& vp) const {
 void window::open_file_dialog_and_load_selected_file() {
     auto files = pfd::open_file("Select a file").result();
     if (!files.empty()) {
-        try {
-            evaluator = surface_evaluator(read_obj_into_tmesh(files[0]));
-            update_buffer();
-        } catch(const exception& e) {
-            pfd::message("Problem", format("An error occurred while loading: {}\n{}", files[0], e.what()), pfd::choice::ok, pfd::icon::error);
-        }
+        auto path = files[0];
+        request_load([path]() {
+            auto mesh = read_obj_into_tmesh(path);
+            mesh.reorder();
+            return mesh;
+        });
+    }
+}
+
+void window::toggle_trace() {
+    if (!TRACE_COMPILED) {
+        println("INFO: tracing is not available, tsl has to be compiled with TSL_TRACE");
+        return;
+    }
+
+    if (!is_tracing()) {
+        clear_trace();
+        start_trace();
+        println("INFO: started trace");
+        return;
+    }
+
+    stop_trace();
+    if (write_trace(TRACE_PATH)) {
+        println("INFO: wrote trace to {}", TRACE_PATH);
+    } else {
+        println("ERROR: could not write trace to {}", TRACE_PATH);
     }
 }
 
@@ -0,0 +1,72 @@
+#ifndef TSL_BENCHMARK_BENCHMARKS_HPP
+#define TSL_BENCHMARK_BENCHMARKS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "tsl/geometry/tmesh/tmesh.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl_benchmark/harness.hpp"
+
+using std::optional;
+using std::string;
+using std::vector;
+
+namespace tsl_benchmark {
+
+/**
+ * @brief A mesh, on which the benchmarks are run.
+ */
+struct bench_input {
+    /// Name of the input, which is used in the names of the benchmarks.
+    string name;
+    tsl::tmesh mesh;
+    /// The obj file the mesh was loaded from or none, if it was generated.
+    optional<string> path;
+
+    bench_input(const string& name, tsl::tmesh&& mesh, optional<string> path)
+        : name(name), mesh(std::move(mesh)), path(std::move(path)) {}
+};
+
+/**
+ * @brief POD type to hold the parameters, which are varied to measure scaling.
+ */
+struct bench_params {
+    /// Resolutions the surfaces are evaluated with.
+    vector<uint32_t> resolutions;
+    /// Max numbers of threads used by parallel stages.
+    vector<size_t> thread_counts;
+};
+
+/**
+ * @brief Returns the faces of the given evaluator, which can be evaluated and are evaluated by subdevision (or with
+ *        b-splines, if `subdevision` is false).
+ */
+vector<tsl::face_handle> get_faces_by_kind(const tsl::surface_evaluator& evaluator, bool subdevision);
+
+/**
+ * @brief Runs the benchmarks for loading the input, traversing its tmesh and removing edges.
+ */
+void run_tmesh_benchmarks(bench_runner& runner, const bench_input& input, const bench_params& params);
+
+/**
+ * @brief Runs the benchmarks for the attribute maps.
+ */
+void run_attrmap_benchmarks(bench_runner& runner);
+
+/**
+ * @brief Runs the benchmarks for the b-spline and subdevision kernels.
+ */
+void run_kernel_benchmarks(bench_runner& runner);
+
+/**
+ * @brief Runs the benchmarks for each stage of building the caches of the evaluator, for evaluating single points and
+ *        the whole surface of the input per kind of face and for tessellating it.
+ */
+void run_evaluation_benchmarks(bench_runner& runner, const bench_input& input, const bench_params& params);
+
+}
+
+#endif //TSL_BENCHMARK_BENCHMARKS_HPP
@@ -0,0 +1,178 @@
+#ifndef TSL_BENCHMARK_HARNESS_HPP
+#define TSL_BENCHMARK_HARNESS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tsl/util/stage_observer.hpp"
+#include "tsl_benchmark/perf_counters.hpp"
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace tsl_benchmark {
+
+using bench_clock = std::chrono::steady_clock;
+
+/**
+ * @brief POD type to hold the configuration of a benchmark run.
+ */
+struct bench_config {
+    /// Number of runs of each benchmark before measuring.
+    size_t warmup;
+    /// Number of measured runs of each benchmark.
+    size_t repetitions;
+    /// Only benchmarks, whose name contains one of these strings, are run. All benchmarks are run, if this is empty.
+    vector<string> filters;
+    /// Collect hardware performance counters for each run (see `perf_counters`).
+    bool counters;
+
+    bench_config() : warmup(2), repetitions(10), counters(false) {}
+};
+
+/**
+ * @brief The measured durations of one benchmark.
+ */
+struct bench_result {
+    /// Name of the benchmark in the form "group/input/variant".
+    string name;
+    /// Number of items (e.g. evaluated points) processed per run or 0, if the benchmark has no items.
+    size_t items;
+    /// Number of runs before measuring.
+    size_t warmup;
+    /// Duration of each measured run in nanoseconds.
+    vector<double> samples;
+    /// Value of each counter (hardware counters and heap allocations) for each measured run by the name of the
+    /// counter. Empty, if no counters were collected.
+    map<string, vector<double>> counters;
+
+    bench_result(const string& name, size_t items, size_t warmup) : name(name), items(items), warmup(warmup) {}
+
+    double median() const;
+    /// 95th percentile (nearest rank) of the durations.
+    double p95() const;
+    double min() const;
+    double mean() const;
+
+    /**
+     * @brief Returns the median of the given counter over all measured runs or 0, if it was not collected.
+     */
+    double counter_median(const string& counter) const;
+
+    /**
+     * @brief Returns the instructions per cycle of the median run or 0, if the counters were not collected.
+     */
+    double ipc() const;
+};
+
+class bench_runner;
+
+/**
+ * @brief Measures the durations of the stages reported to it (see `tsl::stage_observer`).
+ */
+class stage_timer : public tsl::stage_observer {
+public:
+    /**
+     * @brief Creates a timer, which also collects the counters of the given runner for each stage, if it's not null.
+     */
+    explicit stage_timer(const bench_runner* runner = nullptr);
+
+    void begin_stage(const char* name) override;
+    void end_stage(const char* name) override;
+
+    /// Duration of each stage in nanoseconds in the order the stages ended. Repeated stages are summed up.
+    vector<std::pair<string, double>> durations;
+    /// Values of the counters of each stage in the same order as `durations`. Empty, if no counters are collected.
+    vector<vector<double>> counter_values;
+
+private:
+    const bench_runner* runner;
+    bench_clock::time_point start;
+    vector<double> start_counters;
+    vector<double> end_counters;
+};
+
+/**
+ * @brief Runs benchmarks with warmup and repetitions and collects their results.
+ */
+class bench_runner {
+public:
+    explicit bench_runner(const bench_config& config);
+
+    /**
+     * @brief Returns true, if the benchmark with the given name passes the filters of the config.
+     */
+    bool is_enabled(const string& name) const;
+
+    /**
+     * @brief Runs `fn` `warmup + repetitions` times and measures the duration of each run.
+     *
+     * @param items Number of items processed by each run of `fn`.
+     */
+    template<typename func_t>
+    void run(const string& name, size_t items, const func_t& fn);
+
+    /**
+     * @brief Like `run`, but `fn` is called with a `stage_timer` and the duration of each stage reported to it is
+     *        recorded as its own benchmark "name/stage". The sum of all stages is recorded as "name/total". Work
+     *        outside of the stages (e.g. preparing the input of a run) is not measured.
+     */
+    template<typename func_t>
+    void run_stages(const string& name, const func_t& fn);
+
+    /**
+     * @brief Returns the results of all benchmarks, which were run so far.
+     */
+    const vector<bench_result>& get_results() const { return results; }
+
+    /**
+     * @brief Prints the results as a table.
+     */
+    void print_results() const;
+
+    /**
+     * @brief Returns the results and the context of the run (e.g. the number of hardware threads) as JSON.
+     */
+    string to_json() const;
+
+    /**
+     * @brief Returns the names of the counters collected for each run: the hardware counters, if they are enabled
+     *        and available, and "allocs" and "alloc_bytes", if the heap allocations are counted (see
+     *        `tsl::is_alloc_tracking_enabled`).
+     */
+    const vector<string>& get_counter_names() const { return counter_names; }
+
+    /**
+     * @brief Writes the current values of the counters in the order of `get_counter_names` to `out`, which has to
+     *        have the same size. Doesn't allocate, so allocations around it are attributed correctly.
+     */
+    void read_counters(vector<double>& out) const;
+
+private:
+    bench_config config;
+    vector<bench_result> results;
+    /// The hardware counters or null, if they are disabled or not available.
+    std::unique_ptr<perf_counters> counters;
+    vector<string> counter_names;
+
+    /**
+     * @brief Adds the difference of the given counter values as a sample to the given result.
+     */
+    void add_counters(bench_result& result, const vector<double>& before, const vector<double>& after) const;
+};
+
+/**
+ * @brief Prevents the compiler from removing the computation of the given value.
+ */
+void do_not_optimize(double value);
+
+}
+
+#include "tsl_benchmark/harness.tcc"
+
+#endif //TSL_BENCHMARK_HARNESS_HPP
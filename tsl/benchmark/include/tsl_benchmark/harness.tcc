@@ -0,0 +1,81 @@
+#include <chrono>
+
+#include "tsl/util/panic.hpp"
+#include "tsl/util/println.hpp"
+
+namespace tsl_benchmark {
+
+template<typename func_t>
+void bench_runner::run(const string& name, size_t items, const func_t& fn) {
+    if (!is_enabled(name)) {
+        return;
+    }
+
+    tsl::println("running {}", name);
+    bench_result result(name, items, config.warmup);
+    vector<double> before(counter_names.size());
+    vector<double> after(counter_names.size());
+    for (size_t i = 0; i < config.warmup; ++i) {
+        fn();
+    }
+    for (size_t i = 0; i < config.repetitions; ++i) {
+        read_counters(before);
+        auto t1 = bench_clock::now();
+        fn();
+        auto t2 = bench_clock::now();
+        read_counters(after);
+        add_counters(result, before, after);
+        result.samples.push_back(std::chrono::duration<double, std::nano>(t2 - t1).count());
+    }
+    results.push_back(result);
+}
+
+template<typename func_t>
+void bench_runner::run_stages(const string& name, const func_t& fn) {
+    if (!is_enabled(name)) {
+        return;
+    }
+
+    tsl::println("running {}", name);
+    for (size_t i = 0; i < config.warmup; ++i) {
+        stage_timer timer(this);
+        fn(timer);
+    }
+
+    // The stages are only known after the first run
+    auto first = results.size();
+    for (size_t i = 0; i < config.repetitions; ++i) {
+        stage_timer timer(this);
+        fn(timer);
+        if (i > 0 && results.size() - first != timer.durations.size() + 1) {
+            tsl::panic("the stages of benchmark " + name + " changed between runs");
+        }
+
+        double total = 0;
+        vector<double> total_counters(counter_names.size(), 0.0);
+        vector<double> no_counters(total_counters.size(), 0.0);
+        for (size_t j = 0; j < timer.durations.size(); ++j) {
+            const auto& [stage, duration] = timer.durations[j];
+            if (i == 0) {
+                results.emplace_back(name + "/" + stage, 0, config.warmup);
+            }
+            results[first + j].samples.push_back(duration);
+            total += duration;
+            if (!counter_names.empty()) {
+                add_counters(results[first + j], no_counters, timer.counter_values[j]);
+                for (size_t k = 0; k < total_counters.size(); ++k) {
+                    total_counters[k] += timer.counter_values[j][k];
+                }
+            }
+        }
+        if (i == 0) {
+            results.emplace_back(name + "/total", 0, config.warmup);
+        }
+        results[first + timer.durations.size()].samples.push_back(total);
+        if (!counter_names.empty()) {
+            add_counters(results[first + timer.durations.size()], no_counters, total_counters);
+        }
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef TSL_BENCHMARK_PERF_COUNTERS_HPP
+#define TSL_BENCHMARK_PERF_COUNTERS_HPP
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace tsl_benchmark {
+
+/**
+ * @brief Hardware performance counters (cycles, instructions, L1 data cache, last level cache and branch misses) of
+ *        the calling thread and all threads it spawns after the counters were opened.
+ *
+ * The counters are opened with `perf_event_open` and are only available on Linux. Counters the kernel refuses to
+ * open (e.g. because of `/proc/sys/kernel/perf_event_paranoid` or in a virtual machine without a PMU) are skipped.
+ * If the kernel has to multiplex the counters, their values are scaled by the fraction of time they were running.
+ */
+class perf_counters {
+public:
+    /**
+     * @brief Opens and starts all counters, which are available.
+     */
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    /**
+     * @brief Returns true, if at least one counter could be opened.
+     */
+    bool is_available() const { return !fds.empty(); }
+
+    /**
+     * @brief Returns the names of the counters, which could be opened, in the order `read` returns their values.
+     */
+    const vector<string>& get_names() const { return names; }
+
+    /**
+     * @brief Writes the current value of each available counter to `out`, which has to hold `get_names().size()`
+     *        values. Doesn't allocate, so it can be used to measure allocations, too.
+     */
+    void read(double* out) const;
+
+    /**
+     * @brief Returns the reason, why no counter could be opened, or an empty string, if they are available.
+     */
+    const string& get_error() const { return error; }
+
+private:
+    vector<int> fds;
+    vector<string> names;
+    string error;
+};
+
+}
+
+#endif //TSL_BENCHMARK_PERF_COUNTERS_HPP
@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "tsl/attrmaps/attr_maps.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl_benchmark/benchmarks.hpp"
+
+using std::vector;
+
+using namespace tsl;
+
+namespace tsl_benchmark {
+
+namespace {
+
+/// Number of keys used in the attribute map benchmarks.
+constexpr tsl::index NUM_KEYS = 100000;
+
+/// Number of values per key in the csr map benchmarks.
+constexpr tsl::index VALUES_PER_KEY = 4;
+
+/**
+ * @brief Runs the insert and lookup benchmarks for the given kind of attribute map.
+ */
+template<typename map_t>
+void run_map_benchmarks(bench_runner& runner, const string& name) {
+    runner.run("attrmap/" + name + "/insert", NUM_KEYS, [&]() {
+        map_t map;
+        for (tsl::index i = 0; i < NUM_KEYS; ++i) {
+            map.insert(vertex_handle(i), i);
+        }
+        do_not_optimize(map.num_values());
+    });
+
+    map_t map;
+    for (tsl::index i = 0; i < NUM_KEYS; ++i) {
+        map.insert(vertex_handle(i), i);
+    }
+    runner.run("attrmap/" + name + "/lookup", NUM_KEYS, [&]() {
+        double sum = 0;
+        for (tsl::index i = 0; i < NUM_KEYS; ++i) {
+            sum += map[vertex_handle(i)];
+        }
+        do_not_optimize(sum);
+    });
+}
+
+}
+
+void run_attrmap_benchmarks(bench_runner& runner) {
+    run_map_benchmarks<dense_vertex_map<double>>(runner, "dense");
+    run_map_benchmarks<sparse_vertex_map<double>>(runner, "sparse");
+
+    vector<tsl::index> counts(NUM_KEYS, VALUES_PER_KEY);
+    runner.run("attrmap/csr/build", NUM_KEYS * VALUES_PER_KEY, [&]() {
+        csr_vertex_map<double> map;
+        map.build(counts, 0.0);
+        do_not_optimize(map.num_values());
+    });
+
+    csr_vertex_map<double> map;
+    map.build(counts, 1.0);
+    runner.run("attrmap/csr/lookup", NUM_KEYS * VALUES_PER_KEY, [&]() {
+        double sum = 0;
+        for (tsl::index i = 0; i < NUM_KEYS; ++i) {
+            for (auto value: map[vertex_handle(i)]) {
+                sum += value;
+            }
+        }
+        do_not_optimize(sum);
+    });
+}
+
+}
@@ -0,0 +1,137 @@
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/evaluation/eval_sink.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/evaluation/tessellation.hpp"
+#include "tsl_benchmark/benchmarks.hpp"
+
+using std::move;
+using std::vector;
+
+using fmt::format;
+
+using namespace tsl;
+
+namespace tsl_benchmark {
+
+namespace {
+
+/// Number of points evaluated per run in each direction by the single point benchmarks.
+constexpr uint32_t POINTS_PER_DIRECTION = 100;
+
+/**
+ * @brief Discards all evaluated points, so only the evaluation itself is measured.
+ */
+class discard_sink : public eval_sink {
+public:
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override {}
+
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override {
+        sum += pos.x + normal.x;
+    }
+
+    double sum = 0;
+};
+
+}
+
+vector<face_handle> get_faces_by_kind(const surface_evaluator& evaluator, bool subdevision) {
+    const auto& mesh = evaluator.get_tmesh();
+    vector<face_handle> out;
+    vector<vertex_handle> vertices;
+    for (const auto& fh: mesh.get_faces()) {
+        // Faces with extraordinary vertices are evaluated by subdevision (see `surface_evaluator::eval_face`)
+        vertices.clear();
+        mesh.get_vertices_of_face(fh, vertices);
+        auto extraordinary = false;
+        for (const auto& vh: vertices) {
+            extraordinary |= mesh.is_extraordinary(vh);
+        }
+
+        vertices.clear();
+        evaluator.get_control_vertices(fh, vertices);
+        if (extraordinary == subdevision && !vertices.empty()) {
+            out.push_back(fh);
+        }
+    }
+    return out;
+}
+
+void run_evaluation_benchmarks(bench_runner& runner, const bench_input& input, const bench_params& params) {
+    for (auto num_threads: params.thread_counts) {
+        runner.run_stages(format("build/{}/t{}", input.name, num_threads), [&](stage_timer& timer) {
+            auto mesh = input.mesh;
+            evaluator_config config;
+            config.num_threads = num_threads;
+            config.observer = &timer;
+            surface_evaluator evaluator(move(mesh), config);
+        });
+    }
+
+    auto mesh = input.mesh;
+    surface_evaluator evaluator(move(mesh));
+    auto bspline_faces = get_faces_by_kind(evaluator, false);
+    auto subd_faces = get_faces_by_kind(evaluator, true);
+    auto num_faces = evaluator.get_tmesh().num_faces();
+
+    auto eval_points = [&](const char* kind, const vector<face_handle>& faces) {
+        if (faces.empty()) {
+            return;
+        }
+        auto handle = faces.front();
+        auto name = format("eval/{}/{}_point", input.name, kind);
+        runner.run(name, POINTS_PER_DIRECTION * POINTS_PER_DIRECTION, [&]() {
+            double sum = 0;
+            for (uint32_t y = 0; y < POINTS_PER_DIRECTION; ++y) {
+                for (uint32_t x = 0; x < POINTS_PER_DIRECTION; ++x) {
+                    vec2 uv((x + 0.5) / POINTS_PER_DIRECTION, (y + 0.5) / POINTS_PER_DIRECTION);
+                    sum += evaluator.eval_point(handle, uv)[0].x;
+                }
+            }
+            do_not_optimize(sum);
+        });
+    };
+    eval_points("bspline", bspline_faces);
+    eval_points("subd", subd_faces);
+
+    for (auto res: params.resolutions) {
+        auto points_per_face = static_cast<size_t>(res + 1) * (res + 1);
+        auto eval_kind = [&](const char* kind, const vector<face_handle>& faces) {
+            if (faces.empty()) {
+                return;
+            }
+            runner.run(format("eval/{}/{}/r{}", input.name, kind, res), faces.size() * points_per_face, [&]() {
+                discard_sink sink;
+                evaluator.eval_faces(res, faces, sink);
+                do_not_optimize(sink.sum);
+            });
+        };
+        eval_kind("bspline", bspline_faces);
+        eval_kind("subd", subd_faces);
+
+        runner.run(format("eval/{}/per_face/r{}", input.name, res), num_faces * points_per_face, [&]() {
+            auto grids = evaluator.eval_per_face(res);
+            do_not_optimize(grids.size());
+        });
+
+        for (auto num_threads: params.thread_counts) {
+            auto name = format("tessellate/{}/uniform/r{}/t{}", input.name, res, num_threads);
+            runner.run(name, num_faces * points_per_face, [&]() {
+                auto tessellation = tessellate_uniform(evaluator, res, num_threads);
+                do_not_optimize(tessellation.num_triangles());
+            });
+        }
+    }
+
+    for (auto num_threads: params.thread_counts) {
+        runner.run(format("tessellate/{}/adaptive/t{}", input.name, num_threads), 0, [&]() {
+            auto tessellation = tessellate_adaptive(evaluator, tessellation_config(), num_threads);
+            do_not_optimize(tessellation.num_triangles());
+        });
+    }
+}
+
+}
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/util/alloc_stats.hpp"
+#include "tsl/util/println.hpp"
+#include "tsl_benchmark/harness.hpp"
+
+using std::accumulate;
+using std::any_of;
+using std::find_if;
+using std::make_pair;
+using std::sort;
+using std::string;
+using std::thread;
+using std::vector;
+
+using fmt::format;
+
+using tsl::println;
+
+namespace tsl_benchmark {
+
+namespace {
+
+vector<double> sorted(const vector<double>& samples) {
+    vector<double> out(samples);
+    sort(out.begin(), out.end());
+    return out;
+}
+
+/**
+ * @brief Formats the given duration in nanoseconds with a fitting unit.
+ */
+string duration_to_str(double ns) {
+    if (ns < 1e3) {
+        return format("{:.0f}ns", ns);
+    } else if (ns < 1e6) {
+        return format("{:.2f}μs", ns / 1e3);
+    } else if (ns < 1e9) {
+        return format("{:.2f}ms", ns / 1e6);
+    }
+    return format("{:.2f}s", ns / 1e9);
+}
+
+/**
+ * @brief Escapes the given string to be used as JSON string.
+ */
+string escape_json(const string& str) {
+    string out;
+    for (auto c: str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+}
+
+double bench_result::median() const {
+    if (samples.empty()) {
+        return 0;
+    }
+    auto values = sorted(samples);
+    auto mid = values.size() / 2;
+    return values.size() % 2 == 1 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+double bench_result::p95() const {
+    if (samples.empty()) {
+        return 0;
+    }
+    auto values = sorted(samples);
+    auto rank = static_cast<size_t>(std::ceil(0.95 * values.size()));
+    return values[std::max<size_t>(rank, 1) - 1];
+}
+
+double bench_result::min() const {
+    return samples.empty() ? 0 : *std::min_element(samples.begin(), samples.end());
+}
+
+double bench_result::mean() const {
+    return samples.empty() ? 0 : accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+}
+
+double bench_result::counter_median(const string& counter) const {
+    auto it = counters.find(counter);
+    if (it == counters.end() || it->second.empty()) {
+        return 0;
+    }
+    auto values = sorted(it->second);
+    auto mid = values.size() / 2;
+    return values.size() % 2 == 1 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+double bench_result::ipc() const {
+    auto cycles = counter_median("cycles");
+    return cycles > 0 ? counter_median("instructions") / cycles : 0;
+}
+
+stage_timer::stage_timer(const bench_runner* runner) : runner(runner) {
+    if (runner != nullptr) {
+        start_counters.resize(runner->get_counter_names().size());
+        end_counters.resize(runner->get_counter_names().size());
+    }
+}
+
+void stage_timer::begin_stage(const char* name) {
+    if (runner != nullptr) {
+        runner->read_counters(start_counters);
+    }
+    start = bench_clock::now();
+}
+
+void stage_timer::end_stage(const char* name) {
+    auto duration = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+    if (runner != nullptr) {
+        runner->read_counters(end_counters);
+    }
+    vector<double> values(end_counters.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = end_counters[i] - start_counters[i];
+    }
+
+    auto it = find_if(durations.begin(), durations.end(), [&](const auto& entry) { return entry.first == name; });
+    if (it != durations.end()) {
+        it->second += duration;
+        auto& stage_values = counter_values[it - durations.begin()];
+        for (size_t i = 0; i < values.size(); ++i) {
+            stage_values[i] += values[i];
+        }
+    } else {
+        durations.push_back(make_pair(string(name), duration));
+        counter_values.push_back(values);
+    }
+}
+
+bench_runner::bench_runner(const bench_config& config) : config(config) {
+    if (config.counters) {
+        counters = std::make_unique<perf_counters>();
+        if (counters->is_available()) {
+            counter_names = counters->get_names();
+        } else {
+            println("hardware counters are not available ({}), only measuring durations", counters->get_error());
+            counters.reset();
+        }
+    }
+
+    if (tsl::is_alloc_tracking_enabled()) {
+        counter_names.emplace_back("allocs");
+        counter_names.emplace_back("alloc_bytes");
+    }
+}
+
+void bench_runner::read_counters(vector<double>& out) const {
+    size_t next = 0;
+    if (counters) {
+        counters->read(out.data());
+        next = counters->get_names().size();
+    }
+    if (tsl::is_alloc_tracking_enabled()) {
+        auto stats = tsl::get_alloc_stats();
+        out[next] = static_cast<double>(stats.count);
+        out[next + 1] = static_cast<double>(stats.bytes);
+    }
+}
+
+void bench_runner::add_counters(bench_result& result, const vector<double>& before, const vector<double>& after) const {
+    for (size_t i = 0; i < counter_names.size(); ++i) {
+        result.counters[counter_names[i]].push_back(after[i] - before[i]);
+    }
+}
+
+bool bench_runner::is_enabled(const string& name) const {
+    if (config.filters.empty()) {
+        return true;
+    }
+    return any_of(config.filters.begin(), config.filters.end(), [&](const string& filter) {
+        return name.find(filter) != string::npos;
+    });
+}
+
+void bench_runner::print_results() const {
+    size_t width = 4;
+    for (const auto& result: results) {
+        width = std::max(width, result.name.size());
+    }
+
+    println("\n{:<{}}  {:>10}  {:>10}  {:>10}  {:>14}", "name", width, "median", "p95", "min", "items/s");
+    for (const auto& result: results) {
+        auto median = result.median();
+        string throughput;
+        if (result.items > 0 && median > 0) {
+            throughput = format("{:.3g}", result.items / (median / 1e9));
+        }
+        println(
+            "{:<{}}  {:>10}  {:>10}  {:>10}  {:>14}",
+            result.name,
+            width,
+            duration_to_str(median),
+            duration_to_str(result.p95()),
+            duration_to_str(result.min()),
+            throughput
+        );
+    }
+
+    if (counter_names.empty()) {
+        return;
+    }
+
+    // Benchmarks without items (e.g. the stages of building the caches) are reported per run
+    println("\ncounters (median per item or per run, if the benchmark has no items)");
+    println("{:<{}}{}", "name", width, counters ? "     IPC" : "");
+    for (const auto& result: results) {
+        auto divisor = result.items > 0 ? static_cast<double>(result.items) : 1.0;
+        auto line = format("{:<{}}", result.name, width);
+        if (counters) {
+            line += format("  {:>6.2f}", result.ipc());
+        }
+        for (const auto& counter: counter_names) {
+            line += format("  {}: {:.3g}", counter, result.counter_median(counter) / divisor);
+        }
+        println("{}", line);
+    }
+}
+
+string bench_runner::to_json() const {
+    string out = "{\n  \"context\": {\n";
+    out += format("    \"hardware_threads\": {},\n", std::max<unsigned>(thread::hardware_concurrency(), 1));
+#ifdef NDEBUG
+    out += "    \"debug\": false,\n";
+#else
+    out += "    \"debug\": true,\n";
+#endif
+#ifdef __VERSION__
+    out += format("    \"compiler\": \"{}\",\n", escape_json(__VERSION__));
+#endif
+    out += format("    \"warmup\": {},\n", config.warmup);
+    out += format("    \"repetitions\": {},\n", config.repetitions);
+    out += "    \"counters\": [";
+    for (size_t i = 0; i < counter_names.size(); ++i) {
+        out += format("{}\"{}\"", i == 0 ? "" : ", ", counter_names[i]);
+    }
+    out += "]\n";
+    out += "  },\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out += i == 0 ? "\n" : ",\n";
+        out += format("    {{\"name\": \"{}\", ", escape_json(result.name));
+        out += format("\"items\": {}, ", result.items);
+        out += format("\"median_ns\": {:.1f}, ", result.median());
+        out += format("\"p95_ns\": {:.1f}, ", result.p95());
+        out += format("\"min_ns\": {:.1f}, ", result.min());
+        out += format("\"mean_ns\": {:.1f}, ", result.mean());
+        if (!result.counters.empty()) {
+            // Medians over all measured runs, the ratios are derived from them
+            if (counters) {
+                out += format("\"ipc\": {:.3f}, ", result.ipc());
+            }
+            out += "\"counters\": {";
+            auto first = true;
+            for (const auto& [counter, values]: result.counters) {
+                auto median = result.counter_median(counter);
+                out += format("{}\"{}\": {:.1f}", first ? "" : ", ", counter, median);
+                if (result.items > 0) {
+                    out += format(", \"{}_per_item\": {:.4f}", counter, median / result.items);
+                }
+                first = false;
+            }
+            out += "}, ";
+        }
+        out += "\"samples_ns\": [";
+        for (size_t j = 0; j < result.samples.size(); ++j) {
+            out += j == 0 ? "" : ", ";
+            out += format("{:.1f}", result.samples[j]);
+        }
+        out += "]}";
+    }
+
+    out += "\n  ]\n}\n";
+    return out;
+}
+
+void do_not_optimize(double value) {
+    // The compiler can't know, that the volatile variable is never read
+    volatile double sink = value;
+    (void) sink;
+}
+
+}
@@ -0,0 +1,86 @@
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/evaluation/bsplines.hpp"
+#include "tsl/evaluation/subdevision.hpp"
+#include "tsl_benchmark/benchmarks.hpp"
+
+using std::array;
+using std::vector;
+
+using fmt::format;
+
+using namespace tsl;
+
+namespace tsl_benchmark {
+
+namespace {
+
+/// Number of parameters evaluated per run in each direction.
+constexpr uint32_t PARAMS_PER_DIRECTION = 100;
+
+/// Valences of the extraordinary vertices, the subdevision kernel is measured with.
+const array<uint32_t, 4> SUBD_VALENCES = {3, 5, 6, 8};
+
+}
+
+void run_kernel_benchmarks(bench_runner& runner) {
+    constexpr auto num_params = PARAMS_PER_DIRECTION * PARAMS_PER_DIRECTION;
+
+    const double knots[] = {0, 1, 2, 3, 4};
+    runner.run("kernel/bspline", num_params, [&]() {
+        double sum = 0;
+        for (uint32_t i = 0; i < num_params; ++i) {
+            auto basis = get_bspline_with_der<3>(4.0 * i / num_params, knots);
+            sum += basis.x + basis.y;
+        }
+        do_not_optimize(sum);
+    });
+
+    for (auto valence: SUBD_VALENCES) {
+        // The control points only have to be distinct, their actual positions don't change the costs
+        auto num_points = 2 * valence + 8;
+        vector<double> x_coords(num_points);
+        vector<double> y_coords(num_points);
+        vector<double> z_coords(num_points);
+        for (uint32_t i = 0; i < num_points; ++i) {
+            x_coords[i] = std::cos(i);
+            y_coords[i] = std::sin(i);
+            z_coords[i] = 0.1 * i;
+        }
+
+        runner.run(format("kernel/subd/v{}", valence), num_params, [&]() {
+            double sum = 0;
+            for (uint32_t y = 0; y < PARAMS_PER_DIRECTION; ++y) {
+                for (uint32_t x = 0; x < PARAMS_PER_DIRECTION; ++x) {
+                    auto u = (x + 0.5) / PARAMS_PER_DIRECTION;
+                    auto v = (y + 0.5) / PARAMS_PER_DIRECTION;
+                    double point[3];
+                    double du[3];
+                    double dv[3];
+                    subd_eval(
+                        u,
+                        v,
+                        static_cast<int>(num_points),
+                        x_coords.data(),
+                        y_coords.data(),
+                        z_coords.data(),
+                        point,
+                        du,
+                        dv,
+                        nullptr,
+                        nullptr,
+                        nullptr
+                    );
+                    sum += point[0] + du[1] + dv[2];
+                }
+            }
+            do_not_optimize(sum);
+        });
+    }
+}
+
+}
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/io/obj.hpp"
+#include "tsl/util/panic.hpp"
+#include "tsl/util/println.hpp"
+#include "tsl/util/trace.hpp"
+#include "tsl_benchmark/benchmarks.hpp"
+#include "tsl_benchmark/harness.hpp"
+
+using std::nullopt;
+using std::ofstream;
+using std::string;
+using std::stringstream;
+using std::thread;
+using std::vector;
+
+using fmt::format;
+
+using namespace tsl;
+using namespace tsl_benchmark;
+
+namespace {
+
+void print_usage() {
+    println("Usage: tsl_benchmark [options] [path_to_mesh...]\n");
+    println("Runs all benchmarks on the generated meshes and the given obj files and prints median, p95 and min of the");
+    println("measured runs.\n");
+    println("Options:");
+    println("  --warmup <n>       Number of runs of each benchmark before measuring (default: 2).");
+    println("  --reps <n>         Number of measured runs of each benchmark (default: 10).");
+    println("  --filter <text>    Only run benchmarks, whose name contains the text. Can be given multiple times.");
+    println("  --json <path>      Write the results as JSON to the given file.");
+    println("  --res <list>       Comma separated resolutions for the evaluation (default: 4,16).");
+    println("  --threads <list>   Comma separated max numbers of threads for parallel stages (default: 1,<all>).");
+    println("  --cube <size>      Size of the generated cube (see `tmesh_cube`), 0 to disable it (default: 8).");
+    println("  --torus <size>     Number of cells per side of a generated torus (see `tmesh_synthetic`), 0 to disable");
+    println("                     it (default: 0).");
+    println("  --tjunctions <x>   Fraction of the cells of the torus, which are split into T-junctions (default: 0.1).");
+    println("  --valences <list>  Comma separated valences of the extraordinary vertices of the torus (default: 3,5,8).");
+    println("  --reorder          Reorder the meshes for locality (see `tmesh::reorder`) before running.");
+    println("  --counters         Collect hardware performance counters (linux only, see `perf_event_paranoid`).");
+    println("  --trace <path>     Write the trace zones of all runs as Chrome trace to the given file (needs TSL_TRACE).");
+}
+
+[[noreturn]] void fail(const string& msg) {
+    println("{}\n", msg);
+    print_usage();
+    exit(EXIT_FAILURE);
+}
+
+size_t parse_number(const string& str) {
+    try {
+        size_t pos = 0;
+        auto out = std::stoul(str, &pos);
+        if (pos == str.size()) {
+            return out;
+        }
+    } catch (const std::exception&) {
+        // reported below
+    }
+    fail(format("Invalid number: {}", str));
+}
+
+double parse_double(const string& str) {
+    try {
+        size_t pos = 0;
+        auto out = std::stod(str, &pos);
+        if (pos == str.size()) {
+            return out;
+        }
+    } catch (const std::exception&) {
+        // reported below
+    }
+    fail(format("Invalid number: {}", str));
+}
+
+vector<size_t> parse_list(const string& str) {
+    vector<size_t> out;
+    stringstream stream(str);
+    string item;
+    while (std::getline(stream, item, ',')) {
+        out.push_back(parse_number(item));
+    }
+    return out;
+}
+
+string get_stem(const string& path) {
+    auto begin = path.find_last_of("/\\");
+    begin = begin == string::npos ? 0 : begin + 1;
+    auto end = path.find_last_of('.');
+    return path.substr(begin, end == string::npos || end < begin ? string::npos : end - begin);
+}
+
+}
+
+/**
+ * @brief Runs the benchmarks for loading meshes, traversing them, each stage of building the caches of the
+ *        evaluator, the evaluation kernels, the evaluation of each kind of face and the attribute maps.
+ */
+int main(int argc, char* argv[]) {
+    vector<string> args(argv + 1, argv + argc);
+
+    bench_config config;
+    bench_params params;
+    params.resolutions = {4, 16};
+    params.thread_counts = {1, std::max<size_t>(thread::hardware_concurrency(), 1)};
+    optional<string> json_path;
+    optional<string> trace_path;
+    size_t cube_size = 8;
+    synthetic_tmesh_config torus_config;
+    torus_config.width = 0;
+    torus_config.t_junction_density = 0.1;
+    torus_config.valences = {3, 5, 8};
+    torus_config.max_knot_ratio = 2.0;
+    auto reorder = false;
+    vector<string> paths;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const auto& arg = args[i];
+        auto next = [&]() -> const string& {
+            if (i + 1 >= args.size()) {
+                fail(format("Missing value for {}", arg));
+            }
+            return args[++i];
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage();
+            exit(EXIT_SUCCESS);
+        } else if (arg == "--warmup") {
+            config.warmup = parse_number(next());
+        } else if (arg == "--reps") {
+            config.repetitions = parse_number(next());
+        } else if (arg == "--filter") {
+            config.filters.push_back(next());
+        } else if (arg == "--json") {
+            json_path = next();
+        } else if (arg == "--res") {
+            params.resolutions.clear();
+            for (auto res: parse_list(next())) {
+                params.resolutions.push_back(static_cast<uint32_t>(res));
+            }
+        } else if (arg == "--threads") {
+            params.thread_counts = parse_list(next());
+        } else if (arg == "--cube") {
+            cube_size = parse_number(next());
+        } else if (arg == "--torus") {
+            torus_config.width = static_cast<uint32_t>(parse_number(next()));
+            torus_config.height = torus_config.width;
+        } else if (arg == "--tjunctions") {
+            torus_config.t_junction_density = parse_double(next());
+        } else if (arg == "--valences") {
+            torus_config.valences.clear();
+            for (auto valence: parse_list(next())) {
+                torus_config.valences.push_back(static_cast<uint32_t>(valence));
+            }
+        } else if (arg == "--reorder") {
+            reorder = true;
+        } else if (arg == "--counters") {
+            config.counters = true;
+        } else if (arg == "--trace") {
+            trace_path = next();
+        } else if (arg.rfind("--", 0) == 0) {
+            fail(format("Unknown option: {}", arg));
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (config.repetitions == 0) {
+        fail("At least one repetition is needed");
+    }
+    if (trace_path && !TRACE_COMPILED) {
+        fail("--trace needs tsl to be compiled with the CMake option TSL_TRACE");
+    }
+    std::sort(params.thread_counts.begin(), params.thread_counts.end());
+    params.thread_counts.erase(
+        std::unique(params.thread_counts.begin(), params.thread_counts.end()),
+        params.thread_counts.end()
+    );
+
+    vector<bench_input> inputs;
+    if (cube_size > 0) {
+        inputs.emplace_back(format("cube{}", cube_size), tmesh_cube(static_cast<uint32_t>(cube_size)), nullopt);
+    }
+    if (torus_config.width > 0) {
+        try {
+            inputs.emplace_back(format("torus{}", torus_config.width), tmesh_synthetic(torus_config), nullopt);
+        } catch (const panic_exception& e) {
+            fail(e.what());
+        }
+    }
+    for (const auto& path: paths) {
+        inputs.emplace_back(get_stem(path), read_obj_into_tmesh(path), path);
+    }
+    if (reorder) {
+        for (auto& input: inputs) {
+            input.mesh.reorder();
+        }
+    }
+
+    if (trace_path) {
+        start_trace();
+    }
+
+    bench_runner runner(config);
+    run_attrmap_benchmarks(runner);
+    run_kernel_benchmarks(runner);
+    for (const auto& input: inputs) {
+        run_tmesh_benchmarks(runner, input, params);
+        run_evaluation_benchmarks(runner, input, params);
+    }
+    runner.print_results();
+
+    if (trace_path) {
+        stop_trace();
+        if (!write_trace(*trace_path)) {
+            println("Could not write {}", *trace_path);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (json_path) {
+        ofstream out(*json_path);
+        out << runner.to_json();
+        if (!out) {
+            println("Could not write {}", *json_path);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,102 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "tsl_benchmark/perf_counters.hpp"
+
+namespace tsl_benchmark {
+
+#ifdef __linux__
+
+namespace {
+
+/**
+ * @brief POD type to describe a counter to open.
+ */
+struct counter_desc {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t L1D_READ_MISS = PERF_COUNT_HW_CACHE_L1D
+    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+const counter_desc COUNTERS[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"l1d_misses", PERF_TYPE_HW_CACHE, L1D_READ_MISS},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int open_counter(const counter_desc& desc) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = desc.type;
+    attr.config = desc.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Count the worker threads of `parallel_for`, too
+    attr.inherit = 1;
+    // Only user space can be counted with the default `perf_event_paranoid` of most distributions
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+}
+
+perf_counters::perf_counters() {
+    for (const auto& desc: COUNTERS) {
+        auto fd = open_counter(desc);
+        if (fd < 0) {
+            if (error.empty()) {
+                error = string("perf_event_open failed for ") + desc.name + ": " + std::strerror(errno);
+            }
+            continue;
+        }
+        fds.push_back(fd);
+        names.emplace_back(desc.name);
+    }
+    if (is_available()) {
+        error.clear();
+    }
+}
+
+perf_counters::~perf_counters() {
+    for (auto fd: fds) {
+        close(fd);
+    }
+}
+
+void perf_counters::read(double* out) const {
+    for (size_t i = 0; i < fds.size(); ++i) {
+        // value, time enabled, time running
+        uint64_t data[3] = {0, 0, 0};
+        if (::read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) {
+            out[i] = 0;
+            continue;
+        }
+        out[i] = static_cast<double>(data[0]) * data[1] / data[2];
+    }
+}
+
+#else
+
+perf_counters::perf_counters() : error("hardware counters are only supported on linux") {}
+
+perf_counters::~perf_counters() = default;
+
+void perf_counters::read(double* out) const {}
+
+#endif
+
+}
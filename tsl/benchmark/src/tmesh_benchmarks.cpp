@@ -0,0 +1,102 @@
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
+#include "tsl/algorithm/reduction.hpp"
+#include "tsl/geometry/tmesh/tmesh.hpp"
+#include "tsl/geometry/tmesh/frozen_tmesh.hpp"
+#include "tsl/io/obj.hpp"
+#include "tsl_benchmark/benchmarks.hpp"
+
+using std::vector;
+
+using fmt::format;
+
+using namespace tsl;
+
+namespace tsl_benchmark {
+
+void run_tmesh_benchmarks(bench_runner& runner, const bench_input& input, const bench_params& params) {
+    const auto& mesh = input.mesh;
+    auto prefix = "tmesh/" + input.name + "/";
+
+    if (input.path) {
+        runner.run("load/" + input.name, mesh.num_faces(), [&]() {
+            auto loaded = read_obj_into_tmesh(*input.path);
+            do_not_optimize(loaded.num_faces());
+        });
+    }
+
+    runner.run(prefix + "copy", mesh.num_faces(), [&]() {
+        auto copy = mesh;
+        do_not_optimize(copy.num_faces());
+    });
+
+    runner.run(prefix + "freeze", mesh.num_faces(), [&]() {
+        frozen_tmesh frozen(mesh);
+        do_not_optimize(frozen.num_faces());
+    });
+
+    vector<vertex_handle> vertices;
+    runner.run(prefix + "vertices_of_faces", mesh.num_faces(), [&]() {
+        size_t count = 0;
+        for (const auto& fh: mesh.get_faces()) {
+            vertices.clear();
+            mesh.get_vertices_of_face(fh, vertices);
+            count += vertices.size();
+        }
+        do_not_optimize(count);
+    });
+
+    vector<face_handle> faces;
+    runner.run(prefix + "faces_of_vertices", mesh.num_vertices(), [&]() {
+        size_t count = 0;
+        for (const auto& vh: mesh.get_vertices()) {
+            faces.clear();
+            mesh.get_faces_of_vertex(vh, faces);
+            count += faces.size();
+        }
+        do_not_optimize(count);
+    });
+
+    runner.run(prefix + "vertices_of_edges", mesh.num_edges(), [&]() {
+        double sum = 0;
+        for (const auto& eh: mesh.get_edges()) {
+            auto [a, b] = mesh.get_vertices_of_edge(eh);
+            sum += a.get_idx() + b.get_idx();
+        }
+        do_not_optimize(sum);
+    });
+
+    runner.run(prefix + "valences", mesh.num_vertices(), [&]() {
+        size_t sum = 0;
+        for (const auto& vh: mesh.get_vertices()) {
+            sum += mesh.get_valence(vh);
+        }
+        do_not_optimize(sum);
+    });
+
+    runner.run(prefix + "extraordinary_distance_field", mesh.num_vertices(), [&]() {
+        extraordinary_distance_field field(mesh);
+        do_not_optimize(field.get_rings());
+    });
+
+    // Includes copying the mesh, see "copy"
+    runner.run(prefix + "remove_edges", mesh.num_edges(), [&]() {
+        auto copy = mesh;
+        do_not_optimize(remove_edges(copy, 50));
+    });
+
+    for (auto num_threads: params.thread_counts) {
+        runner.run(format("{}remove_edges_batch/t{}", prefix, num_threads), mesh.num_edges(), [&]() {
+            auto copy = mesh;
+            batch_reduction_config config;
+            config.percent = 50;
+            config.num_threads = num_threads;
+            do_not_optimize(remove_edges_batch(copy, config));
+        });
+    }
+}
+
+}
@@ -0,0 +1,95 @@
+#ifndef TSL_EXTRAORDINARY_DISTANCE_FIELD_HPP
+#define TSL_EXTRAORDINARY_DISTANCE_FIELD_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "tsl/attrmaps/attr_maps.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/geometry/tmesh/tmesh.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/// Number of rings around an extraordinary vertex, in which `tmesh::remove_edge` doesn't remove edges.
+inline static const uint32_t EXTRAORDINARY_RINGS = 3;
+
+/**
+ * @brief The extraordinary vertices nearest to a vertex.
+ */
+struct nearest_extraordinary {
+    /// Distance in rings to the nearest extraordinary vertices, 0 for an extraordinary vertex itself.
+    uint32_t distance;
+    /// All extraordinary vertices with this distance, sorted by handle.
+    vector<vertex_handle> vertices;
+};
+
+/**
+ * @brief Holds for each vertex of a tmesh the nearest extraordinary vertices within the given number of rings.
+ *
+ * The first ring of a vertex consists of all vertices of the faces around it, the second ring of the first rings of
+ * those and so on. On regular parts of the mesh these are the same rings as visited by `visit_regular_rings`.
+ *
+ * The field is built with one multi-source breadth first search from all extraordinary vertices, which only visits
+ * the vertices within `rings` rings around them. Removing an edge (see `tmesh::remove_edge`) merges two faces and
+ * may remove T-vertices, which never increases a distance and doesn't change which vertices are extraordinary. Thus
+ * the field can be updated incrementally by `update_face` with the merged face.
+ */
+class extraordinary_distance_field {
+public:
+    /**
+     * @brief Builds the field for all vertices of the given mesh.
+     */
+    explicit extraordinary_distance_field(const tmesh& mesh, uint32_t rings = EXTRAORDINARY_RINGS);
+
+    /**
+     * @brief Returns the nearest extraordinary vertices of the given vertex. Their distance is greater than `rings`
+     *        and the list is empty, if there is none within `rings` rings.
+     */
+    const nearest_extraordinary& get_nearest(vertex_handle handle) const;
+
+    /**
+     * @brief Returns true, if an extraordinary vertex lies within `rings` rings around both given vertices. This only
+     *        takes O(1) for vertices sharing a face (like the vertices of an edge).
+     */
+    bool is_near_both(vertex_handle first, vertex_handle second) const;
+
+    /**
+     * @brief Updates the field after the vertices of the given face have become neighbours, because it was merged
+     *        with another face.
+     */
+    void update_face(const tmesh& mesh, face_handle handle);
+
+    /**
+     * @brief Returns the number of rings, which are searched for extraordinary vertices.
+     */
+    uint32_t get_rings() const;
+
+private:
+    uint32_t rings;
+    dense_vertex_map<nearest_extraordinary> nearest;
+
+    /**
+     * @brief Offers the nearest extraordinary vertices of `from` to its neighbour `to` and returns true, if the
+     *        nearest extraordinary vertices of `to` changed.
+     */
+    bool relax(vertex_handle from, vertex_handle to);
+
+    /**
+     * @brief Relaxes all neighbours of the given vertices, until no nearest extraordinary vertices change anymore.
+     */
+    void propagate(const tmesh& mesh, vector<vertex_handle>& queue);
+};
+
+/**
+ * @brief Returns true, if an extraordinary vertex lies within the given number of rings around both given vertices.
+ *
+ * This is the same check as `extraordinary_distance_field::is_near_both`, but only searches the rings around the two
+ * vertices, so it is suited for single checks without building a field. The vertices have to share a face.
+ */
+bool is_near_extraordinary_vertex(const tmesh& mesh, vertex_handle first, vertex_handle second, uint32_t rings);
+
+}
+
+#endif //TSL_EXTRAORDINARY_DISTANCE_FIELD_HPP
@@ -1,8 +1,13 @@
 #ifndef TSL_GENERATOR_HPP
 #define TSL_GENERATOR_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include "tsl/geometry/tmesh/tmesh.hpp"
 
+using std::vector;
+
 namespace tsl {
 
 /**
@@ -10,6 +15,58 @@ namespace tsl {
  */
 tmesh tmesh_cube(uint32_t size, double edge_length = 1.0);
 
+/**
+ * @brief POD type to hold the parameters of `tmesh_synthetic`.
+ */
+struct synthetic_tmesh_config {
+    /// Number of cells around the torus in the first (long) direction.
+    uint32_t width;
+    /// Number of cells around the torus in the second direction.
+    uint32_t height;
+    /// Fraction (0 to 1) of the cells, which are split in half. Each split creates T-junctions in the neighbouring
+    /// cells, which aren't split in the same way.
+    double t_junction_density;
+    /// Valences (3 to `MAX_VALENCE`) of the extraordinary vertices to create. Each needs a block of
+    /// `valence * sector_size / 2` cells plus a margin of one cell, the blocks are spread evenly over the mesh.
+    vector<uint32_t> valences;
+    /// Number of faces per side of each of the `valence` quad sectors around an extraordinary vertex.
+    uint32_t sector_size;
+    /// The knot interval of each row and column of cells is drawn from [1, max_knot_ratio], thus 1 means uniform
+    /// knots. Rows and columns through the block of an extraordinary vertex always have uniform knots.
+    double max_knot_ratio;
+    /// Edge length of a cell with knot interval 1.
+    double edge_length;
+    /// Seed of the random numbers, equal configs create equal meshes.
+    uint32_t seed;
+
+    synthetic_tmesh_config()
+        : width(64),
+          height(64),
+          t_junction_density(0.0),
+          sector_size(2),
+          max_knot_ratio(1.0),
+          edge_length(1.0),
+          seed(0) {}
+};
+
+/**
+ * @brief Generates a closed tmesh in form of a torus with the given number of cells, T-junctions, extraordinary
+ *        vertices and knot intervals, which scales to millions of faces.
+ *
+ * The cells of the torus are laid out by their knot intervals. A split cell is divided into a left and a right or a
+ * bottom and a top face, chosen at random, and the midpoints of the split sides become T-junctions in the faces of
+ * the neighbouring cells. Cells next to extraordinary vertices are never split.
+ *
+ * Each extraordinary vertex of valence `k` replaces a square block of cells by `k` sectors of
+ * `sector_size * sector_size` faces. As the valences of a closed quad mesh are balanced, the corners of the block
+ * and the sectors, which don't line up, get valence 5 and 3 respectively. They are `sector_size` edges away from the
+ * extraordinary vertex.
+ *
+ * All storage of the mesh is allocated once up front (see `tmesh::reserve`). This function panics, if the config
+ * is invalid or the blocks of the extraordinary vertices don't fit into the mesh.
+ */
+tmesh tmesh_synthetic(const synthetic_tmesh_config& config);
+
 }
 
 #endif //TSL_GENERATOR_HPP
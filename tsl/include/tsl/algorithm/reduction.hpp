@@ -1,15 +1,46 @@
 #ifndef TSL_REDUCTION_HPP
 #define TSL_REDUCTION_HPP
 
+#include <cstddef>
+#include <cstdint>
+
 #include "tsl/geometry/tmesh/tmesh.hpp"
 
 namespace tsl {
 
+/**
+ * @brief Configuration of `remove_edges_batch`.
+ */
+struct batch_reduction_config {
+    /// Percentage (0 to 100] of the edges of the mesh, which should be removed.
+    double percent;
+    /// Seed of the random order, in which the edges are tried. Equal seeds remove the same edges.
+    uint32_t seed;
+    /// Max number of threads. 0 means "use all available hardware threads".
+    size_t num_threads;
+
+    batch_reduction_config() : percent(10.0), seed(0), num_threads(0) {}
+};
+
 /**
  * @brief Tries to remove the given percentage of egdges from the given tmesh.
  */
 size_t remove_edges(tmesh& mesh, double percent);
 
+/**
+ * @brief Tries to remove the configured percentage of edges from the given tmesh in rounds, which each remove a set
+ *        of independent edges in parallel (see `tmesh::remove_independent_edges`), and returns the number of removed
+ *        edges.
+ *
+ * All edges are tried in a random order. Each round takes the next edges of this order and selects the removable
+ * ones, whose surrounding faces (the faces around the vertices of the faces around their vertices) don't overlap with
+ * those of a removable edge earlier in the order. Edges, which can't be removed, are dropped, edges which lost such a
+ * conflict are tried again in the next round. The rounds
+ * stop as soon as the percentage of edges is removed or all edges were tried. The removed edges only depend on the
+ * mesh and the seed, not on the number of threads.
+ */
+size_t remove_edges_batch(tmesh& mesh, const batch_reduction_config& config);
+
 }
 
 #endif //TSL_REDUCTION_HPP
@@ -2,6 +2,7 @@
 #define TSL_ATTR_MAPS_HPP
 
 #include "attribute_map.hpp"
+#include "csr_map.hpp"
 #include "hash_map.hpp"
 #include "vector_map.hpp"
 #include "tsl/geometry/tmesh/handles.hpp"
@@ -36,6 +37,11 @@ namespace tsl {
  * - dense_attr_map: uses an array (vector_map/std::vector)
  * - sparse_attr_map: uses a hash map (hash_map/std::unordered_map)
  *
+ * If a handle is associated with a variable number of values which are
+ * computed all at once, use a `csr_map` instead of a
+ * `dense_attr_map<handle_t, vector<value_t>>`. It packs all values into one
+ * contiguous array and doesn't allocate a vector per handle.
+ *
  *
  * Additionally, there are specific type aliases for the most common uses,
  * like `face_map = attribute_map<face_handle, T>`. You should use those when you
@@ -66,6 +72,9 @@ template<typename value_t> using sparse_half_edge_map       = sparse_attr_map<ha
 template<typename value_t> using sparse_face_map       = sparse_attr_map<face_handle, value_t>;
 template<typename value_t> using sparse_vertex_map     = sparse_attr_map<vertex_handle, value_t>;
 
+template<typename value_t> using csr_face_map          = csr_map<face_handle, value_t>;
+template<typename value_t> using csr_vertex_map        = csr_map<vertex_handle, value_t>;
+
 }
 
 #endif //TSL_ATTR_MAPS_HPP
@@ -0,0 +1,137 @@
+#ifndef TSL_CSR_MAP_HPP
+#define TSL_CSR_MAP_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "tsl/util/base_handle.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/util/memory_report.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief A view of a contiguous range of values inside a `csr_map`.
+ *
+ * The view is only valid as long as the map it was created from is not rebuilt or destroyed.
+ */
+template<typename value_t>
+class csr_range
+{
+public:
+    csr_range(value_t* first, value_t* last) : first(first), last(last) {}
+
+    value_t* begin() const { return first; }
+    value_t* end() const { return last; }
+
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+
+    value_t& operator[](size_t i) const { return first[i]; }
+
+private:
+    value_t* first;
+    value_t* last;
+};
+
+/**
+ * @brief A map which associates a variable number of values with each handle and stores them in a
+ *        compressed-sparse-row (CSR) layout.
+ *
+ * All values are packed into one contiguous vector. The values of the key with index `i` are stored in the range
+ * `[offsets[i], offsets[i + 1])` of this vector. Compared to a `dense_attr_map<handle_t, vector<value_t>>` this needs
+ * two allocations in total instead of one per key, and iterating over the values of a key touches a single
+ * contiguous block of memory.
+ *
+ * The layout (the number of values per key) is fixed by `build()`. Afterwards only the values can be changed, which
+ * means values of different keys can be written concurrently.
+ */
+template<typename handle_t, typename value_t>
+class csr_map
+{
+    static_assert(
+        std::is_base_of<base_handle<index>, handle_t>::value,
+        "handle_t must inherit from base_handle!"
+    );
+public:
+    csr_map() = default;
+
+    /**
+     * @brief Rebuilds the layout of the map: the key with index `i` gets `counts[i]` values, each initialized with
+     *        `fill`.
+     */
+    void build(const vector<index>& counts, const value_t& fill);
+
+    /**
+     * @brief Rebuilds the layout of the map to match the layout of the given map. Each value is initialized with
+     *        `fill`.
+     */
+    template<typename other_value_t>
+    void build(const csr_map<handle_t, other_value_t>& layout, const value_t& fill);
+
+    /**
+     * @brief Returns the values of the given key.
+     *
+     * In debug mode this method panics, if the key is not known to the map.
+     */
+    csr_range<value_t> operator[](handle_t key);
+
+    /**
+     * @see operator[](handle_t)
+     */
+    csr_range<const value_t> operator[](handle_t key) const;
+
+    /**
+     * @brief Returns the position of the first value of the given key in the packed value array.
+     */
+    index get_offset(handle_t key) const;
+
+    /**
+     * @brief Returns true, if the key is known to the map. Keys without any values are known to the map, too.
+     */
+    bool contains_key(handle_t key) const;
+
+    /**
+     * @brief Returns all values packed into one vector.
+     */
+    const vector<value_t>& get_values() const;
+
+    /**
+     * @brief The number of keys, which is the highest key index + 1.
+     */
+    size_t num_keys() const;
+
+    /**
+     * @brief The total number of values of all keys.
+     */
+    size_t num_values() const;
+
+    /**
+     * @brief Removes all keys and values.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the memory used by the offsets and the values of this map.
+     */
+    memory_usage get_memory_usage() const;
+
+private:
+    /// offsets[i] is the position of the first value of key i, offsets[num_keys] is the total number of values
+    vector<index> offsets;
+    /// Values of all keys
+    vector<value_t> values;
+
+    void check_access(handle_t key) const;
+
+    template<typename, typename> friend class csr_map;
+};
+
+}
+
+#include "tsl/attrmaps/csr_map.tcc"
+
+#endif //TSL_CSR_MAP_HPP
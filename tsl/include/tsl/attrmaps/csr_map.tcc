@@ -0,0 +1,106 @@
+#include "tsl/util/panic.hpp"
+
+namespace tsl {
+
+template<typename handle_t, typename value_t>
+void csr_map<handle_t, value_t>::build(const vector<index>& counts, const value_t& fill)
+{
+    offsets.clear();
+    offsets.reserve(counts.size() + 1);
+
+    index sum = 0;
+    offsets.push_back(sum);
+    for (auto count: counts)
+    {
+        sum += count;
+        offsets.push_back(sum);
+    }
+
+    values.clear();
+    values.resize(sum, fill);
+}
+
+template<typename handle_t, typename value_t>
+template<typename other_value_t>
+void csr_map<handle_t, value_t>::build(const csr_map<handle_t, other_value_t>& layout, const value_t& fill)
+{
+    offsets = layout.offsets;
+    values.clear();
+    values.resize(layout.num_values(), fill);
+}
+
+template<typename handle_t, typename value_t>
+csr_range<value_t> csr_map<handle_t, value_t>::operator[](handle_t key)
+{
+    check_access(key);
+    auto data = values.data();
+    return csr_range<value_t>(data + offsets[key.get_idx()], data + offsets[key.get_idx() + 1]);
+}
+
+template<typename handle_t, typename value_t>
+csr_range<const value_t> csr_map<handle_t, value_t>::operator[](handle_t key) const
+{
+    check_access(key);
+    auto data = values.data();
+    return csr_range<const value_t>(data + offsets[key.get_idx()], data + offsets[key.get_idx() + 1]);
+}
+
+template<typename handle_t, typename value_t>
+index csr_map<handle_t, value_t>::get_offset(handle_t key) const
+{
+    check_access(key);
+    return offsets[key.get_idx()];
+}
+
+template<typename handle_t, typename value_t>
+bool csr_map<handle_t, value_t>::contains_key(handle_t key) const
+{
+    return key.get_idx() < num_keys();
+}
+
+template<typename handle_t, typename value_t>
+const vector<value_t>& csr_map<handle_t, value_t>::get_values() const
+{
+    return values;
+}
+
+template<typename handle_t, typename value_t>
+size_t csr_map<handle_t, value_t>::num_keys() const
+{
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+template<typename handle_t, typename value_t>
+size_t csr_map<handle_t, value_t>::num_values() const
+{
+    return values.size();
+}
+
+template<typename handle_t, typename value_t>
+void csr_map<handle_t, value_t>::clear()
+{
+    offsets.clear();
+    values.clear();
+}
+
+template<typename handle_t, typename value_t>
+memory_usage csr_map<handle_t, value_t>::get_memory_usage() const
+{
+    auto out = tsl::get_memory_usage(offsets);
+    out += tsl::get_memory_usage(values);
+    return out;
+}
+
+template<typename handle_t, typename value_t>
+void csr_map<handle_t, value_t>::check_access([[maybe_unused]] handle_t key) const
+{
+    // Only actually check in debug mode, because checking this is costly...
+#ifndef NDEBUG
+    if (!contains_key(key))
+    {
+        panic("lookup with an out of bounds handle ({}) in csr_map", key);
+    }
+#endif
+}
+
+}
@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "tsl/attrmaps/attribute_map.hpp"
+#include "tsl/util/memory_report.hpp"
 
 using std::unordered_map;
 using std::optional;
@@ -67,6 +68,12 @@ public:
      */
     void reserve(size_t new_cap);
 
+    /**
+     * @brief Returns the memory used by this map. The reserved bytes are an estimate: each value is stored in its
+     *        own node with a pointer to the next node and each bucket is one pointer.
+     */
+    memory_usage get_memory_usage() const;
+
 private:
     unordered_map<handle_t, value_t> map;
     optional<value_t> default_value;
@@ -133,6 +133,14 @@ void hash_map<handle_t, value_t>::reserve(size_t new_cap)
     map.reserve(new_cap);
 }
 
+template<typename handle_t, typename value_t>
+memory_usage hash_map<handle_t, value_t>::get_memory_usage() const
+{
+    using entry = typename unordered_map<handle_t, value_t>::value_type;
+    auto used = map.size() * sizeof(entry);
+    return memory_usage(used, 0, used + map.size() * sizeof(void*) + map.bucket_count() * sizeof(void*));
+}
+
 template<typename handle_t, typename value_t>
 hash_map<handle_t, value_t>::~hash_map() = default;
 
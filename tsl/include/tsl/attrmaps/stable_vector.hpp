@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "tsl/util/base_handle.hpp"
+#include "tsl/util/memory_report.hpp"
 #include "tsl/geometry/tmesh/handles.hpp"
 
 using std::optional;
@@ -232,6 +233,11 @@ public:
      */
     void reserve(size_t new_cap);
 
+    /**
+     * @brief Returns the memory used by this vector. The slots of deleted elements are reported as deleted.
+     */
+    memory_usage get_memory_usage() const;
+
 private:
     /// Count of used elements in elements vector
     size_t used_count;
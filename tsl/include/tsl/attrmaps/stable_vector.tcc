@@ -178,6 +178,17 @@ void stable_vector<handle_t, elem_t>::reserve(size_t new_cap)
     elements.reserve(new_cap);
 };
 
+template<typename handle_t, typename elem_t>
+memory_usage stable_vector<handle_t, elem_t>::get_memory_usage() const
+{
+    constexpr auto slot_size = sizeof(optional<elem_t>);
+    return memory_usage(
+        used_count * slot_size,
+        (elements.size() - used_count) * slot_size,
+        elements.capacity() * slot_size
+    );
+}
+
 template<typename handle_t, typename elem_t>
 stable_vector_iterator<handle_t, elem_t> stable_vector<handle_t, elem_t>::begin() const
 {
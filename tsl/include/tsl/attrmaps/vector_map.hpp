@@ -73,6 +73,11 @@ public:
      */
     void reserve(size_t new_cap);
 
+    /**
+     * @see stable_vector::get_memory_usage()
+     */
+    memory_usage get_memory_usage() const;
+
 private:
     /// The underlying storage
     stable_vector<handle_t, value_t> vec;
@@ -114,6 +114,12 @@ void vector_map<handle_t, value_t>::reserve(size_t new_cap)
     vec.reserve(new_cap);
 }
 
+template<typename handle_t, typename value_t>
+memory_usage vector_map<handle_t, value_t>::get_memory_usage() const
+{
+    return vec.get_memory_usage();
+}
+
 template<typename handle_t, typename value_t>
 vector_map<handle_t, value_t>::~vector_map() = default;
 
@@ -0,0 +1,78 @@
+#ifndef TSL_BORDER_STITCHING_HPP
+#define TSL_BORDER_STITCHING_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/grid.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold a vertex in the grid of an evaluated face.
+ */
+struct grid_vertex {
+    /// Index of the face in the faces passed to `get_border_stitches`.
+    uint32_t face;
+    uint32_t x;
+    uint32_t y;
+
+    grid_vertex() : face(0), x(0), y(0) {}
+    grid_vertex(uint32_t face, uint32_t x, uint32_t y) : face(face), x(x), y(y) {}
+};
+
+/**
+ * @brief POD type to hold a border vertex of a face grid, which is moved onto the line between two border vertices
+ *        of its neighbouring faces.
+ */
+struct border_stitch {
+    /// The vertex, which is moved.
+    grid_vertex target;
+    /// The vertex is moved to `(1 - t) * first + t * second`.
+    grid_vertex first;
+    grid_vertex second;
+    double t;
+
+    border_stitch(const grid_vertex& target, const grid_vertex& first, const grid_vertex& second, double t)
+        : target(target), first(first), second(second), t(t) {}
+};
+
+/**
+ * @brief Returns the smallest power of two (but at most `max_res`) as resolution of the given face, at which every
+ *        T-junction on its sides can be matched by its own border vertex (see `get_border_stitches`).
+ */
+uint32_t get_min_stitch_res(const surface_evaluator& evaluator, face_handle handle, uint32_t max_res);
+
+/**
+ * @brief Returns the moves of border vertices, which remove the cracks between the given faces evaluated as grids
+ *        with the given resolutions. The moves have to be applied in the returned order, since later moves read the
+ *        vertices moved by earlier ones.
+ *
+ * The neighbours of each side are found by the twins of its half edges (see `surface_evaluator::get_face_segments`),
+ * so a side at a T-junction has more than one neighbour. Each vertex of the tmesh is represented in a face by the
+ * border vertex nearest to it. These border vertices of all faces at the same vertex of the tmesh are moved onto one
+ * of them, which lies exactly on the vertex, if possible. Then on each edge of the tmesh the side with more border
+ * vertices is moved onto the side across it: the nearest border vertex of the moved side is moved onto each border
+ * vertex of the other side, the vertices in between are moved onto the lines between them. Sides with the same
+ * number of border vertices are ordered by their faces. The edges of faces with a resolution of 0 are not stitched.
+ *
+ * The border is only closed, if the resolution of each face is at least `get_min_stitch_res`.
+ */
+vector<border_stitch> get_border_stitches(
+    const surface_evaluator& evaluator,
+    const vector<face_handle>& faces,
+    const vector<uint32_t>& res
+);
+
+/**
+ * @brief Applies the given moves (see `get_border_stitches`) to the given grids.
+ */
+void stitch_grids(const vector<border_stitch>& stitches, vector<regular_grid>& grids);
+
+}
+
+#endif //TSL_BORDER_STITCHING_HPP
@@ -26,6 +26,13 @@ namespace tsl {
 template<uint32_t degree>
 vec2 get_bspline_with_der(double u, const vector<double>& knot_vector);
 
+/**
+ * @brief Same as `get_bspline_with_der(double, const vector<double>&)`, but reads the degree + 2 knots from the given
+ *        pointer. This allows to use knot vectors stored in fixed size arrays.
+ */
+template<uint32_t degree>
+vec2 get_bspline_with_der(double u, const double* knot_vector);
+
 }
 
 #include "bsplines.tcc"
@@ -8,6 +8,11 @@ namespace tsl {
 
 template<uint32_t degree>
 vec2 get_bspline_with_der(double u, const vector<double>& knot_vector) {
+    return get_bspline_with_der<degree>(u, knot_vector.data());
+}
+
+template<uint32_t degree>
+vec2 get_bspline_with_der(double u, const double* knot_vector) {
     if (u < knot_vector[0] || u >= knot_vector[degree + 1]) {
         return {0, 0};
     }
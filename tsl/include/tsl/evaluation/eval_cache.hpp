@@ -0,0 +1,134 @@
+#ifndef TSL_EVAL_CACHE_HPP
+#define TSL_EVAL_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tsl/grid.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/evaluation/eval_sink.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/util/lru_cache.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/// Default max number of bytes used by the grids in an `eval_cache`.
+constexpr size_t DEFAULT_EVAL_CACHE_SIZE = 256 * 1024 * 1024;
+
+/**
+ * @brief POD type to identify an evaluated face by its handle, its resolution and the version of its surface.
+ */
+struct eval_cache_key {
+    face_handle handle;
+    uint32_t res;
+    /// @see surface_evaluator::get_face_version(face_handle)
+    uint64_t version;
+
+    eval_cache_key(face_handle handle, uint32_t res, uint64_t version)
+        : handle(handle), res(res), version(version) {}
+
+    bool operator==(const eval_cache_key& other) const {
+        return handle == other.handle && res == other.res && version == other.version;
+    }
+};
+
+/**
+ * @brief Hashes an `eval_cache_key`.
+ */
+struct eval_cache_key_hash {
+    size_t operator()(const eval_cache_key& key) const;
+};
+
+/**
+ * @brief Evaluates faces like `surface_evaluator::eval_per_face`, but keeps the evaluated grids of the most recently
+ *        used faces and resolutions, so evaluating them again only copies the grids.
+ *
+ * The grids are identified by the version of their face, so they don't have to be invalidated, when the evaluator
+ * changes: grids of changed faces are never found again and are evicted, when the cache is full. One cache can be
+ * used for multiple evaluators. The cache is not thread safe.
+ */
+class eval_cache {
+public:
+    /**
+     * @brief Creates an empty cache, whose grids use at most `max_bytes` bytes.
+     */
+    explicit eval_cache(size_t max_bytes = DEFAULT_EVAL_CACHE_SIZE);
+
+    /**
+     * @brief Evaluates all faces of the given evaluator with the given resolution.
+     *
+     * @see surface_evaluator::eval_per_face(uint32_t)
+     */
+    vector<regular_grid> eval_per_face(const surface_evaluator& evaluator, uint32_t res);
+
+    /**
+     * @brief Evaluates all faces of the given evaluator with the given resolution and passes the points to the
+     *        given sink.
+     *
+     * @see surface_evaluator::eval_per_face(uint32_t, eval_sink&)
+     */
+    void eval_per_face(const surface_evaluator& evaluator, uint32_t res, eval_sink& sink);
+
+    /**
+     * @brief Evaluates the given faces of the given evaluator with the given resolution.
+     *
+     * @see surface_evaluator::eval_faces(uint32_t, const vector<face_handle>&)
+     */
+    vector<regular_grid> eval_faces(const surface_evaluator& evaluator, uint32_t res, const vector<face_handle>& faces);
+
+    /**
+     * @brief Evaluates the given faces of the given evaluator with the given resolution and passes the points to the
+     *        given sink.
+     */
+    void eval_faces(
+        const surface_evaluator& evaluator,
+        uint32_t res,
+        const vector<face_handle>& faces,
+        eval_sink& sink
+    );
+
+    /**
+     * @brief Removes all grids from the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Changes the max number of bytes used by the grids and evicts grids, which don't fit anymore.
+     */
+    void set_max_bytes(size_t max_bytes);
+
+    /**
+     * @brief Returns the number of bytes used by the cached grids.
+     */
+    size_t get_size_bytes() const { return grids.get_size(); }
+
+    /**
+     * @brief Returns the number of faces, which were found in the cache.
+     */
+    size_t num_hits() const { return hits; }
+
+    /**
+     * @brief Returns the number of faces, which had to be evaluated.
+     */
+    size_t num_misses() const { return misses; }
+
+private:
+    lru_cache<eval_cache_key, regular_grid, eval_cache_key_hash> grids;
+    size_t hits;
+    size_t misses;
+    /// Holds the last evaluated grid, if it doesn't fit into the cache.
+    vector<regular_grid> evaluated;
+
+    /**
+     * @brief Returns the grid of the given face from the cache or evaluates and caches it. Returns nullptr, if the
+     *        face can't be evaluated.
+     */
+    const regular_grid* eval_face(const surface_evaluator& evaluator, uint32_t res, face_handle handle);
+};
+
+}
+
+#endif //TSL_EVAL_CACHE_HPP
@@ -0,0 +1,55 @@
+#ifndef TSL_EVAL_SINK_HPP
+#define TSL_EVAL_SINK_HPP
+
+#include <vector>
+
+#include "tsl/grid.hpp"
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief Receives the points of an evaluated surface face by face.
+ *
+ * This allows to write the evaluated points directly into their final destination (e.g. a buffer, which is uploaded
+ * to the GPU) instead of collecting them in `regular_grid`s first.
+ */
+class eval_sink {
+public:
+    virtual ~eval_sink() = default;
+
+    /**
+     * @brief Is called before the points of the given face are added. The face is evaluated on a regular grid with
+     *        `num_points_x` * `num_points_y` points.
+     */
+    virtual void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) = 0;
+
+    /**
+     * @brief Adds the point at the given grid position of the current face. The points are added row by row.
+     */
+    virtual void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) = 0;
+};
+
+/**
+ * @brief Collects the evaluated faces as `regular_grid`s.
+ */
+class grid_sink : public eval_sink {
+public:
+    /**
+     * @brief Appends every evaluated face to the given vector.
+     */
+    explicit grid_sink(vector<regular_grid>& grids) : grids(grids) {}
+
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override;
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override;
+
+private:
+    vector<regular_grid>& grids;
+};
+
+}
+
+#endif //TSL_EVAL_SINK_HPP
@@ -1,12 +1,16 @@
 #ifndef TSL_SUBDEVISION_HPP
 #define TSL_SUBDEVISION_HPP
 
+#include <array>
+#include <mutex>
 #include <vector>
 
 #include "tsl/geometry/tmesh/handles.hpp"
 #include "tsl/attrmaps/stable_vector.hpp"
 
+using std::array;
 using std::vector;
+using std::once_flag;
 
 namespace tsl {
 
@@ -38,15 +42,20 @@ class eigen_handle : public base_handle<index> {
 /**
  * @brief A cache for the eigen_struct, which is loaded from the files in the `eigenvalues` folder. The key of
  * this cache is the valence of a vertex and the value of the key is the loaded eigen_struct.
+ *
+ * The cache is shared by all threads evaluating surfaces. Each valence is loaded once, afterwards `get` doesn't lock.
  */
 class eigen_cache {
 public:
-    eigen_cache() : cache(MAX_VALENCE, eigen_struct()) {}
+    /// The valences are used as indices and `MAX_VALENCE` is a valid valence.
+    eigen_cache() : cache(MAX_VALENCE + 1, eigen_struct()) {}
     const eigen_struct& get(eigen_handle handle);
 
 private:
     static eigen_struct load(index valence);
     stable_vector<eigen_handle, eigen_struct> cache;
+    /// Marks the loaded entries of `cache`. If loading a valence fails, it's loaded again on the next call.
+    array<once_flag, MAX_VALENCE + 1> loaded;
 };
 
 /**
@@ -0,0 +1,229 @@
+#ifndef TSL_SURFACE_BVH_HPP
+#define TSL_SURFACE_BVH_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/geometry/box.hpp"
+#include "tsl/geometry/line.hpp"
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/grid.hpp"
+
+using std::optional;
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the intersection of a ray with the evaluated surface.
+ */
+struct surface_hit {
+    /// The face, which was hit.
+    face_handle face;
+    /// The hit position in the grid of the face, normalized to [0, 1] in both directions.
+    vec2 uv;
+    /// The hit point.
+    vec3 point;
+    /// The parameter of the hit point on the ray.
+    double t;
+
+    surface_hit(face_handle face, const vec2& uv, const vec3& point, double t)
+        : face(face), uv(uv), point(point), t(t) {}
+};
+
+/**
+ * @brief Bounding volume hierarchy over the triangles of the evaluated grids of a surface.
+ *
+ * The hierarchy is built over the faces. The bounding box of a face contains its control vertices (see
+ * `surface_evaluator::get_control_vertices`) and its grid points. Inside a face the triangles of the grid are tested
+ * directly. The triangles are the same as the ones rendered by the editor.
+ */
+class surface_bvh {
+public:
+    /**
+     * @brief Creates an empty hierarchy.
+     */
+    surface_bvh() = default;
+
+    /**
+     * @brief Builds the hierarchy over the given grids, which were evaluated by the given evaluator.
+     */
+    surface_bvh(const surface_evaluator& evaluator, const vector<regular_grid>& grids);
+
+    /**
+     * @brief Builds the hierarchy over grids, whose points are stored one after another in `grid_points`. The grid of
+     *        `handles[i]` has `sizes[i]` points in both directions and its points are stored row by row.
+     *
+     * This avoids copying the points into `regular_grid`s, if they are already stored in one buffer.
+     */
+    surface_bvh(
+        const surface_evaluator& evaluator,
+        const vector<face_handle>& handles,
+        const vector<size_t>& sizes,
+        vector<vec3>&& grid_points
+    );
+
+    /**
+     * @brief Replaces the grids of the faces, which are contained in the given grids, and updates the bounding boxes
+     *        of these faces and their ancestors. The structure of the hierarchy is kept.
+     *
+     * This is meant to be called with the grids of `surface_evaluator::get_affected_faces` after moving vertices.
+     * Grids of faces, which are not contained in the hierarchy, are ignored.
+     */
+    void refit(const surface_evaluator& evaluator, const vector<regular_grid>& grids);
+
+    /**
+     * @brief Like `refit` above, but the grids of the given faces are stored one after another in `grid_points` like
+     *        in the constructor for packed grids. All faces have to be contained in the hierarchy and keep the size of
+     *        their grids.
+     */
+    void refit(
+        const surface_evaluator& evaluator,
+        const vector<face_handle>& handles,
+        const vector<vec3>& grid_points
+    );
+
+    /**
+     * @brief Returns the first intersection of the given ray with the surface. The ray starts at the support vector
+     *        of the line and points along its normal.
+     */
+    optional<surface_hit> intersect(const line& ray) const;
+
+    /**
+     * @brief Returns the intersection of the line segment between the given points with the surface, which is closest
+     *        to `start`.
+     */
+    optional<surface_hit> intersect(const vec3& start, const vec3& end) const;
+
+    /**
+     * @brief Returns the first intersection of the given line with the surface within the parameter range
+     *        [t_min, t_max].
+     */
+    optional<surface_hit> intersect(const line& line, double t_min, double t_max) const;
+
+    /**
+     * @brief Returns the point on the triangles of the surface, which is closest to the given point. The distance
+     *        between both points is stored in `t` of the returned hit.
+     */
+    optional<surface_hit> closest_point(const vec3& point) const;
+
+    /**
+     * @brief Returns the closest point on the triangles of each face, whose bounding box is closer than `max_dist` to
+     *        the given point. The distances are stored in `t` of the returned hits.
+     *
+     * Since the bounding box of a face contains its control vertices, it also contains the exact surface of the face.
+     * Thus all faces, whose exact surface is closer than `max_dist`, are returned.
+     */
+    vector<surface_hit> closest_points(const vec3& point, double max_dist) const;
+
+    /**
+     * @brief Returns the number of faces in the hierarchy.
+     */
+    size_t num_faces() const;
+
+    /**
+     * @brief Returns the bounding box of the whole surface.
+     */
+    aa_box get_bounds() const;
+
+private:
+    /// A face with its grid.
+    struct face_entry {
+        face_handle handle;
+        /// Index of the first point of the grid in `points`.
+        size_t first_point;
+        size_t num_points_x;
+        size_t num_points_y;
+        aa_box bounds;
+
+        face_entry(face_handle handle, size_t first_point, size_t num_points_x, size_t num_points_y)
+            : handle(handle), first_point(first_point), num_points_x(num_points_x), num_points_y(num_points_y) {}
+    };
+
+    /// A node of the hierarchy. Nodes are stored in depth first order, thus the left child directly follows its parent.
+    struct node {
+        aa_box bounds;
+        /// Index of the right child for inner nodes, index of the first face in `face_order` for leaves.
+        uint32_t first;
+        /// Number of faces for leaves, 0 for inner nodes.
+        uint32_t count;
+        /// Index of the parent node. The root is its own parent.
+        uint32_t parent;
+
+        node() : first(0), count(0), parent(0) {}
+    };
+
+    /// Max number of faces in a leaf.
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    /// The faces sorted by their handles.
+    vector<face_entry> faces;
+    /// The grid points of all faces, stored row by row.
+    vector<vec3> points;
+    /// Indices into `faces` in the order they are referenced by the leaves.
+    vector<uint32_t> face_order;
+    /// The leaf of each face.
+    vector<uint32_t> face_leaves;
+    /// All nodes, the root is the first one.
+    vector<node> nodes;
+
+    /**
+     * @brief Sorts the faces, calculates their bounding boxes and builds the hierarchy over them.
+     */
+    void build_hierarchy(const surface_evaluator& evaluator);
+
+    /**
+     * @brief Returns the index of the given face in `faces` or none, if the face is not contained.
+     */
+    optional<size_t> find_face(face_handle handle) const;
+
+    /**
+     * @brief Updates the bounding box of the given face, whose points were replaced, and marks the nodes on the path
+     *        to the root in `dirty`.
+     */
+    void refit_face(const surface_evaluator& evaluator, size_t face, vector<bool>& dirty);
+
+    /**
+     * @brief Recalculates the bounding boxes of all nodes, which are marked in `dirty`.
+     */
+    void update_dirty_nodes(const vector<bool>& dirty);
+
+    /**
+     * @brief Builds the subtree over `face_order[first, first + count)` and returns the index of its root.
+     */
+    uint32_t build(uint32_t first, uint32_t count, uint32_t parent);
+
+    /**
+     * @brief Calculates the bounding box of the given face from its control vertices and grid points.
+     */
+    aa_box calc_face_bounds(const surface_evaluator& evaluator, const face_entry& face) const;
+
+    /**
+     * @brief Recalculates the bounding box of the given node from its children or faces.
+     */
+    void update_node_bounds(uint32_t idx);
+
+    /**
+     * @brief Intersects the line with the triangles of the given face and updates `closest`, if a closer hit is found.
+     */
+    void intersect_face(
+        const line& line,
+        double t_min,
+        double t_max,
+        const face_entry& face,
+        optional<surface_hit>& closest
+    ) const;
+
+    /**
+     * @brief Searches the point on the triangles of the given face, which is closest to `point` and updates
+     *        `closest`, if it is closer than the current one.
+     */
+    void closest_point_face(const vec3& point, const face_entry& face, optional<surface_hit>& closest) const;
+};
+
+}
+
+#endif //TSL_SURFACE_BVH_HPP
@@ -1,15 +1,29 @@
 #ifndef TSL_SURFACE_HPP
 #define TSL_SURFACE_HPP
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <set>
 #include <utility>
 #include <tuple>
 
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
+#include "tsl/algorithm/reduction.hpp"
 #include "tsl/geometry/rectangle.hpp"
 #include "tsl/attrmaps/attr_maps.hpp"
 #include "tsl/geometry/transform.hpp"
 #include "tsl/geometry/tmesh/tmesh.hpp"
+#include "tsl/geometry/tmesh/frozen_tmesh.hpp"
 #include "tsl/grid.hpp"
+#include "tsl/evaluation/eval_sink.hpp"
+#include "tsl/util/memory_report.hpp"
+#include "tsl/util/stage_observer.hpp"
 
+using std::array;
+using std::atomic;
+using std::set;
 using std::tuple;
 using std::move;
 
@@ -25,12 +39,44 @@ enum class tag {
 
 /**
  * @brief POD type to hold the knot vectors of a basis function.
+ *
+ * The knot vectors of a basis function of degree 3 always consist of 5 knots, so they are stored inline.
  */
 struct local_knot_vectors {
-    vector<double> u;
-    vector<double> v;
+    array<double, 5> u;
+    array<double, 5> v;
+};
 
-    local_knot_vectors(vector<double>&& u, vector<double>&& v): u(move(u)), v(move(v)) {}
+/**
+ * @brief POD type to hold a basis function which is part of the support of a face.
+ */
+struct support_entry {
+    /// The vertex the basis function belongs to.
+    vertex_handle vertex;
+    /// The index of the basis function at its vertex.
+    index handle_index;
+    /// The index of the basis function in the packed values of the basis function maps (e.g. the knot vectors).
+    index basis_fun;
+    /// Transformation from the local coord system of the face into the domain of the basis function.
+    transform trans;
+
+    support_entry(vertex_handle vertex, index handle_index, index basis_fun, const transform& trans)
+        : vertex(vertex), handle_index(handle_index), basis_fun(basis_fun), trans(trans) {}
+};
+
+/**
+ * @brief POD type to hold a half edge of a face with the coords of its source and target in the face. The coords are
+ *        normalized to [0, 1] in both directions (see `surface_evaluator::eval_point`).
+ */
+struct face_segment {
+    half_edge_handle handle;
+    /// The side of the face, which contains the half edge: 0 = (v = 0), 1 = (u = 1), 2 = (v = 1), 3 = (u = 0).
+    uint8_t side;
+    vec2 start;
+    vec2 end;
+
+    face_segment(half_edge_handle handle, uint8_t side, const vec2& start, const vec2& end)
+        : handle(handle), side(side), start(start), end(end) {}
 };
 
 /**
@@ -39,7 +85,14 @@ struct local_knot_vectors {
 struct evaluator_config {
     bool panic_at_integrity_violations;
 
-    evaluator_config() : panic_at_integrity_violations(false) {}
+    /// Max number of threads used to build the cache. 0 means "use all available hardware threads".
+    size_t num_threads;
+
+    /// Is notified about the stages of building the cache (see `surface_evaluator::update_cache`), if not nullptr.
+    /// The stages are named like the functions running them, e.g. "local_coords" for `calc_local_coords`.
+    stage_observer* observer;
+
+    evaluator_config() : panic_at_integrity_violations(false), num_threads(0), observer(nullptr) {}
 };
 
 /// uv coords of half edges
@@ -49,13 +102,19 @@ using dir_map = dense_half_edge_map<uint8_t>;
 /// t(h) transforms of half edges from one local coord system to another
 using edge_trans_map = dense_half_edge_map<transform>;
 /// t(J^a_i) transforms from the local coord system to the domain system
-using basis_fun_trans_map = dense_vertex_map<vector<transform>>;
+using basis_fun_trans_map = csr_vertex_map<transform>;
 /// J^a_i handles of basis functions
-using basis_fun_map = dense_vertex_map<vector<tuple<half_edge_handle, tag>>>;
+using basis_fun_map = csr_vertex_map<tuple<half_edge_handle, tag>>;
 /// k^a_i,{1,2} knots of basis functions of vertices
-using knot_map = dense_vertex_map<vector<array<double, 2>>>;
+using knot_map = csr_vertex_map<array<double, 2>>;
+/// local knot vectors of basis functions of vertices
+using knot_vector_map = csr_vertex_map<local_knot_vectors>;
 /// C_m support for each face
-using support_map = dense_face_map<vector<tuple<vertex_handle, index, transform>>>;
+using support_map = csr_face_map<support_entry>;
+/// faces, whose surface depends on the position of a vertex
+using dependent_faces_map = csr_vertex_map<face_handle>;
+/// versions of the surface of faces
+using face_version_map = dense_face_map<uint64_t>;
 
 /**
  * @brief Evaluates the surface of a tmesh.
@@ -70,6 +129,11 @@ public:
      */
     explicit surface_evaluator(tmesh&& mesh);
 
+    /**
+     * @brief ctor which takes a given tmesh and the config to use.
+     */
+    surface_evaluator(tmesh&& mesh, evaluator_config config);
+
     surface_evaluator(const surface_evaluator&) = delete;
     surface_evaluator(surface_evaluator&& evaluator) = default;
     surface_evaluator& operator=(const surface_evaluator&) = delete;
@@ -84,6 +148,59 @@ public:
      */
     vector<regular_grid> eval_per_face(uint32_t res) const;
 
+    /**
+     * @brief Evaluates the surface per face with the given resolution and stops early, as soon as `cancelled` is set.
+     *
+     * `cancelled` is checked before each face, so it can be set from another thread to abort a running evaluation.
+     * If the evaluation was aborted, the returned grids are incomplete and should be discarded.
+     */
+    vector<regular_grid> eval_per_face(uint32_t res, const atomic<bool>& cancelled) const;
+
+    /**
+     * @brief Evaluates the surface per face with the given resolution and passes the points to the given sink
+     *        instead of collecting them in grids.
+     */
+    void eval_per_face(uint32_t res, eval_sink& sink) const;
+
+    /**
+     * @brief Like `eval_per_face(uint32_t, eval_sink&)`, but stops early, as soon as `cancelled` is set.
+     *
+     * @see eval_per_face(uint32_t, const atomic<bool>&)
+     */
+    void eval_per_face(uint32_t res, eval_sink& sink, const atomic<bool>& cancelled) const;
+
+    /**
+     * @brief Evaluates only the given faces with the given resolution. The grids are returned in the same order as
+     *        the faces, faces which can't be evaluated are skipped like in `eval_per_face`.
+     */
+    vector<regular_grid> eval_faces(uint32_t res, const vector<face_handle>& faces) const;
+
+    /**
+     * @brief Evaluates only the given faces with the given resolution and passes the points to the given sink.
+     */
+    void eval_faces(uint32_t res, const vector<face_handle>& faces, eval_sink& sink) const;
+
+    /**
+     * @brief Evaluates only the given face with the given resolution and passes the points to the given sink. This
+     *        allows to evaluate each face with a different resolution. If the face can't be evaluated, nothing is
+     *        passed to the sink.
+     */
+    void eval_face(uint32_t res, face_handle handle, eval_sink& sink) const;
+
+    /**
+     * @brief Returns all faces (in ascending order), whose surface changes, if the given vertices are moved.
+     *
+     * These are the faces, which contain a basis function of one of the vertices in their support, or which are
+     * evaluated by subdevision and use one of the vertices as control point.
+     */
+    vector<face_handle> get_affected_faces(const set<vertex_handle>& vertices) const;
+
+    /**
+     * @brief Writes the vertices, whose positions define the surface of the given face, into `out`. Faces, which
+     *        can't be evaluated, have no control vertices.
+     */
+    void get_control_vertices(face_handle handle, vector<vertex_handle>& out) const;
+
     /**
      * @brief Evaluates the surface of the given face with the given resolution using b-spline basis functions.
      */
@@ -99,34 +216,112 @@ public:
      */
     regular_grid eval_subdevision(uint32_t res, face_handle handle) const;
 
+    /**
+     * @brief Evaluates the given point of the given face and returns it with its derivatives by u and v as
+     *        (point, du, dv).
+     *
+     * In contrast to `eval_bsplines_point` the point is given by coords normalized to [0, 1] in both directions, like
+     * the grids returned by `eval_per_face`. Faces with extraordinary vertices are evaluated by subdevision. Panics,
+     * if the face contains a vertex with invalid valence.
+     */
+    array<vec3, 3> eval_point(face_handle handle, const vec2& uv) const;
+
     /**
      * @brief The max u and v coordinates for the local system of the given face returned as (u, v).
      */
     vec2 get_max_coords(face_handle handle) const;
 
+    /**
+     * @brief Returns the half edges of the given face in their order in the face with their position in the
+     *        normalized coords used by `eval_point`. A side of the face contains more than one half edge, if there
+     *        are T-junctions on it. Returns nothing, if the face is evaluated by subdevision, but is not a quad.
+     */
+    vector<face_segment> get_face_segments(face_handle handle) const;
+
+    /**
+     * @brief Returns the version of the surface of the given face. The version changes, whenever the surface of the
+     *        face changes, so it can be used to detect outdated copies of evaluated faces (see `eval_cache`).
+     *
+     * Moving a vertex gives all faces depending on it a new version. Changing the structure of the mesh gives a new
+     * version to all faces, whose control vertices, knot vectors or local coords changed. Versions are unique across
+     * all evaluators, so copies of faces of different evaluators can't be mixed up. Returns 0 for unknown faces.
+     */
+    uint64_t get_face_version(face_handle handle) const;
+
+    /**
+     * @brief Returns the memory used by the tmesh ("mesh/..."), its frozen snapshot ("frozen/...") and each cache of
+     *        this evaluator.
+     */
+    memory_usage_report memory_report() const;
+
     /**
      * @brief Returns the used tmesh.
      */
     const tmesh& get_tmesh() const;
 
+    /**
+     * @brief Returns the snapshot of the tmesh, which is evaluated. It only differs from `get_tmesh` during an edit
+     *        transaction (see `begin_edits`).
+     */
+    const frozen_tmesh& get_frozen_tmesh() const;
+
     // ========================================================================
     // = T-Mesh modifier
     // ========================================================================
 
     /**
-     * @see remove_edges(tmesh&, double)
+     * @brief Starts an edit transaction. Until the matching `commit_edits`, removing edges doesn't update the caches,
+     *        so any number of edits only needs one update.
+     *
+     * Until then the evaluation still uses the surface from before the transaction (with moved vertices, see
+     * `set_vertex_pos`), while `get_tmesh` already returns the edited mesh. Transactions can be nested, only the
+     * outermost one updates the caches.
+     */
+    void begin_edits();
+
+    /**
+     * @brief Ends the edit transaction started by the last `begin_edits`. Ending the outermost transaction updates
+     *        the caches once, if the structure of the mesh changed during the transaction.
+     */
+    void commit_edits();
+
+    /**
+     * @brief Returns true, if an edit transaction is open (see `begin_edits`).
+     */
+    bool is_editing() const;
+
+    /**
+     * @brief Removes edges like `remove_edges(tmesh&, double)` and updates the caches, if no edit transaction is open.
      */
     size_t remove_edges(double percent);
 
     /**
-     * @see tmesh::remove_edge(edge_handle)
+     * @brief Removes edges like `remove_edges(tmesh&, const batch_reduction_config&)` and updates the caches once
+     *        afterwards, if no edit transaction is open.
+     */
+    size_t remove_edges_batch(const batch_reduction_config& config);
+
+    /**
+     * @brief Removes the given edge like `tmesh::remove_edge(edge_handle, bool)` and updates the caches, if no edit
+     *        transaction is open. Within a transaction the distances to extraordinary vertices are only computed once
+     *        (see `extraordinary_distance_field`).
      */
     bool remove_edge(edge_handle handle, bool keep_vertices = true);
 
     /**
      * @see tmesh::get_vertex_position(vertex_handle)
      */
-    vec3& get_vertex_pos(vertex_handle handle);
+    vec3 get_vertex_pos(vertex_handle handle) const;
+
+    /**
+     * @brief Moves the given vertex to the given position. This doesn't change the structure of the mesh, thus the
+     *        caches don't need to be updated. Only the faces depending on the vertex get a new version.
+     *
+     * Within an edit transaction the vertex may already be removed from the tmesh by `remove_edge`, while the
+     * snapshot still evaluates it. Then only the snapshot is moved. The position is dropped with the vertex, when the
+     * transaction is committed.
+     */
+    void set_vertex_pos(vertex_handle handle, const vec3& pos);
 
     /// The current config of the evaluator.
     evaluator_config config;
@@ -139,7 +334,7 @@ public:
     /**
      * @brief Returns the knot vectors.
      */
-    const dense_vertex_map<vector<local_knot_vectors>>& get_knot_vectors() const { return knot_vectors; }
+    const knot_vector_map& get_knot_vectors() const { return knot_vectors; }
 
     /**
      * @brief Returns the local coords map.
@@ -156,9 +351,19 @@ public:
      */
     const edge_trans_map& get_edge_trans_map() const { return edge_trans; }
 
+    /**
+     * @brief Returns the faces depending on each vertex.
+     */
+    const dependent_faces_map& get_dependent_faces() const { return dependent_faces; }
+
 private:
+    /// Local coords closer than this to the border of a face are snapped onto it (see `get_face_segments`).
+    static constexpr double SNAP_EPSILON = 1e-9;
+
     /// Used tmesh.
     tmesh mesh;
+    /// Snapshot of the used tmesh, which is used for building the caches and for evaluation.
+    frozen_tmesh frozen;
     /// uv coords map
     coord_map uv;
     /// direction map
@@ -172,7 +377,24 @@ private:
     /// basis function handles
     basis_fun_map handles;
     /// local knot vectors of vertices
-    dense_vertex_map<vector<local_knot_vectors>> knot_vectors;
+    knot_vector_map knot_vectors;
+    /// faces depending on vertices
+    dependent_faces_map dependent_faces;
+    /// versions of the surface of faces
+    face_version_map face_versions;
+    /// hashes of everything the surface of a face depends on except the positions of the vertices
+    dense_face_map<size_t> face_fingerprints;
+
+    /// Number of open edit transactions (see `begin_edits`).
+    uint32_t edit_depth;
+    /// True, if the structure of the mesh changed during the open edit transaction.
+    bool edited_structure;
+    /// Distances to extraordinary vertices for `remove_edge` during the open edit transaction. It is built by the
+    /// first removed edge.
+    optional<extraordinary_distance_field> edit_field;
+
+    /// The next unused face version. It is shared by all evaluators, so that versions are unique.
+    inline static atomic<uint64_t> next_version{1};
 
     // TODO: this will be removed, when evaluation near borders is implemented
     inline static const string EXPECT_NO_BORDER = "tried to determine support of basis functions for border face - this is not implemented!";
@@ -186,6 +408,34 @@ private:
      */
     vector<vertex_handle> get_vertices_for_subd(face_handle handle) const;
 
+    /**
+     * @brief Collects the coords of the control points for subdevision surface evaluation of the given face and
+     *        returns the valence of its extraordinary vertex.
+     */
+    size_t get_subd_control_points(
+        face_handle handle,
+        vector<double>& x_coords,
+        vector<double>& y_coords,
+        vector<double>& z_coords
+    ) const;
+
+    /**
+     * @brief Evaluates the given face and passes its points to `sink`. Faces with invalid valences are skipped.
+     *
+     * @param vertices_buffer Buffer for the vertices of the face, which is reused between calls to save allocations.
+     */
+    void eval_face(uint32_t res, face_handle handle, vector<vertex_handle>& vertices_buffer, eval_sink& sink) const;
+
+    /**
+     * @brief Evaluates the given face with b-spline basis functions and passes the points to the given sink.
+     */
+    void eval_bsplines(uint32_t res, face_handle handle, eval_sink& sink) const;
+
+    /**
+     * @brief Evaluates the given face with subdevision surface evaluation and passes the points to the given sink.
+     */
+    void eval_subdevision(uint32_t res, face_handle handle, eval_sink& sink) const;
+
     /**
      * @brief Returns the parametric domain for the given basis function handle represented as the vertex and the index
      *        as an axis aligned rectangle.
@@ -200,10 +450,22 @@ private:
     /**
      * @brief Updates the local cached values, because the mesh structure has changed.
      *
+     * First the tmesh is frozen again ("freeze"), all following stages only read the frozen snapshot. The stages are
+     * reported to `config.observer`.
+     *
+     * Every stage runs in parallel over its elements (faces, half edges, vertices or basis functions). The result
+     * does not depend on the number of threads used.
+     *
      * This could be updated to only update the cache for some values instead of updating the whole cache.
      */
     void update_cache();
 
+    /**
+     * @brief Updates the caches after the structure of the mesh changed or defers it until the open edit transaction
+     *        is committed.
+     */
+    void structure_changed();
+
     /**
      * @brief Depending on the configuration, print error or panic.
      */
@@ -237,6 +499,21 @@ private:
      * @brief C.5 (determine_support_of_basis_functions)
      */
     void calc_support(const basis_fun_trans_map& transforms);
+
+    /**
+     * @brief Inverts the support map (and the control points of subdevision faces) into the dependent faces map.
+     */
+    void calc_dependent_faces();
+
+    /**
+     * @brief Gives a new version to all faces, whose fingerprint changed since the last update.
+     */
+    void calc_face_versions();
+
+    /**
+     * @brief Hashes everything the surface of the given face depends on except the positions of the vertices.
+     */
+    size_t get_face_fingerprint(face_handle handle) const;
 };
 
 }
@@ -0,0 +1,85 @@
+#ifndef TSL_SURFACE_INTERSECTOR_HPP
+#define TSL_SURFACE_INTERSECTOR_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tsl/evaluation/surface_bvh.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/geometry/line.hpp"
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+
+using std::optional;
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the intersection of a ray with the limit surface.
+ */
+struct ray_hit {
+    /// The face, which was hit.
+    face_handle face;
+    /// The hit position in the face, normalized to [0, 1] in both directions (see `surface_evaluator::eval_point`).
+    vec2 uv;
+    /// The hit point.
+    vec3 point;
+    /// The normal of the surface at the hit point.
+    vec3 normal;
+    /// The parameter of the hit point on the ray.
+    double t;
+    /// True, if the newton iteration converged. Otherwise the hit is the intersection with the tessellation.
+    bool converged;
+
+    ray_hit(face_handle face, const vec2& uv, const vec3& point, const vec3& normal, double t, bool converged)
+        : face(face), uv(uv), point(point), normal(normal), t(t), converged(converged) {}
+};
+
+/**
+ * @brief Intersects rays with the limit surface of an evaluator.
+ *
+ * Each ray is first intersected with a tessellation of the surface (using a `surface_bvh`), which culls the faces by
+ * their bounds. The hit on the tessellation is then refined with newton iterations on the exact surface. Rays, which
+ * only hit the exact surface but miss the tessellation (e.g. at silhouettes), are not found, so the resolution of the
+ * tessellation should be chosen accordingly.
+ *
+ * The evaluator must not be changed while the intersector is used.
+ */
+class surface_intersector {
+public:
+    /**
+     * @brief Tessellates the surface of the given evaluator with the given resolution to seed the newton iterations.
+     */
+    explicit surface_intersector(const surface_evaluator& evaluator, uint32_t res = 8);
+
+    /**
+     * @brief Returns the first intersection of the given ray with the surface. The ray starts at the support vector
+     *        of the line and points along its normal.
+     */
+    optional<ray_hit> intersect(const line& ray) const;
+
+    /**
+     * @brief Intersects all given rays in parallel. The i-th result belongs to the i-th ray.
+     *
+     * @param max_threads The maximum number of threads to use. 0 means "use all available hardware threads".
+     */
+    vector<optional<ray_hit>> intersect(const vector<line>& rays, size_t max_threads = 0) const;
+
+private:
+    /// Max number of newton iterations per ray.
+    static constexpr int MAX_ITERATIONS = 16;
+    /// The iteration stops, if the distance between the surface point and the ray point is smaller than this
+    /// (relative to the size of the surface).
+    static constexpr double TOLERANCE = 1e-12;
+
+    const surface_evaluator& evaluator;
+    surface_bvh bvh;
+    /// Absolute tolerance of the newton iteration.
+    double tolerance;
+};
+
+}
+
+#endif //TSL_SURFACE_INTERSECTOR_HPP
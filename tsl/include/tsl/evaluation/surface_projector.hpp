@@ -0,0 +1,97 @@
+#ifndef TSL_SURFACE_PROJECTOR_HPP
+#define TSL_SURFACE_PROJECTOR_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tsl/evaluation/surface_bvh.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+
+using std::optional;
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the projection of a point onto the limit surface.
+ */
+struct surface_projection {
+    /// The face, which contains the closest point.
+    face_handle face;
+    /// The position of the closest point in the face, normalized to [0, 1] in both directions (see
+    /// `surface_evaluator::eval_point`).
+    vec2 uv;
+    /// The closest point on the surface.
+    vec3 point;
+    /// The normal of the surface at the closest point.
+    vec3 normal;
+    /// The distance between the projected point and the closest point.
+    double distance;
+    /// True, if the iteration converged. Otherwise the closest point found so far is returned.
+    bool converged;
+
+    surface_projection(
+        face_handle face,
+        const vec2& uv,
+        const vec3& point,
+        const vec3& normal,
+        double distance,
+        bool converged
+    ) : face(face), uv(uv), point(point), normal(normal), distance(distance), converged(converged) {}
+};
+
+/**
+ * @brief Projects points onto the limit surface of an evaluator.
+ *
+ * For each point the closest point on a tessellation of the surface is searched first (using a `surface_bvh`). This
+ * point is then refined with newton iterations on the exact surface of its face. If the refined point lies on
+ * the border of the face, the closest point may lie in a neighbouring face. In this case all faces, whose bounding box
+ * is closer than the refined point, are refined as well and the closest result is returned.
+ *
+ * The evaluator must not be changed while the projector is used.
+ */
+class surface_projector {
+public:
+    /**
+     * @brief Tessellates the surface of the given evaluator with the given resolution to seed the iterations.
+     */
+    explicit surface_projector(const surface_evaluator& evaluator, uint32_t res = 8);
+
+    /**
+     * @brief Returns the point on the surface, which is closest to the given point. Returns nothing, if the surface
+     *        is empty.
+     */
+    optional<surface_projection> project(const vec3& point) const;
+
+    /**
+     * @brief Projects all given points in parallel. The i-th result belongs to the i-th point.
+     *
+     * @param max_threads The maximum number of threads to use. 0 means "use all available hardware threads".
+     */
+    vector<optional<surface_projection>> project(const vector<vec3>& points, size_t max_threads = 0) const;
+
+private:
+    /// Max number of iterations per point.
+    static constexpr int MAX_ITERATIONS = 32;
+    /// The iteration stops, if the step on the surface is shorter than this (relative to the size of the surface).
+    static constexpr double TOLERANCE = 1e-12;
+    /// Step in the parameter domain to calculate the second derivatives of the surface.
+    static constexpr double DIFF_STEP = 1e-6;
+
+    const surface_evaluator& evaluator;
+    surface_bvh bvh;
+    /// Absolute tolerance of the iteration.
+    double tolerance;
+
+    /**
+     * @brief Searches the closest point to `point` on the given face with newton iterations starting at `start`.
+     */
+    surface_projection refine(const vec3& point, face_handle face, const vec2& start) const;
+};
+
+}
+
+#endif //TSL_SURFACE_PROJECTOR_HPP
@@ -0,0 +1,60 @@
+#ifndef TSL_TESSELLATION_HPP
+#define TSL_TESSELLATION_HPP
+
+#include <cstdint>
+
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/triangle_mesh.hpp"
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the tolerances of the adaptive tessellation.
+ */
+struct tessellation_config {
+    /// Max distance between the surface and the triangles, which is checked at the midpoints of the cells and
+    /// their sides.
+    double max_chord_error;
+    /// Max angle (in radians) between the normal at the midpoint of a cell and the normals at its corners.
+    double max_normal_angle;
+    /// Max number of times a face is split in each direction, so it is split into at most `4^max_depth` cells.
+    uint32_t max_depth;
+
+    tessellation_config() : max_chord_error(1e-3), max_normal_angle(0.2), max_depth(6) {}
+};
+
+/**
+ * @brief Tessellates the surface of the given evaluator adaptively into a single indexed triangle mesh.
+ *
+ * The parameter domain of each face is split into a quadtree until all cells meet the tolerances of the config.
+ * Flat regions are thus covered by few large triangles, while curved regions are refined.
+ *
+ * The edges of the tmesh are sampled consistently for both adjacent faces: the samples requested by either face are
+ * merged and shared by index, which also works across T-junctions. Thus the resulting mesh has no cracks and every
+ * vertex on an edge or a corner of the tmesh is evaluated and contained only once. Faces, which can't be evaluated
+ * (see `surface_evaluator::eval_per_face`), are skipped.
+ *
+ * @param max_threads The maximum number of threads to use. 0 means "use all available hardware threads".
+ */
+triangle_mesh tessellate_adaptive(
+    const surface_evaluator& evaluator,
+    const tessellation_config& config = tessellation_config(),
+    size_t max_threads = 0
+);
+
+/**
+ * @brief Tessellates the surface of the given evaluator into a single watertight indexed triangle mesh, in which every
+ *        face is sampled like the grids of `surface_evaluator::eval_per_face` with the given resolution.
+ *
+ * In contrast to the grids, the samples on the edges and corners of the tmesh are evaluated only once and shared by
+ * the adjacent faces. At T-junctions the samples of both faces on an edge usually differ. Then all of them are
+ * shared and the cells at the border of the face, which get additional vertices on their sides, are triangulated as
+ * fan around their center. Returns an empty mesh for a resolution of 0.
+ *
+ * @param max_threads The maximum number of threads to use. 0 means "use all available hardware threads".
+ */
+triangle_mesh tessellate_uniform(const surface_evaluator& evaluator, uint32_t res, size_t max_threads = 0);
+
+}
+
+#endif //TSL_TESSELLATION_HPP
@@ -0,0 +1,67 @@
+#ifndef TSL_BOX_HPP
+#define TSL_BOX_HPP
+
+#include <optional>
+
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/line.hpp"
+
+using std::optional;
+
+namespace tsl {
+
+/**
+ * @brief Represents a 3d axis aligned box.
+ */
+struct aa_box {
+    vec3 min_corner;
+    vec3 max_corner;
+
+    /**
+     * @brief Creates an empty box, which contains no point.
+     */
+    aa_box();
+
+    /**
+     * @brief Creates a 3d axis aligned box from the given points.
+     * @param p1 One corner of the box.
+     * @param p2 The opposite corner of the box.
+     */
+    aa_box(const vec3& p1, const vec3& p2);
+
+    /**
+     * @brief Returns true, if the box contains no point.
+     */
+    bool is_empty() const;
+
+    /**
+     * @brief Returns the center of the box.
+     */
+    vec3 get_center() const;
+
+    /**
+     * @brief Grows the box, so that it contains the given point.
+     */
+    void extend(const vec3& point);
+
+    /**
+     * @brief Grows the box, so that it contains the given box.
+     */
+    void extend(const aa_box& box);
+
+    /**
+     * @brief Returns the squared distance between the given point and this box. The distance is 0 for points inside
+     * the box.
+     */
+    double squared_distance(const vec3& point) const;
+
+    /**
+     * @brief Calculates the parameter of the point, where the given line enters this box, if the line intersects the
+     * box within the parameter range [t_min, t_max]. The parameter is clamped to t_min, if the line starts inside.
+     */
+    optional<double> intersect(const line& line, double t_min, double t_max) const;
+};
+
+}
+
+#endif //TSL_BOX_HPP
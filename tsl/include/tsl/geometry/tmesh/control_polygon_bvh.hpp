@@ -0,0 +1,183 @@
+#ifndef TSL_CONTROL_POLYGON_BVH_HPP
+#define TSL_CONTROL_POLYGON_BVH_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "tsl/attrmaps/attr_maps.hpp"
+#include "tsl/geometry/box.hpp"
+#include "tsl/geometry/line.hpp"
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+#include "tsl/geometry/tmesh/tmesh.hpp"
+
+using std::array;
+using std::optional;
+using std::set;
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold a vertex of the control polygon, which was picked by a ray.
+ */
+struct control_vertex_hit {
+    /// The picked vertex.
+    vertex_handle handle;
+    /// The position of the vertex.
+    vec3 point;
+    /// The parameter of the projection of the vertex onto the ray.
+    double t;
+
+    control_vertex_hit(vertex_handle handle, const vec3& point, double t) : handle(handle), point(point), t(t) {}
+};
+
+/**
+ * @brief POD type to hold an edge of the control polygon, which was picked by a ray.
+ */
+struct control_edge_hit {
+    /// The picked edge.
+    edge_handle handle;
+    /// The point on the edge, which is closest to the ray.
+    vec3 point;
+    /// The parameter of the projection of `point` onto the ray.
+    double t;
+
+    control_edge_hit(edge_handle handle, const vec3& point, double t) : handle(handle), point(point), t(t) {}
+};
+
+/**
+ * @brief Bounding volume hierarchies over the vertices and the edges of the control polygon of a tmesh, which are
+ *        used to pick them with a ray in O(log n) instead of testing all of them.
+ *
+ * Vertices and edges are hit, if the ray passes them closer than a given radius. Of all hit elements the one with the
+ * smallest parameter on the ray is returned. If multiple elements have the same parameter, the one with the smallest
+ * handle is returned, which is the same as testing the elements in the order of `tmesh::get_vertices` and
+ * `tmesh::get_edges`.
+ */
+class control_polygon_bvh {
+public:
+    /**
+     * @brief Creates an empty hierarchy.
+     */
+    control_polygon_bvh() = default;
+
+    /**
+     * @brief Builds the hierarchies over all vertices and edges of the given mesh.
+     */
+    explicit control_polygon_bvh(const tmesh& mesh);
+
+    /**
+     * @brief Updates the positions of the given vertices from the given mesh and the bounding boxes of these vertices,
+     *        their edges and all of their ancestors. The structure of the hierarchies is kept, so the structure of the
+     *        mesh must not have changed since it was built.
+     */
+    void refit(const tmesh& mesh, const set<vertex_handle>& moved);
+
+    /**
+     * @brief Returns the vertex with the smallest non negative parameter on the given ray, which is closer than
+     *        `radius` to the ray. The normal of the ray has to be normalized.
+     */
+    optional<control_vertex_hit> pick_vertex(const line& ray, double radius) const;
+
+    /**
+     * @brief Returns the edge with the smallest parameter within [0, t_max] on the given ray, which is closer than
+     *        `radius` to the ray. The normal of the ray has to be normalized.
+     *
+     * The parameter of an edge is the one of the point on the edge, which is closest to the ray.
+     */
+    optional<control_edge_hit> pick_edge(const line& ray, double radius, double t_max) const;
+
+    /**
+     * @brief Returns the number of vertices in the hierarchy.
+     */
+    size_t num_vertices() const;
+
+    /**
+     * @brief Returns the number of edges in the hierarchy.
+     */
+    size_t num_edges() const;
+
+private:
+    /// A node of a hierarchy. Nodes are stored in depth first order, thus the left child directly follows its parent.
+    struct node {
+        aa_box bounds;
+        /// Index of the right child for inner nodes, index of the first element in `order` for leaves.
+        uint32_t first;
+        /// Number of elements for leaves, 0 for inner nodes.
+        uint32_t count;
+        /// Index of the parent node. The root is its own parent.
+        uint32_t parent;
+
+        node() : first(0), count(0), parent(0) {}
+    };
+
+    /// A hierarchy over the bounding boxes of elements.
+    struct hierarchy {
+        /// The bounding box of each element.
+        vector<aa_box> bounds;
+        /// Indices of the elements in the order they are referenced by the leaves.
+        vector<uint32_t> order;
+        /// The leaf of each element.
+        vector<uint32_t> leaves;
+        /// All nodes, the root is the first one.
+        vector<node> nodes;
+
+        /**
+         * @brief Builds the hierarchy over all elements in `bounds`.
+         */
+        void build();
+
+        /**
+         * @brief Builds the subtree over `order[first, first + count)` and returns the index of its root.
+         */
+        uint32_t build(uint32_t first, uint32_t count, uint32_t parent);
+
+        /**
+         * @brief Marks the nodes on the path from the leaf of the given element to the root in `dirty`.
+         */
+        void mark_dirty(uint32_t element, vector<bool>& dirty) const;
+
+        /**
+         * @brief Recalculates the bounding boxes of all nodes, which are marked in `dirty`.
+         */
+        void update_dirty_nodes(const vector<bool>& dirty);
+
+        /**
+         * @brief Recalculates the bounding box of the given node from its children or elements.
+         */
+        void update_node_bounds(uint32_t idx);
+    };
+
+    /// Max number of elements in a leaf.
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    /// The vertices in ascending order.
+    vector<vertex_handle> vertices;
+    /// The position of each vertex.
+    vector<vec3> positions;
+    /// The edges in ascending order.
+    vector<edge_handle> edges;
+    /// Indices of the two vertices of each edge in `vertices`.
+    vector<array<uint32_t, 2>> edge_vertices;
+    /// Index of each vertex in `vertices`.
+    dense_vertex_map<uint32_t> vertex_indices;
+    /// Index of each edge in `edges`.
+    dense_edge_map<uint32_t> edge_indices;
+    /// Hierarchy over the positions of the vertices.
+    hierarchy vertex_hierarchy;
+    /// Hierarchy over the edges.
+    hierarchy edge_hierarchy;
+
+    /**
+     * @brief Calculates the bounding box of the given edge from the positions of its vertices.
+     */
+    aa_box calc_edge_bounds(uint32_t edge) const;
+};
+
+}
+
+#endif //TSL_CONTROL_POLYGON_BVH_HPP
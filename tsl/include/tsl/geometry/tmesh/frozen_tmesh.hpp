@@ -0,0 +1,252 @@
+#ifndef TSL_FROZEN_TMESH_HPP
+#define TSL_FROZEN_TMESH_HPP
+
+#include <vector>
+#include <optional>
+
+#include "tsl/geometry/vector.hpp"
+#include "tsl/util/memory_report.hpp"
+#include "handles.hpp"
+#include "edge_direction.hpp"
+
+using std::vector;
+using std::optional;
+
+namespace tsl {
+
+// Forward declaration
+class tmesh;
+
+/**
+ * @brief A snapshot of a tmesh which is optimized for fast read access. Its structure is fixed, only the vertex
+ *        positions can still be changed (see `set_vertex_position`).
+ *
+ * The tmesh stores its elements in `stable_vector`s of structs with optional members. This snapshot stores every
+ * attribute in its own plain array instead (e.g. all `next` indices of all half edges are stored contiguously) and
+ * the vertex positions as separate x, y and z arrays. Following pointers therefore is a single array lookup.
+ *
+ * All handles of the tmesh are valid handles of the snapshot, too: the arrays are indexed by the same indices as the
+ * tmesh. Slots of deleted elements stay unused.
+ *
+ * The snapshot is not updated, when the tmesh changes. To get a snapshot of the changed tmesh, freeze it again.
+ */
+class frozen_tmesh {
+public:
+    /**
+     * @brief Creates an empty snapshot.
+     */
+    frozen_tmesh() = default;
+
+    /**
+     * @brief Creates a snapshot of the given tmesh in one pass over its elements.
+     */
+    explicit frozen_tmesh(const tmesh& mesh);
+
+    // ========================================================================
+    // = Get numbers
+    // ========================================================================
+
+    /**
+     * @brief Returns the number of vertices in the mesh.
+     */
+    size_t num_vertices() const;
+
+    /**
+     * @brief Returns the number of faces in the mesh.
+     */
+    size_t num_faces() const;
+
+    /**
+     * @brief Returns the number of half edges in the mesh.
+     */
+    size_t num_half_edges() const;
+
+    /**
+     * @brief Returns the highest index of all vertex handles + 1 (including deleted ones).
+     */
+    size_t vertex_index_bound() const;
+
+    /**
+     * @brief Returns the highest index of all face handles + 1 (including deleted ones).
+     */
+    size_t face_index_bound() const;
+
+    /**
+     * @brief Returns the highest index of all half edge handles + 1 (including deleted ones).
+     */
+    size_t half_edge_index_bound() const;
+
+    /**
+     * @see tmesh::get_valence(vertex_handle)
+     */
+    size_t get_valence(vertex_handle handle) const;
+
+    /**
+     * @see tmesh::get_extended_valence(vertex_handle)
+     */
+    size_t get_extended_valence(vertex_handle handle) const;
+
+    /**
+     * @see tmesh::is_extraordinary(vertex_handle)
+     */
+    bool is_extraordinary(vertex_handle handle) const;
+
+    // ========================================================================
+    // = Get attributes
+    // ========================================================================
+
+    /**
+     * @brief Get the position of the given vertex.
+     */
+    vec3 get_vertex_position(vertex_handle handle) const;
+
+    /**
+     * @brief Sets the position of the given vertex.
+     *
+     * This is the only attribute which can be changed, because it does not affect the structure of the mesh.
+     */
+    void set_vertex_position(vertex_handle handle, const vec3& pos);
+
+    /**
+     * @see tmesh::get_knot_interval(half_edge_handle)
+     */
+    optional<double> get_knot_interval(half_edge_handle handle) const;
+
+    /**
+     * @see tmesh::corner(half_edge_handle)
+     */
+    optional<bool> corner(half_edge_handle handle) const;
+
+    /**
+     * @see tmesh::from_corner(half_edge_handle)
+     */
+    optional<bool> from_corner(half_edge_handle handle) const;
+
+    /**
+     * @see tmesh::get_knot_factor(half_edge_handle)
+     */
+    optional<double> get_knot_factor(half_edge_handle handle) const;
+
+    // ========================================================================
+    // = Follow pointer
+    // ========================================================================
+
+    /**
+     * @brief Returns the twin of the requested half edge.
+     */
+    half_edge_handle get_twin(half_edge_handle handle) const;
+
+    /**
+     * @brief Returns the next half edge the given half edge points to.
+     */
+    half_edge_handle get_next(half_edge_handle handle) const;
+
+    /**
+     * @brief Returns the half edge which points to the given half edge.
+     */
+    half_edge_handle get_prev(half_edge_handle handle) const;
+
+    /**
+     * @brief Get handle of the vertex the given half edge handle points to.
+     */
+    vertex_handle get_target(half_edge_handle handle) const;
+
+    /**
+     * @brief Get handle of the half edge the given vertex points to.
+     */
+    optional_half_edge_handle get_out(vertex_handle handle) const;
+
+    /**
+     * @brief Get handle of the half edge the given face points to.
+     */
+    half_edge_handle get_edge(face_handle handle) const;
+
+    /**
+     * @brief Get the face of a half edge.
+     */
+    optional_face_handle get_face_of_half_edge(half_edge_handle handle) const;
+
+    // ========================================================================
+    // = Get elements around elements
+    // ========================================================================
+
+    /**
+     * @brief Adds the vertices surrounding the given face to the given vector in counter clockwise order.
+     */
+    void get_vertices_of_face(face_handle handle, vector<vertex_handle>& vertices_out) const;
+
+    /**
+     * @brief Get inner half edges of face in counter clockwise order.
+     */
+    vector<half_edge_handle> get_half_edges_of_face(face_handle handle) const;
+
+    /**
+     * @brief Get a list of half edges around the given vertex in clockwise order. If the edges are in or outgoing is
+     *        determined by the way parameter.
+     */
+    vector<half_edge_handle> get_half_edges_of_vertex(vertex_handle handle, edge_direction way = edge_direction::ingoing) const;
+
+    /**
+     * @brief If the two given faces are neighbours, the half edge between them (connected to ah) is returned.
+     */
+    optional_half_edge_handle get_half_edge_between(face_handle ah, face_handle bh) const;
+
+    // ========================================================================
+    // = Iterator helper
+    // ========================================================================
+
+    /**
+     * @brief Returns all vertex handles in ascending order.
+     */
+    const vector<vertex_handle>& get_vertices() const;
+
+    /**
+     * @brief Returns all face handles in ascending order.
+     */
+    const vector<face_handle>& get_faces() const;
+
+    /**
+     * @brief Returns all half edge handles in ascending order.
+     */
+    const vector<half_edge_handle>& get_half_edges() const;
+
+    /**
+     * @brief Returns the memory used by the arrays of the half edges, faces, vertices and the lists of handles.
+     */
+    memory_usage_report memory_report() const;
+
+private:
+    /// Marks a missing index (e.g. the face of a border half edge)
+    static constexpr index NONE = static_cast<index>(-1);
+    /// Marks a half edge without corner information (it has no face)
+    static constexpr uint8_t NO_CORNER = 2;
+
+    // Half edges
+    vector<index> edge_next;
+    vector<index> edge_prev;
+    vector<index> edge_target;
+    vector<index> edge_face;
+    vector<double> edge_knot;
+    vector<uint8_t> edge_has_knot;
+    vector<uint8_t> edge_corner;
+
+    // Faces
+    vector<index> face_edge;
+
+    // Vertices
+    vector<index> vertex_out;
+    vector<uint32_t> vertex_valence;
+    vector<uint32_t> vertex_extended_valence;
+    vector<double> pos_x;
+    vector<double> pos_y;
+    vector<double> pos_z;
+
+    // Handles of all existing elements
+    vector<vertex_handle> vertex_handles;
+    vector<face_handle> face_handles;
+    vector<half_edge_handle> half_edge_handles;
+};
+
+}
+
+#endif //TSL_FROZEN_TMESH_HPP
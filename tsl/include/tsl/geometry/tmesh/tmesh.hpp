@@ -8,6 +8,7 @@
 #include <optional>
 
 #include "tsl/attrmaps/stable_vector.hpp"
+#include "tsl/util/memory_report.hpp"
 #include "tsl/geometry/vector.hpp"
 #include "handles.hpp"
 #include "edge_direction.hpp"
@@ -32,6 +33,7 @@ class tmesh_face_iterator_proxy;
 class tmesh_half_edge_iterator_proxy;
 class tmesh_edge_iterator_proxy;
 class tmesh_vertex_iterator_proxy;
+class extraordinary_distance_field;
 
 /**
  * @brief This is an implementation of a T-Mesh based on a half edge mesh.
@@ -106,11 +108,68 @@ public:
      * @brief Removes the given edge and one of the two faces it seperades and returns true. Returns false, if the
      *        edge could not be deleted.
      *
+     * Edges are not removed, if an extraordinary vertex lies within `EXTRAORDINARY_RINGS` rings around both of their
+     * vertices (see `is_near_extraordinary_vertex`).
+     *
      * @param keep_vertices This indicates whether this method should remove edges pointing into a t-vertex and
      *        thus remove the vertex.
      */
     bool remove_edge(edge_handle handle, bool keep_vertices = true);
 
+    /**
+     * @brief Like `remove_edge(edge_handle, bool)`, but checks the distance of the edge to extraordinary vertices in
+     *        O(1) with the given field, which has to be built for this mesh. The field is updated after the edge is
+     *        removed, so it can be used to remove many edges (see `remove_edges`).
+     */
+    bool remove_edge(edge_handle handle, extraordinary_distance_field& field, bool keep_vertices = true);
+
+    /**
+     * @brief Returns true, if `remove_edge(edge_handle, extraordinary_distance_field&, bool)` would remove the given
+     *        edge.
+     */
+    bool can_remove_edge(
+        edge_handle handle,
+        const extraordinary_distance_field& field,
+        bool keep_vertices = true
+    ) const;
+
+    /**
+     * @brief Removes the given edges like `remove_edge(edge_handle, extraordinary_distance_field&, bool)` on up to
+     *        `max_threads` threads (0 means "use all available hardware threads") and returns the number of removed
+     *        edges.
+     *
+     * The edges have to be independent: the vertices of two different edges have to be at least four rings apart
+     * (see `extraordinary_distance_field`). Removing an edge only makes the vertices of its two faces neighbours, so
+     * it neither changes the faces around another edge nor brings an extraordinary vertex into its
+     * `EXTRAORDINARY_RINGS` rings. Thus the result is the same as removing the edges one after another in any order.
+     */
+    size_t remove_independent_edges(
+        const vector<edge_handle>& handles,
+        extraordinary_distance_field& field,
+        size_t max_threads = 0,
+        bool keep_vertices = true
+    );
+
+    /**
+     * @brief Renumbers all elements of the mesh, so that elements which are close in the mesh get close handles.
+     *
+     * The faces are ordered breadth first over the face adjacency (Cuthill-McKee order: neighbours with fewer
+     * neighbours come first). Vertices and edges are numbered in the order they are first reached while walking the
+     * faces in their new order. Slots of deleted elements are dropped, so the mesh is compact afterwards.
+     *
+     * The structure, positions, knots and corners of the mesh are not changed. Every face keeps its starting edge,
+     * thus the local coordinate system of each face stays the same.
+     *
+     * IMPORTANT: All handles into this mesh are invalidated by this method!
+     */
+    void reorder();
+
+    /**
+     * @brief Allocates storage for the given number of vertices, faces and edges (not half edges!) up front, so
+     *        building a mesh of known size doesn't reallocate.
+     */
+    void reserve(size_t num_vertices, size_t num_faces, size_t num_edges);
+
     // ========================================================================
     // = Get numbers
     // ========================================================================
@@ -135,6 +194,12 @@ public:
      */
     size_t num_half_edges() const;
 
+    /**
+     * @brief Returns the memory used by the half edges, faces and vertices of the mesh. Removed elements keep their
+     *        slots until `reorder` is called, they are reported as deleted.
+     */
+    memory_usage_report memory_report() const;
+
     /**
      * @brief Returns the number of adjacent faces to the given edge.
      *
@@ -161,6 +226,11 @@ public:
     // = Get attributes
     // ========================================================================
 
+    /**
+     * @brief Returns true, if the given vertex is part of the mesh, i.e. it was added and hasn't been removed since.
+     */
+    bool contains(vertex_handle handle) const;
+
     /**
      * @brief Get the position of the given vertex.
      */
@@ -546,6 +616,29 @@ private:
     vertex& get_v(vertex_handle handle);
     const vertex& get_v(vertex_handle handle) const;
 
+    /**
+     * @brief Handles of the elements removed by `try_remove_edge`, which are erased afterwards, because erasing
+     *        elements of the same `stable_vector` from multiple threads isn't thread safe.
+     */
+    struct removed_elements {
+        vector<half_edge_handle> half_edges;
+        vector<face_handle> faces;
+        vector<vertex_handle> vertices;
+    };
+
+    /**
+     * @brief Returns true, if `try_remove_edge` would remove the given edge.
+     */
+    bool is_removable(edge_handle handle, bool keep_vertices) const;
+
+    /**
+     * @brief Removes the given edge like `remove_edge`, but without checking its distance to extraordinary vertices.
+     *
+     * @param removed If not nullptr, the removed elements are only unlinked and added to it instead of being erased.
+     * @return The face, which was merged with the face of the removed edge, or none, if the edge couldn't be removed.
+     */
+    optional_face_handle try_remove_edge(edge_handle handle, bool keep_vertices, removed_elements* removed = nullptr);
+
     /**
      * @brief Attempts to find an edge between the given vertices and, if none
      *        is found, creates a new edge with `add_edge_pair()`
@@ -648,6 +741,7 @@ private:
     // = Friends
     // ========================================================================
     friend class tmesh_edge_iterator;
+    friend class frozen_tmesh;
 };
 
 }
@@ -0,0 +1,36 @@
+#ifndef TSL_TRIANGLE_MESH_HPP
+#define TSL_TRIANGLE_MESH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "tsl/geometry/vector.hpp"
+#include "tsl/geometry/tmesh/handles.hpp"
+
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief Represents an indexed triangle mesh, which approximates the surface of a tmesh.
+ */
+struct triangle_mesh {
+    /// Positions of the vertices.
+    vector<vec3> positions;
+    /// Normals of the surface at the vertices.
+    vector<vec3> normals;
+    /// Three vertex indices per triangle. The triangles are oriented counter clockwise in the parameter domain of
+    /// their face, so their normals point in the same direction as the normals of the surface.
+    vector<uint32_t> indices;
+    /// The face of the tmesh each triangle belongs to.
+    vector<face_handle> faces;
+
+    /**
+     * @brief Returns the number of triangles.
+     */
+    size_t num_triangles() const { return indices.size() / 3; }
+};
+
+}
+
+#endif //TSL_TRIANGLE_MESH_HPP
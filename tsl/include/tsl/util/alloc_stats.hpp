@@ -0,0 +1,70 @@
+#ifndef TSL_ALLOC_STATS_HPP
+#define TSL_ALLOC_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the number of heap allocations and the number of bytes requested by them.
+ */
+struct alloc_stats {
+    uint64_t count;
+    uint64_t bytes;
+
+    alloc_stats() : count(0), bytes(0) {}
+    alloc_stats(uint64_t count, uint64_t bytes) : count(count), bytes(bytes) {}
+
+    alloc_stats operator-(const alloc_stats& other) const {
+        return alloc_stats(count - other.count, bytes - other.bytes);
+    }
+};
+
+/**
+ * @brief Returns true, if the heap allocations are counted.
+ *
+ * This is only the case, if the global `operator new` is replaced by the hooks in `src/util/alloc_hooks.cpp`. They
+ * are not part of the library, but are compiled into `tsl_tests` and `tsl_benchmark`, if the CMake option
+ * `TSL_ALLOC_HOOKS` is enabled.
+ */
+bool is_alloc_tracking_enabled();
+
+/**
+ * @brief Returns the number of heap allocations of all threads since the start of the program. Always 0, if the
+ *        allocations are not counted.
+ */
+alloc_stats get_alloc_stats();
+
+/**
+ * @brief Counts a heap allocation of the given number of bytes. Called by the allocation hooks.
+ */
+void record_alloc(size_t bytes);
+
+/**
+ * @brief Marks the allocations as counted. Called by the allocation hooks on startup.
+ */
+void enable_alloc_tracking();
+
+/**
+ * @brief Measures the heap allocations of all threads from its construction until `get` is called.
+ *
+ * Allocations are counted process wide, so allocations of other threads running concurrently to the measured scope
+ * are attributed to it as well.
+ */
+class alloc_scope {
+public:
+    alloc_scope() : start(get_alloc_stats()) {}
+
+    /**
+     * @brief Returns the allocations since the construction of this scope.
+     */
+    alloc_stats get() const { return get_alloc_stats() - start; }
+
+private:
+    alloc_stats start;
+};
+
+}
+
+#endif //TSL_ALLOC_STATS_HPP
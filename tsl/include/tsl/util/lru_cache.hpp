@@ -0,0 +1,94 @@
+#ifndef TSL_LRU_CACHE_HPP
+#define TSL_LRU_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+using std::list;
+using std::pair;
+using std::unordered_map;
+
+namespace tsl {
+
+/**
+ * @brief A cache, which holds values up to a given total size and evicts the least recently used values first.
+ *
+ * The size of each value is given by the caller when it is inserted (e.g. the number of bytes it occupies), so the
+ * cache can be bounded by memory instead of by the number of values. The cache is not thread safe.
+ */
+template<typename key_t, typename value_t, typename hash_t = std::hash<key_t>>
+class lru_cache {
+public:
+    /**
+     * @brief Creates an empty cache, which holds values with a total size of at most `max_size`.
+     */
+    explicit lru_cache(size_t max_size);
+
+    /**
+     * @brief Returns the value for the given key or nullptr, if it is not cached. The value is marked as most
+     *        recently used. The pointer is valid until the next call to `insert` or `clear`.
+     */
+    const value_t* find(const key_t& key);
+
+    /**
+     * @brief Caches the given value with the given size and replaces the old value of the key. Evicts the least
+     *        recently used values until the total size is within the bounds again. Values larger than the max size
+     *        are not cached at all.
+     */
+    void insert(const key_t& key, value_t&& value, size_t size);
+
+    /**
+     * @brief Removes everything from the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Changes the max total size and evicts values, which don't fit anymore.
+     */
+    void set_max_size(size_t max_size);
+
+    /**
+     * @brief Returns the max total size of the cached values.
+     */
+    size_t get_max_size() const { return max_size; }
+
+    /**
+     * @brief Returns the total size of the cached values.
+     */
+    size_t get_size() const { return size; }
+
+    /**
+     * @brief Returns the number of cached values.
+     */
+    size_t num_values() const { return entries.size(); }
+
+private:
+    struct entry {
+        key_t key;
+        value_t value;
+        size_t size;
+    };
+
+    /// The cached values from most to least recently used.
+    list<entry> entries;
+    /// Position of each key in `entries`.
+    unordered_map<key_t, typename list<entry>::iterator, hash_t> positions;
+    /// Max total size of the cached values.
+    size_t max_size;
+    /// Total size of the cached values.
+    size_t size;
+
+    /**
+     * @brief Evicts the least recently used values, until the total size is at most `max_size`.
+     */
+    void evict();
+};
+
+}
+
+#include "tsl/util/lru_cache.tcc"
+
+#endif //TSL_LRU_CACHE_HPP
@@ -0,0 +1,60 @@
+namespace tsl {
+
+template<typename key_t, typename value_t, typename hash_t>
+lru_cache<key_t, value_t, hash_t>::lru_cache(size_t max_size) : max_size(max_size), size(0) {}
+
+template<typename key_t, typename value_t, typename hash_t>
+const value_t* lru_cache<key_t, value_t, hash_t>::find(const key_t& key) {
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+        return nullptr;
+    }
+
+    // Move the entry to the front without invalidating any iterators
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->value;
+}
+
+template<typename key_t, typename value_t, typename hash_t>
+void lru_cache<key_t, value_t, hash_t>::insert(const key_t& key, value_t&& value, size_t size) {
+    auto it = positions.find(key);
+    if (it != positions.end()) {
+        this->size -= it->second->size;
+        entries.erase(it->second);
+        positions.erase(it);
+    }
+
+    if (size > max_size) {
+        return;
+    }
+
+    entries.push_front(entry{key, std::move(value), size});
+    positions.emplace(key, entries.begin());
+    this->size += size;
+    evict();
+}
+
+template<typename key_t, typename value_t, typename hash_t>
+void lru_cache<key_t, value_t, hash_t>::clear() {
+    entries.clear();
+    positions.clear();
+    size = 0;
+}
+
+template<typename key_t, typename value_t, typename hash_t>
+void lru_cache<key_t, value_t, hash_t>::set_max_size(size_t max_size) {
+    this->max_size = max_size;
+    evict();
+}
+
+template<typename key_t, typename value_t, typename hash_t>
+void lru_cache<key_t, value_t, hash_t>::evict() {
+    while (size > max_size) {
+        const auto& last = entries.back();
+        size -= last.size;
+        positions.erase(last.key);
+        entries.pop_back();
+    }
+}
+
+}
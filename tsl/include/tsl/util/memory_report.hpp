@@ -0,0 +1,84 @@
+#ifndef TSL_MEMORY_REPORT_HPP
+#define TSL_MEMORY_REPORT_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace tsl {
+
+/**
+ * @brief POD type to hold the memory used by a data structure. Memory owned by the elements themselves (e.g. the
+ *        values of nested vectors) is not included.
+ */
+struct memory_usage {
+    /// Bytes of the stored elements.
+    size_t used_bytes;
+    /// Bytes of the slots of deleted elements, which are kept to keep the handles of the other elements stable.
+    size_t deleted_bytes;
+    /// Bytes allocated in total: used and deleted elements, unused capacity and bookkeeping (e.g. hash buckets).
+    size_t reserved_bytes;
+
+    memory_usage() : used_bytes(0), deleted_bytes(0), reserved_bytes(0) {}
+    memory_usage(size_t used_bytes, size_t deleted_bytes, size_t reserved_bytes)
+        : used_bytes(used_bytes), deleted_bytes(deleted_bytes), reserved_bytes(reserved_bytes) {}
+
+    memory_usage& operator+=(const memory_usage& other);
+};
+
+/**
+ * @brief Returns the memory used by the given vector.
+ */
+template<typename T>
+memory_usage get_memory_usage(const vector<T>& vec) {
+    return memory_usage(vec.size() * sizeof(T), 0, vec.capacity() * sizeof(T));
+}
+
+/**
+ * @brief The memory used by each data structure of an object (see `tmesh::memory_report`).
+ */
+class memory_usage_report {
+public:
+    /**
+     * @brief Adds the memory used by the data structure with the given name.
+     */
+    void add(const string& name, const memory_usage& usage);
+
+    /**
+     * @brief Adds all entries of the given report with the name "<prefix>/<name of the entry>".
+     */
+    void add(const string& prefix, const memory_usage_report& report);
+
+    /**
+     * @brief Returns the name and memory usage of each data structure in the order they were added.
+     */
+    const vector<pair<string, memory_usage>>& get_entries() const { return entries; }
+
+    /**
+     * @brief Returns the memory used by the data structure with the given name or nothing, if it is not part of
+     *        the report.
+     */
+    memory_usage get(const string& name) const;
+
+    /**
+     * @brief Returns the sum of all entries.
+     */
+    memory_usage get_total() const;
+
+    /**
+     * @brief Returns the report as table with one line per entry and the total.
+     */
+    string to_string() const;
+
+private:
+    vector<pair<string, memory_usage>> entries;
+};
+
+}
+
+#endif //TSL_MEMORY_REPORT_HPP
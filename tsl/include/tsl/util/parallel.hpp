@@ -0,0 +1,93 @@
+#ifndef TSL_PARALLEL_HPP
+#define TSL_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using std::exception_ptr;
+using std::thread;
+using std::vector;
+
+namespace tsl {
+
+/// The minimal number of elements a single thread should work on. Smaller ranges are not worth spawning threads.
+static const size_t MIN_ELEMENTS_PER_THREAD = 64;
+
+/**
+ * @brief Returns the number of chunks `parallel_chunks` will split a range of `count` elements into.
+ *
+ * @param max_threads The maximum number of threads to use. 0 means "use all available hardware threads".
+ */
+inline size_t get_num_chunks(size_t count, size_t max_threads = 0) {
+    if (max_threads == 0) {
+        max_threads = std::max<size_t>(thread::hardware_concurrency(), 1);
+    }
+    auto by_size = (count + MIN_ELEMENTS_PER_THREAD - 1) / MIN_ELEMENTS_PER_THREAD;
+    return std::max<size_t>(std::min(max_threads, by_size), 1);
+}
+
+/**
+ * @brief Splits the range [0, count) into `get_num_chunks(count, max_threads)` contiguous chunks and calls
+ *        `fn(begin, end, chunk)` for each of them on its own thread.
+ *
+ * Chunk `i` always covers elements in front of chunk `i + 1`, so results collected per chunk can be concatenated
+ * in chunk order to get the same output as a sequential loop. The first chunk is processed by the calling thread.
+ * If `fn` throws, the exception of the lowest chunk is rethrown in the calling thread after all threads finished.
+ */
+template<typename func_t>
+void parallel_chunks(size_t count, const func_t& fn, size_t max_threads = 0) {
+    auto num_chunks = get_num_chunks(count, max_threads);
+    if (num_chunks == 1) {
+        fn(size_t(0), count, size_t(0));
+        return;
+    }
+
+    auto chunk_size = (count + num_chunks - 1) / num_chunks;
+    vector<exception_ptr> errors(num_chunks);
+    auto run = [&](size_t chunk) {
+        auto begin = std::min(chunk * chunk_size, count);
+        auto end = std::min(begin + chunk_size, count);
+        try {
+            fn(begin, end, chunk);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(num_chunks - 1);
+    for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+        threads.emplace_back(run, chunk);
+    }
+    run(0);
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    for (const auto& e: errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+/**
+ * @brief Calls `fn(i)` for every i in [0, count) distributed over multiple threads.
+ *
+ * @see parallel_chunks
+ */
+template<typename func_t>
+void parallel_for(size_t count, const func_t& fn, size_t max_threads = 0) {
+    parallel_chunks(count, [&](size_t begin, size_t end, size_t) {
+        for (auto i = begin; i < end; ++i) {
+            fn(i);
+        }
+    }, max_threads);
+}
+
+}
+
+#endif //TSL_PARALLEL_HPP
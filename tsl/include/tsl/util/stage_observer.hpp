@@ -0,0 +1,59 @@
+#ifndef TSL_STAGE_OBSERVER_HPP
+#define TSL_STAGE_OBSERVER_HPP
+
+#include "tsl/util/trace.hpp"
+
+namespace tsl {
+
+/**
+ * @brief Is notified about the stages of long running operations (e.g. the stages of building the caches of the
+ *        `surface_evaluator`), so they can be measured from the outside.
+ *
+ * Stages are identified by string literals and don't nest. The observer is called from the thread, which runs the
+ * operation, the work inside a stage may be distributed over other threads.
+ */
+class stage_observer {
+public:
+    virtual ~stage_observer() = default;
+
+    /**
+     * @brief Is called before the stage with the given name starts.
+     */
+    virtual void begin_stage(const char* name) = 0;
+
+    /**
+     * @brief Is called after the stage with the given name ended.
+     */
+    virtual void end_stage(const char* name) = 0;
+};
+
+/**
+ * @brief Notifies the given observer about the begin of a stage on construction and about its end on destruction.
+ *        Does nothing, if there is no observer. The stage is recorded as trace zone as well (see `TSL_TRACE_ZONE`).
+ */
+class observed_stage {
+public:
+    observed_stage(stage_observer* observer, const char* name) : observer(observer), name(name), zone(name) {
+        if (observer != nullptr) {
+            observer->begin_stage(name);
+        }
+    }
+
+    observed_stage(const observed_stage&) = delete;
+    observed_stage& operator=(const observed_stage&) = delete;
+
+    ~observed_stage() {
+        if (observer != nullptr) {
+            observer->end_stage(name);
+        }
+    }
+
+private:
+    stage_observer* observer;
+    const char* name;
+    trace_zone zone;
+};
+
+}
+
+#endif //TSL_STAGE_OBSERVER_HPP
@@ -0,0 +1,110 @@
+#ifndef TSL_TRACE_HPP
+#define TSL_TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+namespace tsl {
+
+/// True, if the library was compiled with the trace zones (CMake option `TSL_TRACE`).
+#ifdef TSL_TRACE
+constexpr bool TRACE_COMPILED = true;
+#else
+constexpr bool TRACE_COMPILED = false;
+#endif
+
+/**
+ * @brief Starts recording the trace zones of all threads. Does nothing, if the trace zones are not compiled in.
+ */
+void start_trace();
+
+/**
+ * @brief Stops recording the trace zones. The recorded zones are kept until `clear_trace` is called.
+ */
+void stop_trace();
+
+/**
+ * @brief Returns true, if trace zones are recorded at the moment.
+ */
+bool is_tracing();
+
+/**
+ * @brief Discards all trace zones, which started before now. Can be called while other threads record zones.
+ *
+ * The discarded zones are only skipped by `trace_to_json`, their memory is kept until the end of the program.
+ */
+void clear_trace();
+
+/**
+ * @brief Returns all recorded trace zones in the Chrome trace event format, which can be opened in `chrome://tracing`
+ *        or in Perfetto. Can be called while other threads record zones, these zones may be missing in the output.
+ */
+string trace_to_json();
+
+/**
+ * @brief Writes the recorded trace zones to the given file (see `trace_to_json`). Returns false, if the file could
+ *        not be written.
+ */
+bool write_trace(const string& path);
+
+/**
+ * @brief Returns the time in nanoseconds since the start of the program, on which the trace zones are based.
+ */
+int64_t get_trace_time();
+
+/**
+ * @brief Records a finished trace zone for the calling thread.
+ *
+ * Each thread records into its own buffer, so this doesn't lock. Only the first zone of a thread takes a lock to
+ * register the buffer of the thread.
+ *
+ * @param name Name of the zone, has to be a string literal (or live as long as the trace).
+ */
+void record_trace_zone(const char* name, int64_t begin, int64_t end);
+
+/**
+ * @brief Records the time from its construction to its destruction as trace zone with the given name, if the trace is
+ *        recording. Compiles to nothing, if the trace zones are not compiled in. Use `TSL_TRACE_ZONE` instead of
+ *        creating it directly.
+ */
+class trace_zone {
+public:
+#ifdef TSL_TRACE
+    explicit trace_zone(const char* name) : name(name), begin(is_tracing() ? get_trace_time() : -1) {}
+
+    ~trace_zone() {
+        if (begin >= 0) {
+            record_trace_zone(name, begin, get_trace_time());
+        }
+    }
+#else
+    explicit trace_zone(const char* name) {}
+#endif
+
+    trace_zone(const trace_zone&) = delete;
+    trace_zone& operator=(const trace_zone&) = delete;
+
+#ifdef TSL_TRACE
+private:
+    const char* name;
+    int64_t begin;
+#endif
+};
+
+}
+
+#define TSL_TRACE_CONCAT_IMPL(a, b) a##b
+#define TSL_TRACE_CONCAT(a, b) TSL_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Records the rest of the enclosing scope as trace zone with the given name (a string literal).
+ */
+#ifdef TSL_TRACE
+#define TSL_TRACE_ZONE(name) ::tsl::trace_zone TSL_TRACE_CONCAT(tsl_trace_zone_, __LINE__)(name)
+#else
+#define TSL_TRACE_ZONE(name) static_cast<void>(0)
+#endif
+
+#endif //TSL_TRACE_HPP
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
+
+using std::set;
+using std::swap;
+
+namespace tsl {
+
+namespace {
+
+/**
+ * @brief Calls the given function with each vertex of the faces around the given vertex, which is not the vertex
+ *        itself. Vertices shared by several faces are passed multiple times.
+ *
+ * `faces` and `vertices` are only used as buffers.
+ */
+template<typename func_t>
+void visit_first_ring(
+    const tmesh& mesh,
+    vertex_handle handle,
+    vector<face_handle>& faces,
+    vector<vertex_handle>& vertices,
+    func_t fn
+) {
+    faces.clear();
+    mesh.get_faces_of_vertex(handle, faces);
+    for (const auto& fh: faces) {
+        vertices.clear();
+        mesh.get_vertices_of_face(fh, vertices);
+        for (const auto& vh: vertices) {
+            if (vh != handle) {
+                fn(vh);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns true, if both sorted lists contain a common vertex.
+ */
+bool has_common_vertex(const vector<vertex_handle>& first, const vector<vertex_handle>& second) {
+    auto first_it = first.begin();
+    auto second_it = second.begin();
+    while (first_it != first.end() && second_it != second.end()) {
+        if (*first_it == *second_it) {
+            return true;
+        }
+        if (*first_it < *second_it) {
+            ++first_it;
+        } else {
+            ++second_it;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns true, if an extraordinary vertex lies within `rings` rings around both vertices, which share a face
+ *        and have the given nearest extraordinary vertices.
+ */
+bool is_near_both(const nearest_extraordinary& first, const nearest_extraordinary& second, uint32_t rings) {
+    // As the vertices share a face, an extraordinary vertex closer than `rings` to one of them is at most `rings`
+    // away from the other one.
+    if (first.distance < rings || second.distance < rings) {
+        return true;
+    }
+    if (first.distance > rings || second.distance > rings) {
+        return false;
+    }
+
+    // Otherwise all extraordinary vertices within `rings` rings are the nearest ones of both vertices
+    return has_common_vertex(first.vertices, second.vertices);
+}
+
+/**
+ * @brief Searches the rings around the given vertex for its nearest extraordinary vertices.
+ */
+nearest_extraordinary find_nearest(const tmesh& mesh, vertex_handle handle, uint32_t rings) {
+    nearest_extraordinary out{0, {}};
+    if (mesh.is_extraordinary(handle)) {
+        out.vertices.push_back(handle);
+        return out;
+    }
+
+    set<vertex_handle> visited = {handle};
+    vector<vertex_handle> current = {handle};
+    vector<vertex_handle> next;
+    vector<face_handle> faces;
+    vector<vertex_handle> vertices;
+    for (uint32_t ring = 1; ring <= rings; ++ring) {
+        next.clear();
+        for (const auto& vh: current) {
+            visit_first_ring(mesh, vh, faces, vertices, [&](vertex_handle neighbour) {
+                if (visited.insert(neighbour).second) {
+                    next.push_back(neighbour);
+                    if (mesh.is_extraordinary(neighbour)) {
+                        out.vertices.push_back(neighbour);
+                    }
+                }
+            });
+        }
+        if (!out.vertices.empty()) {
+            out.distance = ring;
+            std::sort(out.vertices.begin(), out.vertices.end());
+            return out;
+        }
+        swap(current, next);
+    }
+
+    out.distance = rings + 1;
+    return out;
+}
+
+}
+
+extraordinary_distance_field::extraordinary_distance_field(const tmesh& mesh, uint32_t rings)
+    : rings(rings), nearest(mesh.num_vertices(), nearest_extraordinary{rings + 1, {}})
+{
+    vector<vertex_handle> current;
+    for (const auto& vh: mesh.get_vertices()) {
+        if (mesh.is_extraordinary(vh)) {
+            nearest.insert(vh, nearest_extraordinary{0, {vh}});
+            current.push_back(vh);
+        }
+    }
+
+    // Walk the rings around all extraordinary vertices at once, ring by ring. A vertex is reached first from its
+    // nearest extraordinary vertices, thus it is added to the next ring only once, but may still get more nearest
+    // extraordinary vertices from the current ring.
+    vector<vertex_handle> next;
+    vector<face_handle> faces;
+    vector<vertex_handle> vertices;
+    for (uint32_t ring = 1; ring <= rings && !current.empty(); ++ring) {
+        next.clear();
+        for (const auto& vh: current) {
+            visit_first_ring(mesh, vh, faces, vertices, [&](vertex_handle neighbour) {
+                auto reached = get_nearest(neighbour).distance <= rings;
+                if (relax(vh, neighbour) && !reached) {
+                    next.push_back(neighbour);
+                }
+            });
+        }
+        swap(current, next);
+    }
+}
+
+const nearest_extraordinary& extraordinary_distance_field::get_nearest(vertex_handle handle) const {
+    return nearest[handle];
+}
+
+bool extraordinary_distance_field::is_near_both(vertex_handle first, vertex_handle second) const {
+    return ::tsl::is_near_both(get_nearest(first), get_nearest(second), rings);
+}
+
+void extraordinary_distance_field::update_face(const tmesh& mesh, face_handle handle) {
+    // Only the vertices of the merged face became neighbours, all other distances can only change through them
+    auto vertices = mesh.get_vertices_of_face(handle);
+    vector<vertex_handle> queue;
+    for (const auto& from: vertices) {
+        for (const auto& to: vertices) {
+            if (from != to && relax(from, to)) {
+                queue.push_back(to);
+            }
+        }
+    }
+    propagate(mesh, queue);
+}
+
+uint32_t extraordinary_distance_field::get_rings() const {
+    return rings;
+}
+
+bool extraordinary_distance_field::relax(vertex_handle from, vertex_handle to) {
+    auto distance = get_nearest(from).distance + 1;
+    if (distance > rings || distance > get_nearest(to).distance) {
+        return false;
+    }
+
+    // `nearest[to]` may insert a value and thus has to be taken before the reference to the value of `from`
+    auto& target = nearest[to];
+    const auto& source = get_nearest(from);
+    if (distance < target.distance) {
+        target.distance = distance;
+        target.vertices = source.vertices;
+        return true;
+    }
+
+    auto changed = false;
+    for (const auto& vh: source.vertices) {
+        auto it = std::lower_bound(target.vertices.begin(), target.vertices.end(), vh);
+        if (it == target.vertices.end() || *it != vh) {
+            target.vertices.insert(it, vh);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void extraordinary_distance_field::propagate(const tmesh& mesh, vector<vertex_handle>& queue) {
+    vector<face_handle> faces;
+    vector<vertex_handle> vertices;
+    while (!queue.empty()) {
+        auto vh = queue.back();
+        queue.pop_back();
+        visit_first_ring(mesh, vh, faces, vertices, [&](vertex_handle neighbour) {
+            if (relax(vh, neighbour)) {
+                queue.push_back(neighbour);
+            }
+        });
+    }
+}
+
+bool is_near_extraordinary_vertex(const tmesh& mesh, vertex_handle first, vertex_handle second, uint32_t rings) {
+    auto nearest_first = find_nearest(mesh, first, rings);
+    if (nearest_first.distance < rings) {
+        return true;
+    }
+    return is_near_both(nearest_first, find_nearest(mesh, second, rings), rings);
+}
+
+}
@@ -1,7 +1,56 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/constants.hpp>
+
 #include "tsl/algorithm/generator.hpp"
+#include "tsl/evaluation/subdevision.hpp"
+#include "tsl/util/panic.hpp"
+
+using std::min;
 
 namespace tsl {
 
+namespace {
+
+/**
+ * @brief Kind of a cell in the grid of `tmesh_synthetic`.
+ */
+enum class cell_kind : uint8_t {
+    /// The cell is a single face.
+    regular,
+    /// The cell is split into a left and a right face, its bottom and top sides get a midpoint.
+    split_u,
+    /// The cell is split into a bottom and a top face, its left and right sides get a midpoint.
+    split_v,
+    /// The cell is part of the block of an extraordinary vertex and is replaced by its sectors.
+    star,
+    /// The cell is next to the block of an extraordinary vertex and is never split.
+    margin
+};
+
+/**
+ * @brief A square block of cells, which is replaced by the sectors around an extraordinary vertex.
+ */
+struct star_block {
+    uint32_t valence;
+    /// Lower left cell of the block.
+    uint32_t x;
+    uint32_t y;
+    /// Number of cells per side of the block.
+    uint32_t size;
+};
+
+/**
+ * @brief Returns a random number in [0, 1).
+ */
+double random_unit(std::mt19937& rng) {
+    return rng() / 4294967296.0;
+}
+
+}
+
 tmesh tmesh_cube(uint32_t size, double edge_length) {
     tmesh out;
     // =============================
@@ -487,4 +536,390 @@ tmesh tmesh_cube(uint32_t size, double edge_length) {
     return out;
 }
 
+tmesh tmesh_synthetic(const synthetic_tmesh_config& config) {
+    const auto width = config.width;
+    const auto height = config.height;
+    const auto sector_size = config.sector_size;
+    if (width < 3 || height < 3) {
+        panic("a synthetic tmesh needs at least 3x3 cells, but {}x{} were requested!", width, height);
+    }
+    if (config.t_junction_density < 0 || config.t_junction_density > 1) {
+        panic("the t-junction density ({}) has to be between 0 and 1!", config.t_junction_density);
+    }
+    if (config.max_knot_ratio < 1) {
+        panic("the max knot ratio ({}) has to be at least 1!", config.max_knot_ratio);
+    }
+    if (sector_size == 0) {
+        panic("the sector size has to be at least 1!");
+    }
+
+    std::mt19937 rng(config.seed);
+    auto cell_index = [&](uint32_t x, uint32_t y) {
+        return static_cast<size_t>(y % height) * width + (x % width);
+    };
+
+    // =============================
+    // Place the extraordinary vertices
+    // =============================
+
+    // Each block gets its own slot and is centered in it. The slots are laid out in a grid which matches the aspect
+    // ratio of the mesh.
+    vector<cell_kind> cells(static_cast<size_t>(width) * height, cell_kind::regular);
+    vector<bool> uniform_columns(width, false);
+    vector<bool> uniform_rows(height, false);
+    vector<star_block> blocks;
+    if (!config.valences.empty()) {
+        auto num_blocks = static_cast<uint32_t>(config.valences.size());
+        auto slot_columns = static_cast<uint32_t>(std::ceil(std::sqrt(num_blocks * double(width) / height)));
+        slot_columns = std::clamp<uint32_t>(slot_columns, 1, num_blocks);
+        auto slot_rows = (num_blocks + slot_columns - 1) / slot_columns;
+        auto slot_width = width / slot_columns;
+        auto slot_height = height / slot_rows;
+
+        blocks.reserve(num_blocks);
+        for (uint32_t i = 0; i < num_blocks; ++i) {
+            auto valence = config.valences[i];
+            if (valence < 3 || valence > MAX_VALENCE) {
+                panic(
+                    "the valence ({}) is lower than 3 or higher than the defined maximum ({})!",
+                    valence,
+                    MAX_VALENCE
+                );
+            }
+            if ((valence * sector_size) % 2 != 0) {
+                panic("valence ({}) times sector size ({}) has to be even!", valence, sector_size);
+            }
+
+            // The block has the same number of boundary edges as the sectors: 4 * size == 2 * valence * sector_size
+            auto size = valence * sector_size / 2;
+            if (size + 2 > slot_width || size + 2 > slot_height) {
+                panic(
+                    "the extraordinary vertex with valence {} needs {}x{} cells, but only {}x{} cells are available!",
+                    valence,
+                    size + 2,
+                    size + 2,
+                    slot_width,
+                    slot_height
+                );
+            }
+
+            star_block block;
+            block.valence = valence;
+            block.x = (i % slot_columns) * slot_width + (slot_width - size) / 2;
+            block.y = (i / slot_columns) * slot_height + (slot_height - size) / 2;
+            block.size = size;
+            blocks.push_back(block);
+
+            for (auto y = block.y - 1; y <= block.y + size; ++y) {
+                for (auto x = block.x - 1; x <= block.x + size; ++x) {
+                    auto inside = x >= block.x && x < block.x + size && y >= block.y && y < block.y + size;
+                    cells[cell_index(x, y)] = inside ? cell_kind::star : cell_kind::margin;
+                }
+            }
+            for (uint32_t j = 0; j < size; ++j) {
+                uniform_columns[block.x + j] = true;
+                uniform_rows[block.y + j] = true;
+            }
+        }
+    }
+
+    // =============================
+    // Draw knot intervals and split cells
+    // =============================
+    auto draw_knots = [&](const vector<bool>& uniform) {
+        vector<double> out(uniform.size());
+        for (size_t i = 0; i < uniform.size(); ++i) {
+            auto knot = 1.0 + (config.max_knot_ratio - 1.0) * random_unit(rng);
+            out[i] = uniform[i] ? 1.0 : knot;
+        }
+        return out;
+    };
+    auto column_knots = draw_knots(uniform_columns);
+    auto row_knots = draw_knots(uniform_rows);
+
+    size_t num_splits = 0;
+    for (auto& cell: cells) {
+        if (cell == cell_kind::regular && random_unit(rng) < config.t_junction_density) {
+            cell = random_unit(rng) < 0.5 ? cell_kind::split_u : cell_kind::split_v;
+            num_splits += 1;
+        }
+    }
+
+    // The sides of a cell get a midpoint, if one of the two adjacent cells is split across it. Each cell stores the
+    // midpoints of its bottom and its left side.
+    vector<bool> has_bottom_mid(cells.size());
+    vector<bool> has_left_mid(cells.size());
+    size_t num_mids = 0;
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            auto i = cell_index(x, y);
+            auto below = cells[cell_index(x, y + height - 1)];
+            auto left = cells[cell_index(x + width - 1, y)];
+            has_bottom_mid[i] = cells[i] == cell_kind::split_u || below == cell_kind::split_u;
+            has_left_mid[i] = cells[i] == cell_kind::split_v || left == cell_kind::split_v;
+            num_mids += has_bottom_mid[i] + has_left_mid[i];
+        }
+    }
+
+    // =============================
+    // Allocate the mesh
+    // =============================
+    size_t num_vertices = cells.size() + num_mids;
+    size_t num_faces = cells.size() + num_splits;
+    for (const auto& block: blocks) {
+        auto inner = block.size - 1;
+        num_vertices -= inner * inner;
+        num_vertices += block.valence * sector_size * sector_size - block.valence * sector_size + 1;
+        num_faces -= block.size * block.size;
+        num_faces += block.valence * sector_size * sector_size;
+    }
+
+    tmesh out;
+    // The euler characteristic of the torus is 0, so there are as many edges as vertices plus faces
+    out.reserve(num_vertices, num_faces, num_vertices + num_faces);
+
+    // =============================
+    // Create vertices
+    // =============================
+
+    // Position of each grid line in the parameter space of the torus
+    vector<double> column_pos(width + 1, 0.0);
+    for (uint32_t x = 0; x < width; ++x) {
+        column_pos[x + 1] = column_pos[x] + column_knots[x];
+    }
+    vector<double> row_pos(height + 1, 0.0);
+    for (uint32_t y = 0; y < height; ++y) {
+        row_pos[y + 1] = row_pos[y] + row_knots[y];
+    }
+
+    // Keep the torus from intersecting itself, if it isn't long enough
+    const auto two_pi = glm::two_pi<double>();
+    auto major_radius = column_pos[width] * config.edge_length / two_pi;
+    auto minor_radius = min(row_pos[height] * config.edge_length / two_pi, 0.5 * major_radius);
+    auto add_vertex = [&](vec2 param) {
+        auto theta = two_pi * param.x / column_pos[width];
+        auto phi = two_pi * param.y / row_pos[height];
+        auto ring = major_radius + minor_radius * std::cos(phi);
+        return out.add_vertex(vec3(ring * std::cos(theta), ring * std::sin(theta), minor_radius * std::sin(phi)));
+    };
+
+    // Grid vertices in the inside of the blocks are never created
+    vector<bool> inside_block(cells.size(), false);
+    for (const auto& block: blocks) {
+        for (auto y = block.y + 1; y < block.y + block.size; ++y) {
+            for (auto x = block.x + 1; x < block.x + block.size; ++x) {
+                inside_block[cell_index(x, y)] = true;
+            }
+        }
+    }
+
+    vector<optional_vertex_handle> grid_vertices(cells.size());
+    vector<optional_vertex_handle> bottom_mids(cells.size());
+    vector<optional_vertex_handle> left_mids(cells.size());
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            auto i = cell_index(x, y);
+            if (!inside_block[i]) {
+                grid_vertices[i] = optional_vertex_handle(add_vertex(vec2(column_pos[x], row_pos[y])));
+            }
+            if (has_bottom_mid[i]) {
+                auto u = 0.5 * (column_pos[x] + column_pos[x + 1]);
+                bottom_mids[i] = optional_vertex_handle(add_vertex(vec2(u, row_pos[y])));
+            }
+            if (has_left_mid[i]) {
+                auto v = 0.5 * (row_pos[y] + row_pos[y + 1]);
+                left_mids[i] = optional_vertex_handle(add_vertex(vec2(column_pos[x], v)));
+            }
+        }
+    }
+
+    // =============================
+    // Create faces of the cells
+    // =============================
+    vector<new_face_vertex> face_vertices;
+    const optional_vertex_handle no_mid;
+
+    // Adds the side of a face, which ends at the corner `end` and may have a T-junction at `mid`
+    auto add_side = [&](optional_vertex_handle mid, vertex_handle end, double knot) {
+        if (mid) {
+            face_vertices.emplace_back(mid.unwrap(), false, 0.5 * knot);
+            face_vertices.emplace_back(end, true, 0.5 * knot);
+        } else {
+            face_vertices.emplace_back(end, true, knot);
+        }
+    };
+    auto add_face = [&]() {
+        out.add_face(face_vertices);
+        face_vertices.clear();
+    };
+
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            auto i = cell_index(x, y);
+            if (cells[i] == cell_kind::star) {
+                continue;
+            }
+
+            auto u = column_knots[x];
+            auto v = row_knots[y];
+            auto bottom_left = grid_vertices[i].unwrap();
+            auto bottom_right = grid_vertices[cell_index(x + 1, y)].unwrap();
+            auto top_right = grid_vertices[cell_index(x + 1, y + 1)].unwrap();
+            auto top_left = grid_vertices[cell_index(x, y + 1)].unwrap();
+            auto bottom_mid = bottom_mids[i];
+            auto right_mid = left_mids[cell_index(x + 1, y)];
+            auto top_mid = bottom_mids[cell_index(x, y + 1)];
+            auto left_mid = left_mids[i];
+
+            switch (cells[i]) {
+                case cell_kind::split_u:
+                    // left face
+                    add_side(no_mid, bottom_mid.unwrap(), 0.5 * u);
+                    add_side(no_mid, top_mid.unwrap(), v);
+                    add_side(no_mid, top_left, 0.5 * u);
+                    add_side(left_mid, bottom_left, v);
+                    add_face();
+
+                    // right face
+                    add_side(no_mid, bottom_right, 0.5 * u);
+                    add_side(right_mid, top_right, v);
+                    add_side(no_mid, top_mid.unwrap(), 0.5 * u);
+                    add_side(no_mid, bottom_mid.unwrap(), v);
+                    add_face();
+                    break;
+                case cell_kind::split_v:
+                    // bottom face
+                    add_side(bottom_mid, bottom_right, u);
+                    add_side(no_mid, right_mid.unwrap(), 0.5 * v);
+                    add_side(no_mid, left_mid.unwrap(), u);
+                    add_side(no_mid, bottom_left, 0.5 * v);
+                    add_face();
+
+                    // top face
+                    add_side(no_mid, right_mid.unwrap(), u);
+                    add_side(no_mid, top_right, 0.5 * v);
+                    add_side(top_mid, top_left, u);
+                    add_side(no_mid, left_mid.unwrap(), 0.5 * v);
+                    add_face();
+                    break;
+                default:
+                    add_side(bottom_mid, bottom_right, u);
+                    add_side(right_mid, top_right, v);
+                    add_side(top_mid, top_left, u);
+                    add_side(left_mid, bottom_left, v);
+                    add_face();
+                    break;
+            }
+        }
+    }
+
+    // =============================
+    // Create sectors around the extraordinary vertices
+    // =============================
+    vector<vertex_handle> boundary;
+    vector<vec2> boundary_params;
+    vector<vertex_handle> sector_vertices;
+    for (const auto& block: blocks) {
+        const auto size = block.size;
+        const auto valence = block.valence;
+
+        // Boundary of the block in counter-clockwise order, starting at its lower left corner
+        boundary.clear();
+        boundary_params.clear();
+        auto add_boundary = [&](uint32_t x, uint32_t y) {
+            boundary.push_back(grid_vertices[cell_index(x, y)].unwrap());
+            boundary_params.emplace_back(column_pos[x], row_pos[y]);
+        };
+        for (uint32_t j = 0; j < size; ++j) {
+            add_boundary(block.x + j, block.y);
+        }
+        for (uint32_t j = 0; j < size; ++j) {
+            add_boundary(block.x + size, block.y + j);
+        }
+        for (uint32_t j = 0; j < size; ++j) {
+            add_boundary(block.x + size - j, block.y + size);
+        }
+        for (uint32_t j = 0; j < size; ++j) {
+            add_boundary(block.x, block.y + size - j);
+        }
+
+        // The boundary of the sectors starts at the end of the first spoke and runs along the outer sides of each
+        // sector. The outer corner of the first sector is put onto the lower left corner of the block.
+        const auto num_boundary = static_cast<double>(boundary.size());
+        auto get_boundary_index = [&](double sector_index) {
+            return std::fmod(sector_index - sector_size + num_boundary, num_boundary);
+        };
+
+        // Local coordinates (a, b) of a vertex in sector `t` run from 0 to `sector_size` along spoke `t` and
+        // spoke `t + 1`. The vertices in the inside are placed between the center and the boundary of the block.
+        vec2 center(
+            0.5 * (column_pos[block.x] + column_pos[block.x + size]),
+            0.5 * (row_pos[block.y] + row_pos[block.y + size])
+        );
+        auto get_param = [&](uint32_t t, uint32_t a, uint32_t b) {
+            auto ring = std::max(a, b);
+            auto side = a == ring ? double(b) * sector_size / ring : 2.0 * sector_size - double(a) * sector_size / ring;
+            auto pos = get_boundary_index(2.0 * sector_size * t + side);
+            auto first = static_cast<size_t>(pos);
+            auto second = (first + 1) % boundary.size();
+            auto target = glm::mix(boundary_params[first], boundary_params[second], pos - first);
+            return glm::mix(center, target, double(ring) / sector_size);
+        };
+
+        // `sector_vertices` holds the center, the inner vertices of each spoke and the inner vertices of each sector
+        const auto inner = sector_size - 1;
+        sector_vertices.clear();
+        sector_vertices.push_back(add_vertex(center));
+        for (uint32_t t = 0; t < valence; ++t) {
+            for (uint32_t a = 1; a < sector_size; ++a) {
+                sector_vertices.push_back(add_vertex(get_param(t, a, 0)));
+            }
+        }
+        for (uint32_t t = 0; t < valence; ++t) {
+            for (uint32_t a = 1; a < sector_size; ++a) {
+                for (uint32_t b = 1; b < sector_size; ++b) {
+                    sector_vertices.push_back(add_vertex(get_param(t, a, b)));
+                }
+            }
+        }
+
+        auto get_vertex = [&](uint32_t t, uint32_t a, uint32_t b) {
+            if (a == sector_size) {
+                return boundary[static_cast<size_t>(get_boundary_index(2.0 * sector_size * t + b))];
+            }
+            if (b == sector_size) {
+                return boundary[static_cast<size_t>(get_boundary_index(2.0 * sector_size * t + 2 * sector_size - a))];
+            }
+            if (a == 0 && b == 0) {
+                return sector_vertices[0];
+            }
+            if (b == 0) {
+                return sector_vertices[1 + t * inner + (a - 1)];
+            }
+            if (a == 0) {
+                return sector_vertices[1 + ((t + 1) % valence) * inner + (b - 1)];
+            }
+            return sector_vertices[1 + valence * inner + (t * inner + (a - 1)) * inner + (b - 1)];
+        };
+
+        // All knots in the block are uniform
+        for (uint32_t t = 0; t < valence; ++t) {
+            for (uint32_t a = 0; a < sector_size; ++a) {
+                for (uint32_t b = 0; b < sector_size; ++b) {
+                    out.add_face(
+                        {
+                            get_vertex(t, a, b),
+                            get_vertex(t, a + 1, b),
+                            get_vertex(t, a + 1, b + 1),
+                            get_vertex(t, a, b + 1)
+                        }
+                    );
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
 }
@@ -1,18 +1,86 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <utility>
+
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
 #include "tsl/algorithm/reduction.hpp"
+#include "tsl/util/parallel.hpp"
+
+using std::atomic;
+using std::mt19937;
+using std::swap;
 
 namespace tsl {
 
+namespace {
+
+/// Min number of edges tried per round of `remove_edges_batch`. Larger rounds have more conflicts between the edges,
+/// smaller rounds need more of them.
+constexpr size_t MIN_ROUND_SIZE = 256;
+
+/// Value of a face, which isn't reserved by any edge.
+constexpr uint32_t NOT_RESERVED = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Writes the faces around the vertices of the faces around both vertices of the given edge sorted and without
+ *        duplicates into `out`.
+ *
+ * If these faces of two edges don't overlap, their vertices are at least four rings apart, so they are independent
+ * (see `tmesh::remove_independent_edges`). `vertices` is only used as buffer.
+ */
+void get_neighbourhood(
+    const tmesh& mesh,
+    edge_handle handle,
+    vector<face_handle>& out,
+    vector<vertex_handle>& vertices
+) {
+    auto [vertex_1_h, vertex_2_h] = mesh.get_vertices_of_edge(handle);
+    out.clear();
+    mesh.get_faces_of_vertex(vertex_1_h, out);
+    mesh.get_faces_of_vertex(vertex_2_h, out);
+
+    vertices.clear();
+    for (const auto& fh: out) {
+        mesh.get_vertices_of_face(fh, vertices);
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+    out.clear();
+    for (const auto& vh: vertices) {
+        mesh.get_faces_of_vertex(vh, out);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+/**
+ * @brief Sets the given reservation to the given priority, if it is lower (thus more important) than the current one.
+ */
+void reserve(atomic<uint32_t>& reservation, uint32_t priority) {
+    auto current = reservation.load(std::memory_order_relaxed);
+    while (priority < current && !reservation.compare_exchange_weak(current, priority, std::memory_order_relaxed)) {}
+}
+
+}
+
 size_t remove_edges(tmesh& mesh, double percent) {
     assert(percent <= 100.0);
     assert(percent > 0);
 
+    // Checking the distance to extraordinary vertices for each edge on its own would search the rings around both
+    // of its vertices every time
+    extraordinary_distance_field field(mesh);
+
     uint32_t deleted = 0;
     double count = 1.0;
     auto delete_every_n_edge = static_cast<size_t>(100.0 / percent);
     for (const auto& edge: mesh.get_edges()) {
         if (count > delete_every_n_edge) {
             count -= delete_every_n_edge;
-            if (mesh.remove_edge(edge)) {
+            if (mesh.remove_edge(edge, field)) {
                 deleted += 1;
             }
         } else {
@@ -23,4 +91,96 @@ size_t remove_edges(tmesh& mesh, double percent) {
     return deleted;
 }
 
+size_t remove_edges_batch(tmesh& mesh, const batch_reduction_config& config) {
+    assert(config.percent <= 100.0);
+    assert(config.percent > 0);
+
+    extraordinary_distance_field field(mesh);
+
+    // The position of an edge in this order is its priority, lower positions win conflicts
+    vector<edge_handle> order;
+    order.reserve(mesh.num_edges());
+    for (const auto& eh: mesh.get_edges()) {
+        order.push_back(eh);
+    }
+    mt19937 rng(config.seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    auto target = static_cast<size_t>(static_cast<double>(order.size()) * config.percent / 100.0);
+
+    // Removing edges never adds faces, so the current handles are enough
+    size_t num_reservations = 0;
+    for (const auto& fh: mesh.get_faces()) {
+        num_reservations = std::max<size_t>(num_reservations, fh.get_idx() + 1);
+    }
+    vector<atomic<uint32_t>> reservations(num_reservations);
+    for (auto& reservation: reservations) {
+        reservation.store(NOT_RESERVED, std::memory_order_relaxed);
+    }
+
+    // Rounds grow with the mesh, so the number of rounds stays small, while only few edges of a round conflict
+    auto round_size = std::max(MIN_ROUND_SIZE, mesh.num_faces() / 128);
+    vector<uint32_t> round;
+    vector<uint32_t> retry;
+    vector<uint8_t> removable;
+    vector<vector<face_handle>> neighbourhoods;
+    vector<edge_handle> selected;
+    size_t next = 0;
+    size_t deleted = 0;
+    while (deleted < target && (!retry.empty() || next < order.size())) {
+        // Retried edges come first in the order, so the round stays sorted by priority
+        swap(round, retry);
+        retry.clear();
+        while (round.size() < round_size && next < order.size()) {
+            round.push_back(static_cast<uint32_t>(next++));
+        }
+
+        removable.assign(round.size(), 0);
+        if (neighbourhoods.size() < round.size()) {
+            neighbourhoods.resize(round.size());
+        }
+        parallel_chunks(round.size(), [&](size_t begin, size_t end, size_t) {
+            vector<vertex_handle> vertices;
+            for (auto i = begin; i < end; ++i) {
+                auto eh = order[round[i]];
+                if (!mesh.can_remove_edge(eh, field)) {
+                    continue;
+                }
+                removable[i] = 1;
+                get_neighbourhood(mesh, eh, neighbourhoods[i], vertices);
+                for (const auto& fh: neighbourhoods[i]) {
+                    reserve(reservations[fh.get_idx()], round[i]);
+                }
+            }
+        }, config.num_threads);
+
+        // An edge holding the reservations of its whole neighbourhood has no conflict with any edge earlier in the
+        // order, so the neighbourhoods of the selected edges don't overlap
+        selected.clear();
+        for (size_t i = 0; i < round.size(); ++i) {
+            if (!removable[i]) {
+                continue;
+            }
+            auto won = std::all_of(neighbourhoods[i].begin(), neighbourhoods[i].end(), [&](face_handle fh) {
+                return reservations[fh.get_idx()].load(std::memory_order_relaxed) == round[i];
+            });
+            if (won && deleted + selected.size() < target) {
+                selected.push_back(order[round[i]]);
+            } else {
+                retry.push_back(round[i]);
+            }
+        }
+        for (size_t i = 0; i < round.size(); ++i) {
+            if (removable[i]) {
+                for (const auto& fh: neighbourhoods[i]) {
+                    reservations[fh.get_idx()].store(NOT_RESERVED, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        deleted += mesh.remove_independent_edges(selected, field, config.num_threads);
+    }
+
+    return deleted;
+}
+
 }
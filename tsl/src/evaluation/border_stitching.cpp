@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/border_stitching.hpp"
+#include "tsl/attrmaps/attr_maps.hpp"
+#include "tsl/util/trace.hpp"
+
+using std::abs;
+using std::lower_bound;
+using std::lround;
+using std::max;
+using std::min;
+using std::round;
+using std::set;
+using std::tuple;
+using std::vector;
+
+using glm::mix;
+using glm::normalize;
+
+namespace tsl {
+
+namespace {
+
+/// Params, which are closer than this (relative to the distance of two border vertices), lie on a border vertex.
+constexpr double PARAM_EPSILON = 1e-9;
+
+/**
+ * @brief The border vertices of a face on one of its half edges.
+ */
+struct side_samples {
+    half_edge_handle handle;
+    /// Index of the face in the faces passed to `get_border_stitches`.
+    uint32_t face;
+    /// The border vertices in the direction of the half edge. The first and the last one represent the source and the
+    /// target of the half edge.
+    vector<grid_vertex> vertices;
+    /// Fraction of each border vertex along the half edge.
+    vector<double> fractions;
+    /// True, if the last border vertex lies exactly on the target of the half edge.
+    bool exact_target;
+
+    side_samples(half_edge_handle handle, uint32_t face) : handle(handle), face(face), exact_target(false) {}
+};
+
+double get_side_coord(uint8_t side, const vec2& uv) {
+    return side % 2 == 0 ? uv.x : uv.y;
+}
+
+/**
+ * @brief Returns the `k`-th vertex on the given side of a face with the given resolution.
+ */
+grid_vertex get_side_vertex(uint32_t face, uint8_t side, uint32_t res, uint32_t k) {
+    switch (side) {
+        case 0:
+            return grid_vertex(face, k, 0);
+        case 1:
+            return grid_vertex(face, res, k);
+        case 2:
+            return grid_vertex(face, k, res);
+        default:
+            return grid_vertex(face, 0, k);
+    }
+}
+
+/**
+ * @brief Collects the border vertices of a face with the given resolution on the given segment.
+ */
+side_samples get_side_samples(uint32_t face, const face_segment& segment, uint32_t res) {
+    auto start = get_side_coord(segment.side, segment.start);
+    auto end = get_side_coord(segment.side, segment.end);
+
+    // T-junctions between two border vertices are represented by the nearest one
+    auto first = lround(start * res);
+    auto last = lround(end * res);
+    auto step = first <= last ? 1 : -1;
+
+    side_samples out(segment.handle, face);
+    out.exact_target = abs(end * res - last) < PARAM_EPSILON;
+    for (auto k = first;; k += step) {
+        auto fraction = (static_cast<double>(k) / res - start) / (end - start);
+        if (k == first || k == last) {
+            fraction = k == first ? 0.0 : 1.0;
+        }
+        out.vertices.push_back(get_side_vertex(face, segment.side, res, static_cast<uint32_t>(k)));
+        out.fractions.push_back(fraction);
+        if (k == last) {
+            break;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Moves the inner border vertices of `moved` onto the border vertices of `fixed`, which lies on the twin of its
+ *        half edge and has at most as many border vertices. The first and the last border vertices of both sides
+ *        have to be moved onto the vertices of the tmesh already.
+ */
+void stitch_side(const side_samples& moved, const side_samples& fixed, vector<border_stitch>& out) {
+    auto m = moved.vertices.size();
+    if (m <= 2) {
+        return;
+    }
+
+    // The border vertices of the fixed side in the direction of the moved side
+    vector<grid_vertex> anchors(fixed.vertices.rbegin(), fixed.vertices.rend());
+    vector<double> anchor_fractions;
+    anchor_fractions.reserve(fixed.fractions.size());
+    for (auto it = fixed.fractions.rbegin(); it != fixed.fractions.rend(); ++it) {
+        anchor_fractions.push_back(1 - *it);
+    }
+    if (anchors.size() == 1) {
+        // Both vertices of the edge are represented by the same border vertex
+        anchors.push_back(anchors.front());
+        anchor_fractions.push_back(1);
+    }
+    auto n = anchors.size();
+
+    // Each inner vertex of the fixed side gets the nearest inner vertex of the moved side, which is not used by the
+    // previous ones and leaves enough vertices for the following ones. Thus the matched vertices keep their order.
+    vector<size_t> matches(n);
+    matches[0] = 0;
+    matches[n - 1] = m - 1;
+    auto begin = moved.fractions.begin();
+    for (size_t j = 1; j + 1 < n; ++j) {
+        auto f = anchor_fractions[j];
+        auto k = static_cast<size_t>(lower_bound(begin + 1, begin + static_cast<ptrdiff_t>(m - 1), f) - begin);
+        if (k == m - 1 || (k > 1 && f - moved.fractions[k - 1] <= moved.fractions[k] - f)) {
+            k -= 1;
+        }
+        k = min(max(k, matches[j - 1] + 1), m - n + j);
+        matches[j] = k;
+        out.emplace_back(moved.vertices[k], anchors[j], anchors[j], 0.0);
+    }
+
+    // The vertices between two matched vertices are moved onto the line between their anchors
+    for (size_t j = 0; j + 1 < n; ++j) {
+        auto first = matches[j];
+        auto last = matches[j + 1];
+        for (auto k = first + 1; k < last; ++k) {
+            auto t = (moved.fractions[k] - moved.fractions[first]) / (moved.fractions[last] - moved.fractions[first]);
+            out.emplace_back(moved.vertices[k], anchors[j], anchors[j + 1], t);
+        }
+    }
+}
+
+}
+
+uint32_t get_min_stitch_res(const surface_evaluator& evaluator, face_handle handle, uint32_t max_res) {
+    if (max_res == 0) {
+        return 0;
+    }
+
+    // The end of each segment is the start of the next one
+    auto segments = evaluator.get_face_segments(handle);
+    auto matches = [&](uint32_t res) {
+        for (const auto& segment: segments) {
+            auto t = get_side_coord(segment.side, segment.start) * res;
+            if (abs(t - round(t)) >= PARAM_EPSILON) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    uint32_t res = 1;
+    while (res * 2 <= max_res && !matches(res)) {
+        res *= 2;
+    }
+    return res;
+}
+
+vector<border_stitch> get_border_stitches(
+    const surface_evaluator& evaluator,
+    const vector<face_handle>& faces,
+    const vector<uint32_t>& res
+) {
+    TSL_TRACE_ZONE("get_border_stitches");
+    const auto& mesh = evaluator.get_frozen_tmesh();
+
+    vector<side_samples> sides;
+    dense_half_edge_map<size_t> side_indices;
+    for (uint32_t i = 0; i < faces.size(); ++i) {
+        if (res[i] == 0) {
+            continue;
+        }
+        for (const auto& segment: evaluator.get_face_segments(faces[i])) {
+            side_indices.insert(segment.handle, sides.size());
+            sides.push_back(get_side_samples(i, segment, res[i]));
+        }
+    }
+
+    vector<border_stitch> out;
+
+    // Move the border vertices at each vertex of the tmesh onto the first one, preferring those lying exactly on it.
+    // A border vertex representing more than one vertex of the tmesh is only used for the first one.
+    dense_vertex_map<grid_vertex> corners;
+    set<tuple<uint32_t, uint32_t, uint32_t>> used;
+    for (auto exact: {true, false}) {
+        for (const auto& side: sides) {
+            if (side.exact_target != exact) {
+                continue;
+            }
+            const auto& v = side.vertices.back();
+            if (!used.emplace(v.face, v.x, v.y).second) {
+                continue;
+            }
+            auto target = mesh.get_target(side.handle);
+            if (corners.contains_key(target)) {
+                out.emplace_back(v, corners[target], corners[target], 0.0);
+            } else {
+                corners.insert(target, v);
+            }
+        }
+    }
+
+    // Stitch each edge of the tmesh once
+    for (size_t i = 0; i < sides.size(); ++i) {
+        auto twin = mesh.get_twin(sides[i].handle);
+        if (!side_indices.contains_key(twin) || side_indices[twin] < i) {
+            continue;
+        }
+        const auto& a = sides[i];
+        const auto& b = sides[side_indices[twin]];
+        auto a_is_finer = a.vertices.size() > b.vertices.size()
+            || (a.vertices.size() == b.vertices.size() && a.face > b.face);
+        if (a_is_finer) {
+            stitch_side(a, b, out);
+        } else {
+            stitch_side(b, a, out);
+        }
+    }
+
+    return out;
+}
+
+void stitch_grids(const vector<border_stitch>& stitches, vector<regular_grid>& grids) {
+    for (const auto& stitch: stitches) {
+        const auto& first = grids[stitch.first.face];
+        const auto& second = grids[stitch.second.face];
+        auto pos = mix(first.points[stitch.first.y][stitch.first.x], second.points[stitch.second.y][stitch.second.x], stitch.t);
+        auto normal = mix(first.normals[stitch.first.y][stitch.first.x], second.normals[stitch.second.y][stitch.second.x], stitch.t);
+
+        auto& target = grids[stitch.target.face];
+        target.points[stitch.target.y][stitch.target.x] = pos;
+        target.normals[stitch.target.y][stitch.target.x] = normalize(normal);
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+#include <functional>
+#include <utility>
+
+#include "tsl/evaluation/eval_cache.hpp"
+
+using std::hash;
+using std::move;
+
+namespace tsl {
+
+namespace {
+
+/**
+ * @brief Returns the number of bytes used by the given grid.
+ */
+size_t get_grid_bytes(const regular_grid& grid) {
+    auto rows = grid.points.size() + grid.normals.size();
+    auto points = grid.num_points_x * grid.num_points_y * 2;
+    return sizeof(regular_grid) + rows * sizeof(vector<vec3>) + points * sizeof(vec3);
+}
+
+/**
+ * @brief Passes the points of the given grid to the given sink.
+ */
+void copy_to_sink(const regular_grid& grid, eval_sink& sink) {
+    sink.begin_face(grid.handle, grid.num_points_x, grid.num_points_y);
+    for (size_t y = 0; y < grid.num_points_y; ++y) {
+        for (size_t x = 0; x < grid.num_points_x; ++x) {
+            sink.add_point(x, y, grid.points[y][x], grid.normals[y][x]);
+        }
+    }
+}
+
+}
+
+size_t eval_cache_key_hash::operator()(const eval_cache_key& key) const {
+    // Versions are unique, so the resolution is enough to tell the grids of the same version apart
+    return hash<uint64_t>()(key.version) ^ (hash<uint32_t>()(key.res) << 1u);
+}
+
+eval_cache::eval_cache(size_t max_bytes) : grids(max_bytes), hits(0), misses(0), evaluated() {}
+
+vector<regular_grid> eval_cache::eval_per_face(const surface_evaluator& evaluator, uint32_t res) {
+    vector<regular_grid> out;
+    for (const auto& fh: evaluator.get_frozen_tmesh().get_faces()) {
+        auto grid = eval_face(evaluator, res, fh);
+        if (grid != nullptr) {
+            out.push_back(*grid);
+        }
+    }
+    return out;
+}
+
+void eval_cache::eval_per_face(const surface_evaluator& evaluator, uint32_t res, eval_sink& sink) {
+    for (const auto& fh: evaluator.get_frozen_tmesh().get_faces()) {
+        auto grid = eval_face(evaluator, res, fh);
+        if (grid != nullptr) {
+            copy_to_sink(*grid, sink);
+        }
+    }
+}
+
+vector<regular_grid> eval_cache::eval_faces(
+    const surface_evaluator& evaluator,
+    uint32_t res,
+    const vector<face_handle>& faces
+) {
+    vector<regular_grid> out;
+    out.reserve(faces.size());
+    for (const auto& fh: faces) {
+        auto grid = eval_face(evaluator, res, fh);
+        if (grid != nullptr) {
+            out.push_back(*grid);
+        }
+    }
+    return out;
+}
+
+void eval_cache::eval_faces(
+    const surface_evaluator& evaluator,
+    uint32_t res,
+    const vector<face_handle>& faces,
+    eval_sink& sink
+) {
+    for (const auto& fh: faces) {
+        auto grid = eval_face(evaluator, res, fh);
+        if (grid != nullptr) {
+            copy_to_sink(*grid, sink);
+        }
+    }
+}
+
+void eval_cache::clear() {
+    grids.clear();
+}
+
+void eval_cache::set_max_bytes(size_t max_bytes) {
+    grids.set_max_size(max_bytes);
+}
+
+const regular_grid* eval_cache::eval_face(const surface_evaluator& evaluator, uint32_t res, face_handle handle) {
+    eval_cache_key key(handle, res, evaluator.get_face_version(handle));
+    auto cached = grids.find(key);
+    if (cached != nullptr) {
+        hits += 1;
+        return cached;
+    }
+
+    misses += 1;
+    evaluated.clear();
+    grid_sink sink(evaluated);
+    evaluator.eval_face(res, handle, sink);
+    if (evaluated.empty()) {
+        return nullptr;
+    }
+
+    auto size = get_grid_bytes(evaluated.front());
+    if (size > grids.get_max_size()) {
+        // The grid doesn't fit into the cache at all
+        return &evaluated.front();
+    }
+    grids.insert(key, move(evaluated.front()), size);
+    return grids.find(key);
+}
+
+}
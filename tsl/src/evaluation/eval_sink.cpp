@@ -0,0 +1,19 @@
+#include "tsl/evaluation/eval_sink.hpp"
+
+namespace tsl {
+
+void grid_sink::begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) {
+    auto& grid = grids.emplace_back(handle);
+    grid.num_points_x = num_points_x;
+    grid.num_points_y = num_points_y;
+    grid.points.assign(num_points_y, vector<vec3>(num_points_x));
+    grid.normals.assign(num_points_y, vector<vec3>(num_points_x));
+}
+
+void grid_sink::add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) {
+    auto& grid = grids.back();
+    grid.points[y][x] = pos;
+    grid.normals[y][x] = normal;
+}
+
+}
@@ -24,15 +24,12 @@ const eigen_struct& eigen_cache::get(eigen_handle handle) {
     }
 #endif
 
-    auto& out = (*cache.get(handle)).get();
+    // Each valence is loaded on its first use, all other calls only check the flag without locking
+    std::call_once(loaded[handle.get_idx()], [&]() {
+        cache[handle] = load(handle.get_idx());
+    });
 
-    // If this is not loaded, we got the default element and need to insert it!
-    if (!out.loaded_) {
-        auto val = load(handle.get_idx());
-        out = (cache[handle] = val);
-    }
-
-    return out;
+    return cache[handle];
 }
 
 eigen_struct eigen_cache::load(index valence) {
@@ -146,6 +143,9 @@ void subd_eval (
     uint32_t pow2 = 1 << n;
     u *= pow2;
     v *= pow2;
+
+    // The sub-patch is parametrized by 2 * pow2 * (u, v) (shifted), so derivatives have to be scaled by this factor
+    const double der_scale = 2.0 * pow2;
     if (v < 0.5) {
         k = 1; u = 2*u-1; v = 2*v;
     }
@@ -380,10 +380,10 @@ void subd_eval (
         Upp[3] = .0;
         Upp[2] = .0;
         Upp[1] = 2.;
-        Upp[0] = 3.*u;
-        duu[0] = cblas_ddot (FOUR, &(Upp[0]), INC, &(bx[0]), INC);
-        duu[1] = cblas_ddot (FOUR, &(Upp[0]), INC, &(by[0]), INC);
-        duu[2] = cblas_ddot (FOUR, &(Upp[0]), INC, &(bz[0]), INC);
+        Upp[0] = 6.*u;
+        duu[0] = cblas_ddot (FOUR, &(Upp[0]), INC, &(bx[0]), INC) * der_scale * der_scale;
+        duu[1] = cblas_ddot (FOUR, &(Upp[0]), INC, &(by[0]), INC) * der_scale * der_scale;
+        duu[2] = cblas_ddot (FOUR, &(Upp[0]), INC, &(bz[0]), INC) * der_scale * der_scale;
     }
 
     cblas_dgemv (CblasColMajor, CblasNoTrans, FOUR, FOUR, alpha, &(MGxMt[0]), FOUR, &(Vp[0]), INC, beta, &(bx[0]), INC);
@@ -393,10 +393,15 @@ void subd_eval (
     cblas_dgemv (CblasColMajor, CblasNoTrans, FOUR, FOUR, alpha, &(MGzMt[0]), FOUR, &(Vp[0]), INC, beta, &(bz[0]), INC);
     dv[2] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(bz[0]), INC);
 
+    for (int i = 0; i < 3; ++i) {
+        du[i] *= der_scale;
+        dv[i] *= der_scale;
+    }
+
     if (duv) {
-        duv[0] = cblas_ddot (FOUR, &(Up[0]), INC, &(bx[0]), INC);
-        duv[1] = cblas_ddot (FOUR, &(Up[0]), INC, &(by[0]), INC);
-        duv[2] = cblas_ddot (FOUR, &(Up[0]), INC, &(bz[0]), INC);
+        duv[0] = cblas_ddot (FOUR, &(Up[0]), INC, &(bx[0]), INC) * der_scale * der_scale;
+        duv[1] = cblas_ddot (FOUR, &(Up[0]), INC, &(by[0]), INC) * der_scale * der_scale;
+        duv[2] = cblas_ddot (FOUR, &(Up[0]), INC, &(bz[0]), INC) * der_scale * der_scale;
     }
 
     if (dvv) {
@@ -404,13 +409,13 @@ void subd_eval (
         Vpp[3] = .0;
         Vpp[2] = .0;
         Vpp[1] = 2.;
-        Vpp[0] = 3.*v;
+        Vpp[0] = 6.*v;
         cblas_dgemv (CblasColMajor, CblasNoTrans, FOUR, FOUR, alpha, &(MGxMt[0]), FOUR, &(Vpp[0]), INC, beta, &(bx[0]), INC);
-        dvv[0] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(bx[0]), INC);
+        dvv[0] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(bx[0]), INC) * der_scale * der_scale;
         cblas_dgemv (CblasColMajor, CblasNoTrans, FOUR, FOUR, alpha, &(MGyMt[0]), FOUR, &(Vpp[0]), INC, beta, &(by[0]), INC);
-        dvv[1] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(by[0]), INC);
+        dvv[1] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(by[0]), INC) * der_scale * der_scale;
         cblas_dgemv (CblasColMajor, CblasNoTrans, FOUR, FOUR, alpha, &(MGzMt[0]), FOUR, &(Vpp[0]), INC, beta, &(bz[0]), INC);
-        dvv[2] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(bz[0]), INC);
+        dvv[2] = cblas_ddot (FOUR, &(Uknots[0]), INC, &(bz[0]), INC) * der_scale * der_scale;
     }
 }
 
@@ -0,0 +1,542 @@
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_bvh.hpp"
+#include "tsl/util/panic.hpp"
+
+using std::copy;
+using std::distance;
+using std::lower_bound;
+using std::move;
+using std::nth_element;
+using std::sort;
+using std::numeric_limits;
+using std::optional;
+using std::nullopt;
+using std::vector;
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+
+namespace tsl {
+
+surface_bvh::surface_bvh(const surface_evaluator& evaluator, const vector<regular_grid>& grids) {
+    faces.reserve(grids.size());
+    size_t num_points = 0;
+    for (const auto& grid: grids) {
+        num_points += grid.num_points_x * grid.num_points_y;
+    }
+    points.reserve(num_points);
+
+    for (const auto& grid: grids) {
+        face_entry face(grid.handle, points.size(), grid.num_points_x, grid.num_points_y);
+        for (const auto& row: grid.points) {
+            points.insert(points.end(), row.begin(), row.end());
+        }
+        faces.push_back(face);
+    }
+
+    build_hierarchy(evaluator);
+}
+
+surface_bvh::surface_bvh(
+    const surface_evaluator& evaluator,
+    const vector<face_handle>& handles,
+    const vector<size_t>& sizes,
+    vector<vec3>&& grid_points
+) : points(move(grid_points)) {
+    if (handles.size() != sizes.size()) {
+        panic("got {} faces, but {} grid sizes!", handles.size(), sizes.size());
+    }
+
+    faces.reserve(handles.size());
+    size_t first_point = 0;
+    for (size_t i = 0; i < handles.size(); ++i) {
+        faces.emplace_back(handles[i], first_point, sizes[i], sizes[i]);
+        first_point += sizes[i] * sizes[i];
+    }
+    if (first_point != points.size()) {
+        panic("the grids have {} points, but got {} points!", first_point, points.size());
+    }
+
+    build_hierarchy(evaluator);
+}
+
+void surface_bvh::build_hierarchy(const surface_evaluator& evaluator) {
+    // The faces are searched by their handles in `refit`
+    sort(faces.begin(), faces.end(), [](const auto& a, const auto& b) { return a.handle < b.handle; });
+    for (auto& face: faces) {
+        face.bounds = calc_face_bounds(evaluator, face);
+    }
+
+    if (faces.empty()) {
+        return;
+    }
+
+    face_order.resize(faces.size());
+    for (uint32_t i = 0; i < face_order.size(); ++i) {
+        face_order[i] = i;
+    }
+    face_leaves.resize(faces.size());
+    nodes.reserve(2 * faces.size() / MAX_LEAF_SIZE + 1);
+    build(0, static_cast<uint32_t>(faces.size()), 0);
+}
+
+uint32_t surface_bvh::build(uint32_t first, uint32_t count, uint32_t parent) {
+    auto idx = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(node());
+    nodes[idx].parent = parent;
+
+    aa_box centers;
+    for (uint32_t i = first; i < first + count; ++i) {
+        centers.extend(faces[face_order[i]].bounds.get_center());
+    }
+
+    if (count <= MAX_LEAF_SIZE) {
+        nodes[idx].first = first;
+        nodes[idx].count = count;
+        for (uint32_t i = first; i < first + count; ++i) {
+            face_leaves[face_order[i]] = idx;
+        }
+        update_node_bounds(idx);
+        return idx;
+    }
+
+    // Split at the median of the face centers along the longest axis
+    auto extent = centers.max_corner - centers.min_corner;
+    int axis = 0;
+    if (extent.y > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+
+    auto half = count / 2;
+    auto begin = face_order.begin() + first;
+    nth_element(begin, begin + half, begin + count, [&](uint32_t a, uint32_t b) {
+        auto center_a = faces[a].bounds.get_center()[axis];
+        auto center_b = faces[b].bounds.get_center()[axis];
+        return center_a < center_b || (center_a == center_b && a < b);
+    });
+
+    build(first, half, idx);
+    auto right = build(first + half, count - half, idx);
+    nodes[idx].first = right;
+    nodes[idx].count = 0;
+    update_node_bounds(idx);
+    return idx;
+}
+
+void surface_bvh::refit(const surface_evaluator& evaluator, const vector<regular_grid>& grids) {
+    vector<bool> dirty(nodes.size(), false);
+    for (const auto& grid: grids) {
+        auto idx = find_face(grid.handle);
+        if (!idx) {
+            continue;
+        }
+
+        const auto& face = faces[*idx];
+        if (face.num_points_x != grid.num_points_x || face.num_points_y != grid.num_points_y) {
+            panic("the grid of face {} changed its size, the bvh has to be rebuilt!", grid.handle.get_idx());
+        }
+
+        auto next = points.begin() + face.first_point;
+        for (const auto& row: grid.points) {
+            next = copy(row.begin(), row.end(), next);
+        }
+        refit_face(evaluator, *idx, dirty);
+    }
+    update_dirty_nodes(dirty);
+}
+
+void surface_bvh::refit(
+    const surface_evaluator& evaluator,
+    const vector<face_handle>& handles,
+    const vector<vec3>& grid_points
+) {
+    vector<bool> dirty(nodes.size(), false);
+    auto next = grid_points.begin();
+    for (const auto& handle: handles) {
+        auto idx = find_face(handle);
+        if (!idx) {
+            panic("face {} is not contained in the bvh!", handle.get_idx());
+        }
+
+        const auto& face = faces[*idx];
+        auto num_points = face.num_points_x * face.num_points_y;
+        if (static_cast<size_t>(distance(next, grid_points.end())) < num_points) {
+            panic("got too few points for the grid of face {}!", handle.get_idx());
+        }
+
+        copy(next, next + num_points, points.begin() + face.first_point);
+        next += num_points;
+        refit_face(evaluator, *idx, dirty);
+    }
+    update_dirty_nodes(dirty);
+}
+
+optional<size_t> surface_bvh::find_face(face_handle handle) const {
+    auto it = lower_bound(faces.begin(), faces.end(), handle, [](const auto& face, const auto& handle) {
+        return face.handle < handle;
+    });
+    if (it == faces.end() || it->handle != handle) {
+        return nullopt;
+    }
+    return static_cast<size_t>(distance(faces.begin(), it));
+}
+
+void surface_bvh::refit_face(const surface_evaluator& evaluator, size_t face, vector<bool>& dirty) {
+    faces[face].bounds = calc_face_bounds(evaluator, faces[face]);
+
+    // Mark the path up to the root
+    auto node_idx = face_leaves[face];
+    while (!dirty[node_idx]) {
+        dirty[node_idx] = true;
+        node_idx = nodes[node_idx].parent;
+    }
+}
+
+void surface_bvh::update_dirty_nodes(const vector<bool>& dirty) {
+    // Children are stored behind their parents, so they are updated first
+    for (auto i = nodes.size(); i-- > 0;) {
+        if (dirty[i]) {
+            update_node_bounds(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+aa_box surface_bvh::calc_face_bounds(const surface_evaluator& evaluator, const face_entry& face) const {
+    aa_box bounds;
+    vector<vertex_handle> vertices;
+    evaluator.get_control_vertices(face.handle, vertices);
+    for (const auto& vh: vertices) {
+        bounds.extend(evaluator.get_vertex_pos(vh));
+    }
+
+    // The surface doesn't have to lie inside the convex hull of the control vertices, so the grid points are added
+    auto num_points = face.num_points_x * face.num_points_y;
+    for (size_t i = face.first_point; i < face.first_point + num_points; ++i) {
+        bounds.extend(points[i]);
+    }
+    return bounds;
+}
+
+void surface_bvh::update_node_bounds(uint32_t idx) {
+    auto& current = nodes[idx];
+    current.bounds = aa_box();
+    if (current.count == 0) {
+        current.bounds.extend(nodes[idx + 1].bounds);
+        current.bounds.extend(nodes[current.first].bounds);
+    } else {
+        for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+            current.bounds.extend(faces[face_order[i]].bounds);
+        }
+    }
+}
+
+optional<surface_hit> surface_bvh::intersect(const line& ray) const {
+    return intersect(ray, 0, numeric_limits<double>::infinity());
+}
+
+optional<surface_hit> surface_bvh::intersect(const vec3& start, const vec3& end) const {
+    return intersect(line(start, end - start), 0, 1);
+}
+
+optional<surface_hit> surface_bvh::intersect(const line& line, double t_min, double t_max) const {
+    optional<surface_hit> closest;
+    if (nodes.empty()) {
+        return closest;
+    }
+
+    vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        auto idx = stack.back();
+        stack.pop_back();
+
+        auto max = closest ? closest->t : t_max;
+        const auto& current = nodes[idx];
+        if (!current.bounds.intersect(line, t_min, max)) {
+            continue;
+        }
+
+        if (current.count != 0) {
+            for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+                const auto& face = faces[face_order[i]];
+                if (face.bounds.intersect(line, t_min, closest ? closest->t : t_max)) {
+                    intersect_face(line, t_min, t_max, face, closest);
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first, so more nodes can be skipped
+        auto left = idx + 1;
+        auto right = current.first;
+        auto t_left = nodes[left].bounds.intersect(line, t_min, max);
+        auto t_right = nodes[right].bounds.intersect(line, t_min, max);
+        if (t_left && t_right && *t_right < *t_left) {
+            stack.push_back(left);
+            stack.push_back(right);
+        } else {
+            if (t_right) {
+                stack.push_back(right);
+            }
+            if (t_left) {
+                stack.push_back(left);
+            }
+        }
+    }
+
+    return closest;
+}
+
+void surface_bvh::intersect_face(
+    const line& line,
+    double t_min,
+    double t_max,
+    const face_entry& face,
+    optional<surface_hit>& closest
+) const {
+    auto x = face.num_points_x;
+    auto y = face.num_points_y;
+    if (x < 2 || y < 2) {
+        return;
+    }
+
+    // Möller-Trumbore intersection, which returns (t, b1, b2) with hit = (1 - b1 - b2) * v0 + b1 * v1 + b2 * v2
+    auto intersect_triangle = [&](const vec3& v0, const vec3& v1, const vec3& v2) -> optional<vec3> {
+        auto e1 = v1 - v0;
+        auto e2 = v2 - v0;
+        auto p = cross(line.normal, e2);
+        auto det = dot(e1, p);
+        if (det == 0) {
+            return nullopt;
+        }
+
+        auto inv_det = 1.0 / det;
+        auto s = line.support_vector - v0;
+        auto b1 = dot(s, p) * inv_det;
+        if (b1 < 0 || b1 > 1) {
+            return nullopt;
+        }
+
+        auto q = cross(s, e1);
+        auto b2 = dot(line.normal, q) * inv_det;
+        if (b2 < 0 || b1 + b2 > 1) {
+            return nullopt;
+        }
+
+        return vec3(dot(e2, q) * inv_det, b1, b2);
+    };
+
+    auto max_u = static_cast<double>(x - 1);
+    auto max_v = static_cast<double>(y - 1);
+    auto add_hit = [&](const vec3& hit, double u, double v) {
+        auto t = hit.x;
+        if (t < t_min || t > t_max || (closest && t >= closest->t)) {
+            return;
+        }
+        closest = surface_hit(face.handle, vec2(u / max_u, v / max_v), line.support_vector + t * line.normal, t);
+    };
+
+    // The triangles are the same as in the rendered index buffer
+    for (size_t i = 0; i < y - 1; ++i) {
+        for (size_t j = 0; j < x - 1; ++j) {
+            auto current = face.first_point + j + i * x;
+            const auto& p00 = points[current];
+            const auto& p10 = points[current + 1];
+            const auto& p01 = points[current + x];
+            const auto& p11 = points[current + x + 1];
+
+            if (auto hit = intersect_triangle(p00, p01, p10)) {
+                add_hit(*hit, j + hit->z, i + hit->y);
+            }
+            if (auto hit = intersect_triangle(p10, p01, p11)) {
+                add_hit(*hit, j + 1 - hit->y, i + hit->y + hit->z);
+            }
+        }
+    }
+}
+
+optional<surface_hit> surface_bvh::closest_point(const vec3& point) const {
+    optional<surface_hit> closest;
+    if (nodes.empty()) {
+        return closest;
+    }
+
+    vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        auto idx = stack.back();
+        stack.pop_back();
+
+        const auto& current = nodes[idx];
+        if (closest && current.bounds.squared_distance(point) >= closest->t * closest->t) {
+            continue;
+        }
+
+        if (current.count != 0) {
+            for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+                const auto& face = faces[face_order[i]];
+                if (!closest || face.bounds.squared_distance(point) < closest->t * closest->t) {
+                    closest_point_face(point, face, closest);
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first, so more nodes can be skipped
+        auto left = idx + 1;
+        auto right = current.first;
+        if (nodes[right].bounds.squared_distance(point) < nodes[left].bounds.squared_distance(point)) {
+            stack.push_back(left);
+            stack.push_back(right);
+        } else {
+            stack.push_back(right);
+            stack.push_back(left);
+        }
+    }
+
+    return closest;
+}
+
+vector<surface_hit> surface_bvh::closest_points(const vec3& point, double max_dist) const {
+    vector<surface_hit> out;
+    if (nodes.empty()) {
+        return out;
+    }
+
+    auto max_dist2 = max_dist * max_dist;
+    vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        auto idx = stack.back();
+        stack.pop_back();
+
+        const auto& current = nodes[idx];
+        if (current.bounds.squared_distance(point) >= max_dist2) {
+            continue;
+        }
+
+        if (current.count != 0) {
+            for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+                const auto& face = faces[face_order[i]];
+                if (face.bounds.squared_distance(point) < max_dist2) {
+                    optional<surface_hit> closest;
+                    closest_point_face(point, face, closest);
+                    if (closest) {
+                        out.push_back(*closest);
+                    }
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(current.first);
+        stack.push_back(idx + 1);
+    }
+
+    return out;
+}
+
+void surface_bvh::closest_point_face(const vec3& point, const face_entry& face, optional<surface_hit>& closest) const {
+    auto x = face.num_points_x;
+    auto y = face.num_points_y;
+    if (x < 2 || y < 2) {
+        return;
+    }
+
+    // Closest point on a triangle by testing the voronoi regions of its vertices, edges and face (see "Real-Time
+    // Collision Detection" by Christer Ericson), which returns (b1, b2) with p = (1 - b1 - b2) * v0 + b1 * v1 + b2 * v2
+    auto closest_on_triangle = [&](const vec3& v0, const vec3& v1, const vec3& v2) -> vec2 {
+        auto e1 = v1 - v0;
+        auto e2 = v2 - v0;
+        auto p0 = point - v0;
+        auto d1 = dot(e1, p0);
+        auto d2 = dot(e2, p0);
+        if (d1 <= 0 && d2 <= 0) {
+            return vec2(0, 0);
+        }
+
+        auto p1 = point - v1;
+        auto d3 = dot(e1, p1);
+        auto d4 = dot(e2, p1);
+        if (d3 >= 0 && d4 <= d3) {
+            return vec2(1, 0);
+        }
+
+        auto vc = d1 * d4 - d3 * d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+            return vec2(d1 / (d1 - d3), 0);
+        }
+
+        auto p2 = point - v2;
+        auto d5 = dot(e1, p2);
+        auto d6 = dot(e2, p2);
+        if (d6 >= 0 && d5 <= d6) {
+            return vec2(0, 1);
+        }
+
+        auto vb = d5 * d2 - d1 * d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+            return vec2(0, d2 / (d2 - d6));
+        }
+
+        auto va = d3 * d6 - d5 * d4;
+        if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+            auto w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return vec2(1 - w, w);
+        }
+
+        auto denom = 1.0 / (va + vb + vc);
+        return vec2(vb * denom, vc * denom);
+    };
+
+    auto max_u = static_cast<double>(x - 1);
+    auto max_v = static_cast<double>(y - 1);
+    auto add_hit = [&](const vec3& v0, const vec3& v1, const vec3& v2, const vec2& b, double u, double v) {
+        auto p = v0 + b.x * (v1 - v0) + b.y * (v2 - v0);
+        auto dist = length(p - point);
+        if (closest && dist >= closest->t) {
+            return;
+        }
+        closest = surface_hit(face.handle, vec2(u / max_u, v / max_v), p, dist);
+    };
+
+    // Same triangles and parametrization as in `intersect_face`
+    for (size_t i = 0; i < y - 1; ++i) {
+        for (size_t j = 0; j < x - 1; ++j) {
+            auto current = face.first_point + j + i * x;
+            const auto& p00 = points[current];
+            const auto& p10 = points[current + 1];
+            const auto& p01 = points[current + x];
+            const auto& p11 = points[current + x + 1];
+
+            auto b = closest_on_triangle(p00, p01, p10);
+            add_hit(p00, p01, p10, b, j + b.y, i + b.x);
+            b = closest_on_triangle(p10, p01, p11);
+            add_hit(p10, p01, p11, b, j + 1 - b.x, i + b.x + b.y);
+        }
+    }
+}
+
+size_t surface_bvh::num_faces() const {
+    return faces.size();
+}
+
+aa_box surface_bvh::get_bounds() const {
+    if (nodes.empty()) {
+        return aa_box();
+    }
+    return nodes[0].bounds;
+}
+
+}
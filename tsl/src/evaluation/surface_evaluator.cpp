@@ -1,3 +1,5 @@
+#include <cmath>
+#include <optional>
 #include <vector>
 #include <algorithm>
 #include <utility>
@@ -13,66 +15,171 @@
 #include "tsl/evaluation/bsplines.hpp"
 #include "tsl/util/panic.hpp"
 #include "tsl/util/println.hpp"
+#include "tsl/util/parallel.hpp"
+#include "tsl/util/trace.hpp"
 #include "tsl/algorithm/reduction.hpp"
 
 using std::vector;
+using std::abs;
+using std::optional;
 using std::min;
 using std::max;
 using std::move;
 using std::tie;
+using std::get;
 using std::queue;
+using std::sort;
+using std::unique;
 
 using glm::value_ptr;
 using fmt::format;
 
 namespace tsl {
 
-surface_evaluator::surface_evaluator(tmesh&& mesh):
-    config(), mesh(move(mesh)), uv(), dir(), edge_trans(), support(), knots(), handles(), knot_vectors() {
+surface_evaluator::surface_evaluator(tmesh&& mesh) : surface_evaluator(move(mesh), evaluator_config()) {}
+
+surface_evaluator::surface_evaluator(tmesh&& mesh, evaluator_config config):
+    config(config), mesh(move(mesh)), frozen(), uv(), dir(), edge_trans(), support(), knots(), handles(), knot_vectors(),
+    edit_depth(0), edited_structure(false) {
     update_cache();
 }
 
 vector<regular_grid> surface_evaluator::eval_per_face(uint32_t res) const {
+    atomic<bool> never_cancelled(false);
+    return eval_per_face(res, never_cancelled);
+}
+
+void surface_evaluator::eval_per_face(uint32_t res, eval_sink& sink) const {
+    atomic<bool> never_cancelled(false);
+    eval_per_face(res, sink, never_cancelled);
+}
+
+vector<regular_grid> surface_evaluator::eval_per_face(uint32_t res, const atomic<bool>& cancelled) const {
+    TSL_TRACE_ZONE("eval_per_face");
     vector<regular_grid> out;
-    out.reserve(mesh.num_faces());
+    out.reserve(frozen.num_faces());
+    grid_sink sink(out);
+    eval_per_face(res, sink, cancelled);
+    return out;
+}
 
+void surface_evaluator::eval_per_face(uint32_t res, eval_sink& sink, const atomic<bool>& cancelled) const {
     // This buffer will be used in the loop to store vertex handles. To reduce allocations we reuse the buffer
     // and start with a estimated size of 10.
     vector<vertex_handle> vertices_buffer;
     vertices_buffer.reserve(10);
-    for (const auto& fh: mesh.get_faces()) {
-        auto contains_extraordinary_vertex = false;
-        auto contains_invalid_valence = false;
-        vertices_buffer.clear();
-        mesh.get_vertices_of_face(fh, vertices_buffer);
-        for (const auto& vh: vertices_buffer) {
-            if (mesh.is_extraordinary(vh)) {
-                contains_extraordinary_vertex = true;
-            }
-            // TODO: this will be fixed, when evaluation near borders is implemented; or not: if not, we should throw
-            //       a warning!
-            if (mesh.get_valence(vh) < 3) {
-                contains_invalid_valence = true;
-                report_error(format("invalid valence at vertex with handle id: {}", vh.get_idx()));
-            }
+    for (const auto& fh: frozen.get_faces()) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            break;
         }
+        eval_face(res, fh, vertices_buffer, sink);
+    }
+}
 
-        if (contains_extraordinary_vertex) {
-            if (!contains_invalid_valence) {
-                auto grid = eval_subdevision(res, fh);
-                out.emplace_back(grid);
-            }
-        } else {
-            auto grid = eval_bsplines(res, fh);
-            out.emplace_back(grid);
+vector<regular_grid> surface_evaluator::eval_faces(uint32_t res, const vector<face_handle>& faces) const {
+    vector<regular_grid> out;
+    out.reserve(faces.size());
+    grid_sink sink(out);
+    eval_faces(res, faces, sink);
+    return out;
+}
+
+void surface_evaluator::eval_faces(uint32_t res, const vector<face_handle>& faces, eval_sink& sink) const {
+    TSL_TRACE_ZONE("eval_faces");
+    vector<vertex_handle> vertices_buffer;
+    vertices_buffer.reserve(10);
+    for (const auto& fh: faces) {
+        eval_face(res, fh, vertices_buffer, sink);
+    }
+}
+
+void surface_evaluator::eval_face(uint32_t res, face_handle handle, eval_sink& sink) const {
+    vector<vertex_handle> vertices_buffer;
+    eval_face(res, handle, vertices_buffer, sink);
+}
+
+void surface_evaluator::eval_face(
+    uint32_t res,
+    face_handle handle,
+    vector<vertex_handle>& vertices_buffer,
+    eval_sink& sink
+) const {
+    auto contains_extraordinary_vertex = false;
+    auto contains_invalid_valence = false;
+    vertices_buffer.clear();
+    frozen.get_vertices_of_face(handle, vertices_buffer);
+    for (const auto& vh: vertices_buffer) {
+        if (frozen.is_extraordinary(vh)) {
+            contains_extraordinary_vertex = true;
+        }
+        // TODO: this will be fixed, when evaluation near borders is implemented; or not: if not, we should throw
+        //       a warning!
+        if (frozen.get_valence(vh) < 3) {
+            contains_invalid_valence = true;
+            report_error(format("invalid valence at vertex with handle id: {}", vh.get_idx()));
         }
     }
 
+    if (contains_extraordinary_vertex) {
+        if (!contains_invalid_valence) {
+            eval_subdevision(res, handle, sink);
+        }
+    } else {
+        eval_bsplines(res, handle, sink);
+    }
+}
+
+vector<face_handle> surface_evaluator::get_affected_faces(const set<vertex_handle>& vertices) const {
+    vector<face_handle> out;
+    for (const auto& vh: vertices) {
+        if (!dependent_faces.contains_key(vh)) {
+            continue;
+        }
+        const auto& faces = dependent_faces[vh];
+        out.insert(out.end(), faces.begin(), faces.end());
+    }
+
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
     return out;
+}
+
+void surface_evaluator::get_control_vertices(face_handle handle, vector<vertex_handle>& out) const {
+    frozen.get_vertices_of_face(handle, out);
 
+    auto contains_extraordinary_vertex = false;
+    auto contains_invalid_valence = false;
+    for (const auto& vh: out) {
+        contains_extraordinary_vertex |= frozen.is_extraordinary(vh);
+        contains_invalid_valence |= frozen.get_valence(vh) < 3;
+    }
+
+    // The control points of the subdevision for faces with extraordinary vertices and the vertices of the basis
+    // functions in the support otherwise (see `eval_face`)
+    out.clear();
+    if (contains_extraordinary_vertex) {
+        if (!contains_invalid_valence) {
+            out = get_vertices_for_subd(handle);
+            sort(out.begin(), out.end());
+            out.erase(unique(out.begin(), out.end()), out.end());
+        }
+    } else {
+        // Every vertex is contained at most once in the support of a face
+        for (const auto& entry: support[handle]) {
+            out.push_back(entry.vertex);
+        }
+    }
 }
 
 regular_grid surface_evaluator::eval_bsplines(uint32_t res, face_handle handle) const {
+    vector<regular_grid> out;
+    grid_sink sink(out);
+    eval_bsplines(res, handle, sink);
+    return move(out.front());
+}
+
+void surface_evaluator::eval_bsplines(uint32_t res, face_handle handle, eval_sink& sink) const {
+    TSL_TRACE_ZONE("eval_bsplines");
     auto local_system_max = get_max_coords(handle);
     double u_coord = local_system_max.x;
     double v_coord = local_system_max.y;
@@ -81,31 +188,19 @@ regular_grid surface_evaluator::eval_bsplines(uint32_t res, face_handle handle)
     double step_u = u_coord / res;
     double step_v = v_coord / res;
 
-    regular_grid grid(handle);
-    grid.points.reserve(static_cast<size_t>(v_max));
-    grid.normals.reserve(static_cast<size_t>(v_max));
-    grid.num_points_x = u_max;
-    grid.num_points_y = v_max;
+    sink.begin_face(handle, u_max, v_max);
 
     double current_u = 0;
     double current_v = 0;
     for (uint32_t v = 0; v < v_max; ++v) {
         current_u = 0;
-        vector<vec3> row;
-        vector<vec3> normal_row;
-        row.reserve(static_cast<size_t>(u_max));
-        normal_row.reserve(static_cast<size_t>(u_max));
         for (uint32_t u = 0; u < u_max; ++u) {
             auto[point, du, dv] = eval_bsplines_point(min(current_u, u_coord), min(current_v, v_coord), handle);
-            row.push_back(point);
-            normal_row.push_back(normalize(cross(du, dv)));
+            sink.add_point(u, v, point, normalize(cross(du, dv)));
             current_u += step_u;
         }
-        grid.points.push_back(row);
-        grid.normals.push_back(normal_row);
         current_v += step_v;
     }
-    return grid;
 }
 
 array<vec3, 3> surface_evaluator::eval_bsplines_point(double u, double v, face_handle f) const {
@@ -117,15 +212,15 @@ array<vec3, 3> surface_evaluator::eval_bsplines_point(double u, double v, face_h
     double dv = 0;
     vec2 in(u, v);
 
-    const auto& supports = support[f];
-    for (const auto& [vertex, idx, trans]: supports) {
-        const auto& local_knots = knot_vectors[vertex][idx];
+    const auto& all_knots = knot_vectors.get_values();
+    for (const auto& [vertex, idx, basis_fun, trans]: support[f]) {
+        const auto& local_knots = all_knots[basis_fun];
 
-        const auto& p = mesh.get_vertex_position(vertex);
+        const auto& p = frozen.get_vertex_position(vertex);
         auto transformed = trans.apply(in);
 
-        auto u_basis = get_bspline_with_der<3>(transformed.x, local_knots.u);
-        auto v_basis = get_bspline_with_der<3>(transformed.y, local_knots.v);
+        auto u_basis = get_bspline_with_der<3>(transformed.x, local_knots.u.data());
+        auto v_basis = get_bspline_with_der<3>(transformed.y, local_knots.v.data());
 
         c += u_basis.x * v_basis.x * p;
         d += u_basis.x * v_basis.x;
@@ -169,6 +264,14 @@ array<vec3, 3> surface_evaluator::eval_bsplines_point(double u, double v, face_h
 }
 
 regular_grid surface_evaluator::eval_subdevision(uint32_t res, face_handle handle) const {
+    vector<regular_grid> out;
+    grid_sink sink(out);
+    eval_subdevision(res, handle, sink);
+    return move(out.front());
+}
+
+void surface_evaluator::eval_subdevision(uint32_t res, face_handle handle, eval_sink& sink) const {
+    TSL_TRACE_ZONE("eval_subdevision");
     auto local_system_max = get_max_coords(handle);
     double u_coord = local_system_max.x;
     double v_coord = local_system_max.y;
@@ -177,38 +280,18 @@ regular_grid surface_evaluator::eval_subdevision(uint32_t res, face_handle handl
     double step_u = u_coord / res;
     double step_v = v_coord / res;
 
-    regular_grid grid(handle);
-    grid.points.reserve(static_cast<size_t>(v_max));
-    grid.normals.reserve(static_cast<size_t>(v_max));
-    grid.num_points_x = u_max;
-    grid.num_points_y = v_max;
+    sink.begin_face(handle, u_max, v_max);
 
     // TODO: This can be cached!
-    auto neighbours = get_vertices_for_subd(handle);
     vector<double> x_coords;
     vector<double> y_coords;
     vector<double> z_coords;
-    x_coords.reserve(neighbours.size());
-    y_coords.reserve(neighbours.size());
-    z_coords.reserve(neighbours.size());
-    for (const auto& vh: neighbours) {
-        auto pos = mesh.get_vertex_position(vh);
-        x_coords.push_back(pos.x);
-        y_coords.push_back(pos.y);
-        z_coords.push_back(pos.z);
-    }
-
-    auto extraordinary_vertex = neighbours.front();
-    auto valence = mesh.get_valence(extraordinary_vertex);
+    auto valence = get_subd_control_points(handle, x_coords, y_coords, z_coords);
 
     double current_u = 0;
     double current_v = 0;
     for (uint32_t v = 0; v < v_max; ++v) {
         current_u = 0;
-        vector<vec3> pos_row;
-        vector<vec3> normal_row;
-        pos_row.reserve(static_cast<size_t>(u_max));
-        normal_row.reserve(static_cast<size_t>(u_max));
         for (uint32_t u = 0; u < u_max; ++u) {
             auto ud = min(current_u / u_coord, u_coord);
             auto vd = min(current_v / v_coord, v_coord);
@@ -229,24 +312,157 @@ regular_grid surface_evaluator::eval_subdevision(uint32_t res, face_handle handl
                 nullptr,
                 nullptr
             );
-            pos_row.push_back(point);
-            normal_row.push_back(normalize(cross(du, dv)));
+            sink.add_point(u, v, point, normalize(cross(du, dv)));
             current_u += step_u;
         }
-        grid.points.push_back(pos_row);
-        grid.normals.push_back(normal_row);
         current_v += step_v;
     }
-    return grid;
+}
+
+size_t surface_evaluator::get_subd_control_points(
+    face_handle handle,
+    vector<double>& x_coords,
+    vector<double>& y_coords,
+    vector<double>& z_coords
+) const {
+    auto neighbours = get_vertices_for_subd(handle);
+    x_coords.reserve(neighbours.size());
+    y_coords.reserve(neighbours.size());
+    z_coords.reserve(neighbours.size());
+    for (const auto& vh: neighbours) {
+        auto pos = frozen.get_vertex_position(vh);
+        x_coords.push_back(pos.x);
+        y_coords.push_back(pos.y);
+        z_coords.push_back(pos.z);
+    }
+
+    auto extraordinary_vertex = neighbours.front();
+    return frozen.get_valence(extraordinary_vertex);
+}
+
+array<vec3, 3> surface_evaluator::eval_point(face_handle handle, const vec2& uv) const {
+    vector<vertex_handle> vertices;
+    frozen.get_vertices_of_face(handle, vertices);
+    auto contains_extraordinary_vertex = false;
+    for (const auto& vh: vertices) {
+        contains_extraordinary_vertex |= frozen.is_extraordinary(vh);
+        if (frozen.get_valence(vh) < 3) {
+            panic("face {} contains a vertex with invalid valence and can't be evaluated!", handle.get_idx());
+        }
+    }
+
+    if (!contains_extraordinary_vertex) {
+        auto local_system_max = get_max_coords(handle);
+        auto[point, du, dv] = eval_bsplines_point(uv.x * local_system_max.x, uv.y * local_system_max.y, handle);
+        return {point, du * local_system_max.x, dv * local_system_max.y};
+    }
+
+    vector<double> x_coords;
+    vector<double> y_coords;
+    vector<double> z_coords;
+    auto valence = get_subd_control_points(handle, x_coords, y_coords, z_coords);
+
+    auto u = uv.x;
+    auto v = uv.y;
+    vec3 point;
+    vec3 du;
+    vec3 dv;
+    subd_eval(
+        u,
+        v,
+        2 * valence + 8,
+        x_coords.data(),
+        y_coords.data(),
+        z_coords.data(),
+        value_ptr(point),
+        value_ptr(du),
+        value_ptr(dv),
+        nullptr,
+        nullptr,
+        nullptr
+    );
+    return {point, du, dv};
+}
+
+vector<face_segment> surface_evaluator::get_face_segments(face_handle handle) const {
+    auto half_edges = frozen.get_half_edges_of_face(handle);
+    auto n = half_edges.size();
+    vector<face_segment> out;
+
+    // Faces with an extraordinary vertex are evaluated with the extraordinary vertex at (0, 0) and the half edge
+    // leaving it along v = 0 (see `get_vertices_for_subd`)
+    optional<size_t> extraordinary;
+    for (size_t i = 0; i < n; ++i) {
+        if (frozen.is_extraordinary(frozen.get_target(half_edges[i]))) {
+            extraordinary = i;
+        }
+    }
+    if (extraordinary) {
+        if (n != 4) {
+            return out;
+        }
+        const array<vec2, 4> corners = {vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1)};
+        for (uint8_t i = 0; i < 4; ++i) {
+            auto h = half_edges[(*extraordinary + 1 + i) % n];
+            out.emplace_back(h, i, corners[i], corners[(i + 1) % 4]);
+        }
+        return out;
+    }
+
+    // The local coords of a half edge are the coords of its target. The coords of the last half edge accumulate
+    // rounding errors, so all coords are snapped to the border of the face.
+    auto snap = [](double value) {
+        if (abs(value) < SNAP_EPSILON) {
+            return 0.0;
+        }
+        if (abs(value - 1) < SNAP_EPSILON) {
+            return 1.0;
+        }
+        return value;
+    };
+    auto local_system_max = get_max_coords(handle);
+    for (size_t i = 0; i < n; ++i) {
+        auto h = half_edges[i];
+        auto prev = half_edges[(i + n - 1) % n];
+        auto start = uv[prev] / local_system_max;
+        auto end = uv[h] / local_system_max;
+        out.emplace_back(h, dir[h], vec2(snap(start.x), snap(start.y)), vec2(snap(end.x), snap(end.y)));
+    }
+    return out;
+}
+
+uint64_t surface_evaluator::get_face_version(face_handle handle) const {
+    return face_versions.contains_key(handle) ? face_versions[handle] : 0;
+}
+
+memory_usage_report surface_evaluator::memory_report() const {
+    memory_usage_report out;
+    out.add("mesh", mesh.memory_report());
+    out.add("frozen", frozen.memory_report());
+    out.add("uv", uv.get_memory_usage());
+    out.add("dir", dir.get_memory_usage());
+    out.add("edge_trans", edge_trans.get_memory_usage());
+    out.add("support", support.get_memory_usage());
+    out.add("knots", knots.get_memory_usage());
+    out.add("handles", handles.get_memory_usage());
+    out.add("knot_vectors", knot_vectors.get_memory_usage());
+    out.add("dependent_faces", dependent_faces.get_memory_usage());
+    out.add("face_versions", face_versions.get_memory_usage());
+    out.add("face_fingerprints", face_fingerprints.get_memory_usage());
+    return out;
 }
 
 const tmesh& surface_evaluator::get_tmesh() const {
     return mesh;
 }
 
+const frozen_tmesh& surface_evaluator::get_frozen_tmesh() const {
+    return frozen;
+}
+
 vec2 surface_evaluator::get_max_coords(face_handle handle) const {
     vec2 out(0, 0);
-    for (const auto& eh: mesh.get_half_edges_of_face(handle)) {
+    for (const auto& eh: frozen.get_half_edges_of_face(handle)) {
         // Check u direction
         if (dir[eh] % 2 == 0) {
             out.x = max(out.x, uv[eh].x);
@@ -262,10 +478,44 @@ vec2 surface_evaluator::get_max_coords(face_handle handle) const {
 // = T-Mesh modifier
 // ========================================================================
 
+void surface_evaluator::begin_edits() {
+    edit_depth += 1;
+}
+
+void surface_evaluator::commit_edits() {
+    if (edit_depth == 0) {
+        panic("commit_edits called without begin_edits");
+    }
+
+    edit_depth -= 1;
+    if (edit_depth > 0) {
+        return;
+    }
+
+    edit_field.reset();
+    if (edited_structure) {
+        edited_structure = false;
+        update_cache();
+    }
+}
+
+bool surface_evaluator::is_editing() const {
+    return edit_depth > 0;
+}
+
 bool surface_evaluator::remove_edge(edge_handle handle, bool keep_vertices) {
-    auto res = mesh.remove_edge(handle, keep_vertices);
+    bool res;
+    if (is_editing()) {
+        if (!edit_field) {
+            edit_field.emplace(mesh);
+        }
+        res = mesh.remove_edge(handle, *edit_field, keep_vertices);
+    } else {
+        res = mesh.remove_edge(handle, keep_vertices);
+    }
+
     if (res) {
-        update_cache();
+        structure_changed();
     }
     return res;
 }
@@ -274,14 +524,43 @@ size_t surface_evaluator::remove_edges(double percent) {
     auto deleted = ::tsl::remove_edges(mesh, percent);
 
     if (deleted > 0) {
-        update_cache();
+        // The edges were removed without the distance field of the edit transaction, so it is outdated
+        edit_field.reset();
+        structure_changed();
+    }
+
+    return deleted;
+}
+
+size_t surface_evaluator::remove_edges_batch(const batch_reduction_config& config) {
+    auto deleted = ::tsl::remove_edges_batch(mesh, config);
+
+    if (deleted > 0) {
+        // The edges were removed without the distance field of the edit transaction, so it is outdated
+        edit_field.reset();
+        structure_changed();
     }
 
     return deleted;
 }
 
-vec3& surface_evaluator::get_vertex_pos(vertex_handle handle) {
-    return mesh.get_vertex_position(handle);
+vec3 surface_evaluator::get_vertex_pos(vertex_handle handle) const {
+    return frozen.get_vertex_position(handle);
+}
+
+void surface_evaluator::set_vertex_pos(vertex_handle handle, const vec3& pos) {
+    // Moving a vertex doesn't change the structure of the mesh, so the caches stay valid. During an edit transaction
+    // the vertex may only be left in the snapshot.
+    if (mesh.contains(handle)) {
+        mesh.get_vertex_position(handle) = pos;
+    }
+    frozen.set_vertex_position(handle, pos);
+
+    if (dependent_faces.contains_key(handle)) {
+        for (const auto& fh: dependent_faces[handle]) {
+            face_versions[fh] = next_version++;
+        }
+    }
 }
 
 // ========================================================================
@@ -291,9 +570,9 @@ vec3& surface_evaluator::get_vertex_pos(vertex_handle handle) {
 vector<vertex_handle> surface_evaluator::get_vertices_for_subd(face_handle handle) const {
     // Find extraordinary vertex and edge pointing to it.
     optional<pair<vertex_handle, half_edge_handle>> found;
-    for (const auto& eh: mesh.get_half_edges_of_face(handle)) {
-        auto vh = mesh.get_target(eh);
-        if (mesh.is_extraordinary(vh)) {
+    for (const auto& eh: frozen.get_half_edges_of_face(handle)) {
+        auto vh = frozen.get_target(eh);
+        if (frozen.is_extraordinary(vh)) {
             found = make_pair(vh, eh);
         }
     }
@@ -307,45 +586,45 @@ vector<vertex_handle> surface_evaluator::get_vertices_for_subd(face_handle handl
 
     // Get vertices in order given by Stam's paper (Fig. 3)
     vector<vertex_handle> out;
-    auto valence = mesh.get_valence(extraordinary_vertex);
+    auto valence = frozen.get_valence(extraordinary_vertex);
     out.reserve(2 * valence + 8);
 
     auto h = start_edge;
     out.push_back(extraordinary_vertex);
-    h = mesh.get_next(mesh.get_next(mesh.get_twin(h)));
+    h = frozen.get_next(frozen.get_next(frozen.get_twin(h)));
     auto h2 = h;
     do {
-        out.push_back(mesh.get_target(h));
-        h = mesh.get_prev(h);
-        out.push_back(mesh.get_target(h));
-        h = mesh.get_prev(mesh.get_twin(mesh.get_prev(h)));
+        out.push_back(frozen.get_target(h));
+        h = frozen.get_prev(h);
+        out.push_back(frozen.get_target(h));
+        h = frozen.get_prev(frozen.get_twin(frozen.get_prev(h)));
     } while (h != h2);
 
     // Points from 7 to 2N+5
-    h = mesh.get_next(mesh.get_twin(mesh.get_next(mesh.get_next(mesh.get_next(mesh.get_twin(mesh.get_next(start_edge)))))));
-    auto twon5 = mesh.get_target(h);
+    h = frozen.get_next(frozen.get_twin(frozen.get_next(frozen.get_next(frozen.get_next(frozen.get_twin(frozen.get_next(start_edge)))))));
+    auto twon5 = frozen.get_target(h);
 
-    h = mesh.get_next(h);
-    auto twon4 = mesh.get_target(h);
+    h = frozen.get_next(h);
+    auto twon4 = frozen.get_target(h);
 
-    h = mesh.get_next(mesh.get_twin(mesh.get_next(h)));
-    auto twon3 = mesh.get_target(h);
+    h = frozen.get_next(frozen.get_twin(frozen.get_next(h)));
+    auto twon3 = frozen.get_target(h);
 
     // Add 2N+2 and saved vertices
-    h = mesh.get_next(mesh.get_twin(mesh.get_next(h)));
-    out.push_back(mesh.get_target(h));
+    h = frozen.get_next(frozen.get_twin(frozen.get_next(h)));
+    out.push_back(frozen.get_target(h));
     out.push_back(twon3);
     out.push_back(twon4);
     out.push_back(twon5);
 
-    h = mesh.get_next(h);
-    out.push_back(mesh.get_target(h));
+    h = frozen.get_next(h);
+    out.push_back(frozen.get_target(h));
 
-    h = mesh.get_next(mesh.get_twin(mesh.get_next(h)));
-    out.push_back(mesh.get_target(h));
+    h = frozen.get_next(frozen.get_twin(frozen.get_next(h)));
+    out.push_back(frozen.get_target(h));
 
-    h = mesh.get_next(mesh.get_twin(mesh.get_next(h)));
-    out.push_back(mesh.get_target(h));
+    h = frozen.get_next(frozen.get_twin(frozen.get_next(h)));
+    out.push_back(frozen.get_target(h));
 
     return out;
 }
@@ -355,18 +634,18 @@ aa_rectangle surface_evaluator::get_parametric_domain(vertex_handle handle, size
 
     // Get face
     auto [h, q] = handles[handle][handle_index];
-    auto face_h = mesh.get_face_of_half_edge(h).expect(EXPECT_NO_BORDER);
+    auto face_h = frozen.get_face_of_half_edge(h).expect(EXPECT_NO_BORDER);
 
     // Get neighbouring face
     auto wrapped_index = (handles[handle].size() + handle_index - 1) % handles[handle].size();
     auto [nh, nq] = handles[handle][wrapped_index];
-    auto nface_h = mesh.get_face_of_half_edge(nh).expect(EXPECT_NO_BORDER);
+    auto nface_h = frozen.get_face_of_half_edge(nh).expect(EXPECT_NO_BORDER);
 
     // Only calc the scale factor, if we are NOT at a t-joint
     double scale_factor = 1;
     if (face_h != nface_h) {
-        auto separating_edge = mesh.get_half_edge_between(face_h, nface_h).expect(EXPECT_NO_BORDER);
-        scale_factor = expect(mesh.get_knot_factor(separating_edge), EXPECT_NO_BORDER);
+        auto separating_edge = frozen.get_half_edge_between(face_h, nface_h).expect(EXPECT_NO_BORDER);
+        scale_factor = expect(frozen.get_knot_factor(separating_edge), EXPECT_NO_BORDER);
     }
 
     auto sum_knot_vectors2 = knots[handle][wrapped_index][0] + knots[handle][wrapped_index][1];
@@ -380,22 +659,22 @@ local_knot_vectors surface_evaluator::get_knot_vectors(vertex_handle handle, siz
 
     // Get half edge and face corresponding to the current handle
     auto [edge_h0, tag0] = handles[handle][handle_index];
-    auto face_h0 = mesh.get_face_of_half_edge(edge_h0).expect(EXPECT_NO_BORDER);
+    auto face_h0 = frozen.get_face_of_half_edge(edge_h0).expect(EXPECT_NO_BORDER);
 
     // Get half edge and face handle for index + 1 cw
     auto index1 = (handles[handle].size() + handle_index + 1) % handles[handle].size();
     auto [edge_h1, tag1] = handles[handle][index1];
-    auto face_h1 = mesh.get_face_of_half_edge(edge_h1).expect(EXPECT_NO_BORDER);
+    auto face_h1 = frozen.get_face_of_half_edge(edge_h1).expect(EXPECT_NO_BORDER);
 
     // Get half edge and face handle for index - 1 cw (which is + 1 ccw)
     auto index_1 = (handles[handle].size() + handle_index - 1) % handles[handle].size();
     auto [edge_h_1, tag_1] = handles[handle][index_1];
-    auto face_h_1 = mesh.get_face_of_half_edge(edge_h_1).expect(EXPECT_NO_BORDER);
+    auto face_h_1 = frozen.get_face_of_half_edge(edge_h_1).expect(EXPECT_NO_BORDER);
 
     // Get half edge and face handle for index - 2 cw (which is + 2 ccw)
     auto index_2 = (handles[handle].size() + handle_index - 2) % handles[handle].size();
     auto [edge_h_2, tag_2] = handles[handle][index_2];
-    auto face_h_2 = mesh.get_face_of_half_edge(edge_h_2).expect(EXPECT_NO_BORDER);
+    auto face_h_2 = frozen.get_face_of_half_edge(edge_h_2).expect(EXPECT_NO_BORDER);
 
     // Get two knot values for current handle
     auto knot01 = knots[handle][handle_index][0];
@@ -404,8 +683,8 @@ local_knot_vectors surface_evaluator::get_knot_vectors(vertex_handle handle, siz
     // Get transformation from values from hindex + 1 into domain of handle
     double transform_01 = 1;
     if (face_h0 != face_h1) {
-        auto edge_bewteen_0_and1 = mesh.get_half_edge_between(face_h0, face_h1).expect(EXPECT_NO_BORDER);
-        transform_01 = expect(mesh.get_knot_factor(edge_bewteen_0_and1), EXPECT_NO_BORDER);
+        auto edge_bewteen_0_and1 = frozen.get_half_edge_between(face_h0, face_h1).expect(EXPECT_NO_BORDER);
+        transform_01 = expect(frozen.get_knot_factor(edge_bewteen_0_and1), EXPECT_NO_BORDER);
     }
 
     // Get two knot values for handle with index + 1 and transform them into the domain of the current handle
@@ -415,8 +694,8 @@ local_knot_vectors surface_evaluator::get_knot_vectors(vertex_handle handle, siz
     // Get transformation from values from hindex - 1 into domain of handle
     double transform_0_1 = 1;
     if (face_h0 != face_h_1) {
-        auto edge_bewteen_0_and_1 = mesh.get_half_edge_between(face_h0, face_h_1).expect(EXPECT_NO_BORDER);
-        transform_0_1 = expect(mesh.get_knot_factor(edge_bewteen_0_and_1), EXPECT_NO_BORDER);
+        auto edge_bewteen_0_and_1 = frozen.get_half_edge_between(face_h0, face_h_1).expect(EXPECT_NO_BORDER);
+        transform_0_1 = expect(frozen.get_knot_factor(edge_bewteen_0_and_1), EXPECT_NO_BORDER);
     }
 
     // Get two knot values for handle with index - 1 and transform them into the domain of the current handle
@@ -427,8 +706,8 @@ local_knot_vectors surface_evaluator::get_knot_vectors(vertex_handle handle, siz
     // Get transformation from values from hindex - 2 into index - 1
     double transform__1_2 = 1;
     if (face_h_1 != face_h_2) {
-        auto edge_bewteen__1_and_2 = mesh.get_half_edge_between(face_h_1, face_h_2).expect(EXPECT_NO_BORDER);
-        transform__1_2 = expect(mesh.get_knot_factor(edge_bewteen__1_and_2), EXPECT_NO_BORDER);
+        auto edge_bewteen__1_and_2 = frozen.get_half_edge_between(face_h_1, face_h_2).expect(EXPECT_NO_BORDER);
+        transform__1_2 = expect(frozen.get_knot_factor(edge_bewteen__1_and_2), EXPECT_NO_BORDER);
     }
     auto transform_0_2 = transform_0_1 * transform__1_2;
 
@@ -436,19 +715,57 @@ local_knot_vectors surface_evaluator::get_knot_vectors(vertex_handle handle, siz
     auto knot_21 = knots[handle][index_2][0] * transform_0_2;
     auto knot_22 = knots[handle][index_2][1] * transform_0_2;
 
-    local_knot_vectors out(
+    local_knot_vectors out{
         {-knot_21 - knot_22, -knot_21, 0, knot01, knot01 + knot02},
         {-knot11 - knot12, -knot11, 0, knot_11, knot_11 + knot_12}
-    );
+    };
     return out;
 }
 
 void surface_evaluator::update_cache() {
-    calc_local_coords();
-    calc_edge_trans();
-    auto transforms = setup_basis_funs();
-    calc_knots();
-    calc_support(transforms);
+    TSL_TRACE_ZONE("update_cache");
+    auto observer = config.observer;
+    {
+        observed_stage stage(observer, "freeze");
+        frozen = frozen_tmesh(mesh);
+    }
+    {
+        observed_stage stage(observer, "local_coords");
+        calc_local_coords();
+    }
+    {
+        observed_stage stage(observer, "edge_trans");
+        calc_edge_trans();
+    }
+    basis_fun_trans_map transforms;
+    {
+        observed_stage stage(observer, "basis_funs");
+        transforms = setup_basis_funs();
+    }
+    {
+        observed_stage stage(observer, "knots");
+        calc_knots();
+    }
+    {
+        observed_stage stage(observer, "support");
+        calc_support(transforms);
+    }
+    {
+        observed_stage stage(observer, "dependent_faces");
+        calc_dependent_faces();
+    }
+    {
+        observed_stage stage(observer, "face_versions");
+        calc_face_versions();
+    }
+}
+
+void surface_evaluator::structure_changed() {
+    if (is_editing()) {
+        edited_structure = true;
+    } else {
+        update_cache();
+    }
 }
 
 void surface_evaluator::report_error(const string& msg) const {
@@ -465,95 +782,130 @@ void surface_evaluator::report_error(const string& msg) const {
 
 void surface_evaluator::calc_local_coords() {
     uv.clear();
-    uv.reserve(mesh.num_half_edges());
+    uv.reserve(frozen.num_half_edges());
     dir.clear();
-    dir.reserve(mesh.num_half_edges());
+    dir.reserve(frozen.num_half_edges());
+
+    // Insert all keys up front, so the threads below only overwrite existing values and never resize the maps
+    const auto& faces = frozen.get_faces();
+    for (const auto& eh: frozen.get_half_edges()) {
+        if (frozen.get_face_of_half_edge(eh)) {
+            uv.insert(eh, vec2(0, 0));
+            dir.insert(eh, 0);
+        }
+    }
 
-    for (const auto& fh: mesh.get_faces()) {
+    parallel_for(faces.size(), [&](size_t i) {
         vec2 c(0, 0);
-        uint8_t i = 0;
+        uint8_t d = 0;
 
-        for (const auto& eh: mesh.get_half_edges_of_face(fh)) {
-            auto k = expect(mesh.get_knot_interval(eh), EXPECT_NO_BORDER);
-            c += rotate(i, vec2(k, 0));
+        for (const auto& eh: frozen.get_half_edges_of_face(faces[i])) {
+            auto k = expect(frozen.get_knot_interval(eh), EXPECT_NO_BORDER);
+            c += rotate(d, vec2(k, 0));
 
-            uv.insert(eh, c);
-            dir.insert(eh, i);
+            uv[eh] = c;
+            dir[eh] = d;
 
-            if (expect(mesh.corner(eh), EXPECT_NO_BORDER)) {
-                i += 1;
+            if (expect(frozen.corner(eh), EXPECT_NO_BORDER)) {
+                d += 1;
             }
         }
-    }
+    }, config.num_threads);
 }
 
 void surface_evaluator::calc_edge_trans() {
     edge_trans.clear();
-    edge_trans.reserve(mesh.num_half_edges());
+    edge_trans.reserve(frozen.num_half_edges());
 
-    for (const auto& eh: mesh.get_half_edges()) {
-        auto twin = mesh.get_twin(eh);
-        auto f = expect(mesh.get_knot_factor(twin), EXPECT_NO_BORDER);
-        auto r = static_cast<uint8_t>((dir[twin] - dir[eh] + 6) % 4);
-        auto t = uv[mesh.get_prev(twin)] - (f * rotate(r, uv[eh]));
-        edge_trans.insert(eh, transform(f, r, t));
+    const auto& half_edges = frozen.get_half_edges();
+    for (const auto& eh: half_edges) {
+        edge_trans.insert(eh, transform(1, 0, vec2(0, 0)));
     }
+
+    const auto& cuv = uv;
+    const auto& cdir = dir;
+    parallel_for(half_edges.size(), [&](size_t i) {
+        auto eh = half_edges[i];
+        auto twin = frozen.get_twin(eh);
+        auto f = expect(frozen.get_knot_factor(twin), EXPECT_NO_BORDER);
+        auto r = static_cast<uint8_t>((cdir[twin] - cdir[eh] + 6) % 4);
+        auto t = cuv[frozen.get_prev(twin)] - (f * rotate(r, cuv[eh]));
+        edge_trans[eh] = transform(f, r, t);
+    }, config.num_threads);
 }
 
 basis_fun_trans_map surface_evaluator::setup_basis_funs() {
-    basis_fun_trans_map transforms{vector<transform>()};
-
-    handles.clear();
-    handles.reserve(mesh.num_vertices());
-    transforms.reserve(mesh.num_vertices());
-
-    for (const auto& vh: mesh.get_vertices()) {
-        handles.insert(vh, vector<tuple<half_edge_handle, tag>>());
-        handles[vh].reserve(mesh.get_valence(vh));
-        for (const auto& eh: mesh.get_half_edges_of_vertex(vh, edge_direction::outgoing)) {
-            handles[vh].emplace_back(eh, tag::positive_u);
-            auto r = static_cast<uint8_t>(4 - dir[eh]);
-            auto t = -rotate(r, uv[mesh.get_prev(eh)]);
-            transforms[vh].emplace_back(1, r, t);
-
-            auto twin = mesh.get_twin(eh);
-            if (!expect(mesh.corner(twin), EXPECT_NO_BORDER)) {
-                auto next_of_twin = mesh.get_next(twin);
-                handles[vh].emplace_back(next_of_twin, tag::negative_v);
-                r = static_cast<uint8_t>((4 - dir[next_of_twin] - 1) % 4);
-                t = -rotate(r, uv[twin]);
-                transforms[vh].emplace_back(1, r, t);
+    const auto& vertices = frozen.get_vertices();
+
+    // Count basis functions per vertex to build the layout of the maps
+    vector<index> counts(frozen.vertex_index_bound(), 0);
+    parallel_for(vertices.size(), [&](size_t i) {
+        auto vh = vertices[i];
+        index count = 0;
+        for (const auto& eh: frozen.get_half_edges_of_vertex(vh, edge_direction::outgoing)) {
+            count += expect(frozen.corner(frozen.get_twin(eh)), EXPECT_NO_BORDER) ? 1 : 2;
+        }
+        counts[vh.get_idx()] = count;
+    }, config.num_threads);
+
+    basis_fun_trans_map transforms;
+    handles.build(counts, {half_edge_handle(0), tag::positive_u});
+    transforms.build(counts, transform(1, 0, vec2(0, 0)));
+
+    const auto& cuv = uv;
+    const auto& cdir = dir;
+    parallel_for(vertices.size(), [&](size_t i) {
+        auto vh = vertices[i];
+        auto vertex_handles = handles[vh];
+        auto vertex_transforms = transforms[vh];
+        size_t handle_index = 0;
+        for (const auto& eh: frozen.get_half_edges_of_vertex(vh, edge_direction::outgoing)) {
+            vertex_handles[handle_index] = {eh, tag::positive_u};
+            auto r = static_cast<uint8_t>(4 - cdir[eh]);
+            auto t = -rotate(r, cuv[frozen.get_prev(eh)]);
+            vertex_transforms[handle_index] = transform(1, r, t);
+            handle_index += 1;
+
+            auto twin = frozen.get_twin(eh);
+            if (!expect(frozen.corner(twin), EXPECT_NO_BORDER)) {
+                auto next_of_twin = frozen.get_next(twin);
+                vertex_handles[handle_index] = {next_of_twin, tag::negative_v};
+                r = static_cast<uint8_t>((4 - cdir[next_of_twin] - 1) % 4);
+                t = -rotate(r, cuv[twin]);
+                vertex_transforms[handle_index] = transform(1, r, t);
+                handle_index += 1;
             }
         }
-    }
+    }, config.num_threads);
 
     return transforms;
 }
 
 void surface_evaluator::calc_knots() {
-    knots.clear();
-    knots.reserve(handles.num_values() * 2);
+    knots.build(handles, {0, 0});
 
-    for (const auto& vh: handles) {
-        knots.insert(vh, vector<array<double, 2>>());
-        knots[vh].reserve(mesh.get_valence(vh));
-        for (auto [h, q]: handles[vh]) {
+    const auto& chandles = handles;
+    parallel_for(chandles.num_keys(), [&](size_t i) {
+        vertex_handle vh(static_cast<index>(i));
+        auto vertex_knots = knots[vh];
+        size_t handle_index = 0;
+        for (auto [h, q]: chandles[vh]) {
             double s = 0;
             uint32_t j = 1;
-            knots[vh].emplace_back();
-            auto& current_knot = knots[vh].back();
+            auto& current_knot = vertex_knots[handle_index];
+            handle_index += 1;
 
             // no edge in u direction (T-joint), so walk “around” face
             if (q == tag::negative_v) {
-                while (!expect(mesh.from_corner(h), EXPECT_NO_BORDER)) {
-                    s += expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER);
-                    h = mesh.get_next(h);
+                while (!expect(frozen.from_corner(h), EXPECT_NO_BORDER)) {
+                    s += expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER);
+                    h = frozen.get_next(h);
                 }
             }
 
             bool skip = false;
             do {
-                current_knot[j - 1] += expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER);
+                current_knot[j - 1] += expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER);
 
                 // first intersection on ray encountered
                 if (s == 0) {
@@ -565,8 +917,8 @@ void surface_evaluator::calc_knots() {
                     break;
                 }
 
-                h = mesh.get_next(h);
-            } while(!expect(mesh.from_corner(h), EXPECT_NO_BORDER));
+                h = frozen.get_next(h);
+            } while(!expect(frozen.from_corner(h), EXPECT_NO_BORDER));
 
             if (skip) {
                 continue;
@@ -574,110 +926,238 @@ void surface_evaluator::calc_knots() {
 
             j = 2;
 
-            while (s >= expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER)) {
-                s -= expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER);
-                h = mesh.get_next(h);
+            while (s >= expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER)) {
+                s -= expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER);
+                h = frozen.get_next(h);
             }
 
-            auto f = expect(mesh.get_knot_factor(h), EXPECT_NO_BORDER);
-            h = mesh.get_twin(h);
+            auto f = expect(frozen.get_knot_factor(h), EXPECT_NO_BORDER);
+            h = frozen.get_twin(h);
 
-            while (!expect(mesh.corner(h), EXPECT_NO_BORDER)) {
-                h = mesh.get_next(h);
-                s += f * expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER);
+            while (!expect(frozen.corner(h), EXPECT_NO_BORDER)) {
+                h = frozen.get_next(h);
+                s += f * expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER);
             }
 
-            h = mesh.get_next(h);
+            h = frozen.get_next(h);
             skip = false;
             do {
-                current_knot[j - 1] += f * expect(mesh.get_knot_interval(h), EXPECT_NO_BORDER);
+                current_knot[j - 1] += f * expect(frozen.get_knot_interval(h), EXPECT_NO_BORDER);
 
                 if (s == 0) {
                     skip = true;
                     break;
                 }
 
-                h = mesh.get_next(h);
-            } while(!expect(mesh.from_corner(h), EXPECT_NO_BORDER));
+                h = frozen.get_next(h);
+            } while(!expect(frozen.from_corner(h), EXPECT_NO_BORDER));
 
             if (skip) {
                 continue;
             }
         }
-    }
+    }, config.num_threads);
 }
 
 void surface_evaluator::calc_support(const basis_fun_trans_map& transforms) {
-    support.clear();
-    support.reserve(mesh.num_faces());
-    knot_vectors.clear();
-    knot_vectors.reserve(handles.num_values());
-
     static const uint8_t DEGREE = 3;
 
-    // Reserve space for (in case of degree = 3 at least 8) faces
-    sparse_face_map<bool> tagged(false);
-    tagged.reserve(DEGREE * DEGREE);
+    knot_vectors.build(handles, local_knot_vectors{});
 
-    dense_face_map<sparse_vertex_map<bool>> added(sparse_vertex_map<bool>(false));
+    // Every thread collects the support entries of the basis functions of its vertices in the same order as a
+    // sequential run would do. Concatenating the fragments in chunk order therefore gives a deterministic result.
+    using support_fragment = vector<tuple<face_handle, support_entry>>;
+    vector<support_fragment> fragments(get_num_chunks(handles.num_keys(), config.num_threads));
 
-    for (const auto& vh: handles) {
-        knot_vectors.insert(vh, vector<local_knot_vectors>());
-        size_t handle_index = 0;
-        for (const auto& [h, q]: handles[vh]) {
-            tagged.clear();
+    const auto& chandles = handles;
+    const auto& cuv = uv;
+    const auto& cedge_trans = edge_trans;
+    parallel_chunks(handles.num_keys(), [&](size_t begin, size_t end, size_t chunk) {
+        auto& fragment = fragments[chunk];
 
-            queue<tuple<half_edge_handle, transform>> bfs_queue;
+        // Reserve space for (in case of degree = 3 at least 8) faces
+        sparse_face_map<bool> tagged(false);
+        tagged.reserve(DEGREE * DEGREE);
 
-            bfs_queue.push({h, transforms[vh][handle_index]});
-            auto face_h = mesh.get_face_of_half_edge(h).expect(EXPECT_NO_BORDER);
-            tagged[face_h] = true;
+        // Faces, which already contain one of the basis functions of the current vertex
+        sparse_face_map<bool> added(false);
 
-            auto r = get_parametric_domain(vh, handle_index);
+        for (auto i = begin; i < end; ++i) {
+            vertex_handle vh(static_cast<index>(i));
+            auto vertex_knot_vectors = knot_vectors[vh];
+            added.clear();
 
-            // Cache local knot vectors for faster surface evaluation
-            knot_vectors[vh].push_back(get_knot_vectors(vh, handle_index));
+            size_t handle_index = 0;
+            auto first_basis_fun = chandles.get_offset(vh);
+            for (const auto& [h, q]: chandles[vh]) {
+                tagged.clear();
+                auto basis_fun = static_cast<index>(first_basis_fun + handle_index);
 
-            while (!bfs_queue.empty()) {
-                auto [ch, ct] = bfs_queue.front();
-                bfs_queue.pop();
-                auto cface_h = mesh.get_face_of_half_edge(ch).expect(EXPECT_NO_BORDER);
-                if (!support.contains_key(cface_h)) {
-                    support.insert(cface_h, vector<tuple<vertex_handle, index, transform>>());
-                }
+                queue<tuple<half_edge_handle, transform>> bfs_queue;
 
-                // Only add the vertex, if it hasn't been added before
-                if (!added[cface_h][vh]) {
-                    support[cface_h].emplace_back(vh, handle_index, ct);
-                    added[cface_h][vh] = true;
-                }
+                bfs_queue.push({h, transforms[vh][handle_index]});
+                auto face_h = frozen.get_face_of_half_edge(h).expect(EXPECT_NO_BORDER);
+                tagged[face_h] = true;
 
-                auto g = mesh.get_next(ch);
-                while (g != ch) {
-                    auto prev_g = mesh.get_prev(g);
-                    line_segment l(ct.apply(uv[g]), ct.apply(uv[prev_g]));
-                    if (!l.intersects(r)) {
-                        g = mesh.get_next(g);
-                        continue;
-                    }
+                auto r = get_parametric_domain(vh, handle_index);
 
-                    auto twin = mesh.get_twin(g);
-                    auto twin_face_h = mesh.get_face_of_half_edge(twin).expect(EXPECT_NO_BORDER);
-                    if (tagged[twin_face_h]) {
-                        g = mesh.get_next(g);
-                        continue;
-                    }
-                    tagged[twin_face_h] = true;
+                // Cache local knot vectors for faster surface evaluation
+                vertex_knot_vectors[handle_index] = get_knot_vectors(vh, handle_index);
+
+                while (!bfs_queue.empty()) {
+                    auto [ch, ct] = bfs_queue.front();
+                    bfs_queue.pop();
+                    auto cface_h = frozen.get_face_of_half_edge(ch).expect(EXPECT_NO_BORDER);
 
-                    bfs_queue.push({twin, ct.apply(edge_trans[twin])});
+                    // Only add the vertex, if it hasn't been added before
+                    if (!added[cface_h]) {
+                        fragment.emplace_back(cface_h, support_entry(vh, handle_index, basis_fun, ct));
+                        added[cface_h] = true;
+                    }
 
-                    g = mesh.get_next(g);
+                    auto g = frozen.get_next(ch);
+                    while (g != ch) {
+                        auto prev_g = frozen.get_prev(g);
+                        line_segment l(ct.apply(cuv[g]), ct.apply(cuv[prev_g]));
+                        if (!l.intersects(r)) {
+                            g = frozen.get_next(g);
+                            continue;
+                        }
+
+                        auto twin = frozen.get_twin(g);
+                        auto twin_face_h = frozen.get_face_of_half_edge(twin).expect(EXPECT_NO_BORDER);
+                        if (tagged[twin_face_h]) {
+                            g = frozen.get_next(g);
+                            continue;
+                        }
+                        tagged[twin_face_h] = true;
+
+                        bfs_queue.push({twin, ct.apply(cedge_trans[twin])});
+
+                        g = frozen.get_next(g);
+                    }
                 }
+
+                handle_index += 1;
             }
+        }
+    }, config.num_threads);
 
-            handle_index += 1;
+    // Merge fragments: count entries per face to build the layout and scatter the entries in fragment order
+    vector<index> counts(frozen.face_index_bound(), 0);
+    for (const auto& fragment: fragments) {
+        for (const auto& entry: fragment) {
+            counts[get<0>(entry).get_idx()] += 1;
         }
     }
+
+    support.build(counts, support_entry(vertex_handle(0), 0, 0, transform(1, 0, vec2(0, 0))));
+    for (auto& count: counts) {
+        count = 0;
+    }
+    for (const auto& fragment: fragments) {
+        for (const auto& [fh, entry]: fragment) {
+            support[fh][counts[fh.get_idx()]++] = entry;
+        }
+    }
+}
+
+void surface_evaluator::calc_dependent_faces() {
+    const auto& faces = frozen.get_faces();
+    vector<vector<vertex_handle>> face_vertices(faces.size());
+    parallel_for(faces.size(), [&](size_t i) {
+        get_control_vertices(faces[i], face_vertices[i]);
+    }, config.num_threads);
+
+    // Invert: count faces per vertex to build the layout and fill the faces in ascending order
+    vector<index> counts(frozen.vertex_index_bound(), 0);
+    for (const auto& vertices: face_vertices) {
+        for (const auto& vh: vertices) {
+            counts[vh.get_idx()] += 1;
+        }
+    }
+
+    dependent_faces.build(counts, face_handle(0));
+    for (auto& count: counts) {
+        count = 0;
+    }
+    for (size_t i = 0; i < faces.size(); ++i) {
+        for (const auto& vh: face_vertices[i]) {
+            dependent_faces[vh][counts[vh.get_idx()]++] = faces[i];
+        }
+    }
+}
+
+void surface_evaluator::calc_face_versions() {
+    const auto& faces = frozen.get_faces();
+    vector<size_t> fingerprints(faces.size());
+    parallel_for(faces.size(), [&](size_t i) {
+        fingerprints[i] = get_face_fingerprint(faces[i]);
+    }, config.num_threads);
+
+    // Faces keep their version, if nothing their surface depends on has changed
+    face_version_map versions;
+    versions.reserve(frozen.face_index_bound());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        auto fh = faces[i];
+        auto unchanged = face_fingerprints.contains_key(fh) && face_fingerprints[fh] == fingerprints[i];
+        versions.insert(fh, unchanged ? face_versions[fh] : next_version++);
+    }
+
+    face_fingerprints.clear();
+    face_fingerprints.reserve(frozen.face_index_bound());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        face_fingerprints.insert(faces[i], fingerprints[i]);
+    }
+    face_versions = move(versions);
+}
+
+size_t surface_evaluator::get_face_fingerprint(face_handle handle) const {
+    size_t seed = 0;
+    auto add = [&](auto value) {
+        seed ^= std::hash<decltype(value)>()(value) + 0x9e3779b97f4a7c15 + (seed << 6u) + (seed >> 2u);
+    };
+
+    auto max_coords = get_max_coords(handle);
+    add(max_coords.x);
+    add(max_coords.y);
+
+    // Same distinction as in `get_control_vertices`, but subdevision faces depend on the order of their vertices
+    vector<vertex_handle> vertices;
+    frozen.get_vertices_of_face(handle, vertices);
+    auto contains_extraordinary_vertex = false;
+    auto contains_invalid_valence = false;
+    for (const auto& vh: vertices) {
+        contains_extraordinary_vertex |= frozen.is_extraordinary(vh);
+        contains_invalid_valence |= frozen.get_valence(vh) < 3;
+    }
+    add(contains_extraordinary_vertex);
+    add(contains_invalid_valence);
+
+    if (contains_extraordinary_vertex) {
+        if (!contains_invalid_valence) {
+            for (const auto& vh: get_vertices_for_subd(handle)) {
+                add(vh.get_idx());
+            }
+        }
+    } else {
+        const auto& all_knots = knot_vectors.get_values();
+        for (const auto& [vertex, idx, basis_fun, trans]: support[handle]) {
+            add(vertex.get_idx());
+            for (auto knot: all_knots[basis_fun].u) {
+                add(knot);
+            }
+            for (auto knot: all_knots[basis_fun].v) {
+                add(knot);
+            }
+            add(trans.f);
+            add(trans.r);
+            add(trans.t.x);
+            add(trans.t.y);
+        }
+    }
+
+    return seed;
 }
 
 }
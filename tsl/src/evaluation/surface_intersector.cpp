@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_intersector.hpp"
+#include "tsl/util/parallel.hpp"
+
+using std::clamp;
+using std::max;
+using std::optional;
+using std::nullopt;
+using std::vector;
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+namespace tsl {
+
+surface_intersector::surface_intersector(const surface_evaluator& evaluator, uint32_t res)
+    : evaluator(evaluator), bvh(evaluator, evaluator.eval_per_face(res)), tolerance(0)
+{
+    auto bounds = bvh.get_bounds();
+    if (!bounds.is_empty()) {
+        tolerance = TOLERANCE * max(length(bounds.max_corner - bounds.min_corner), 1.0);
+    }
+}
+
+optional<ray_hit> surface_intersector::intersect(const line& ray) const {
+    auto seed = bvh.intersect(ray);
+    if (!seed) {
+        return nullopt;
+    }
+
+    // Solve S(u, v) - (o + t * d) = 0 for (u, v, t) starting at the hit with the tessellation
+    auto uv = seed->uv;
+    auto t = seed->t;
+    for (int i = 0; i < MAX_ITERATIONS; ++i) {
+        auto [point, du, dv] = evaluator.eval_point(seed->face, uv);
+        auto diff = point - (ray.support_vector + t * ray.normal);
+        if (length(diff) < tolerance && t >= 0) {
+            return ray_hit(seed->face, uv, point, normalize(cross(du, dv)), t, true);
+        }
+
+        // Solve [du dv -d] * step = -diff with cramer's rule
+        auto nd = -ray.normal;
+        auto det = dot(du, cross(dv, nd));
+        if (det == 0) {
+            break;
+        }
+        auto step_u = dot(-diff, cross(dv, nd)) / det;
+        auto step_v = dot(du, cross(-diff, nd)) / det;
+        auto step_t = dot(du, cross(dv, -diff)) / det;
+
+        // The parameters are kept inside the face, if the ray leaves it, the iteration doesn't converge
+        uv = vec2(clamp(uv.x + step_u, 0.0, 1.0), clamp(uv.y + step_v, 0.0, 1.0));
+        t += step_t;
+        if (!std::isfinite(t)) {
+            break;
+        }
+    }
+
+    // Fall back to the hit with the tessellation
+    auto seed_point = evaluator.eval_point(seed->face, seed->uv);
+    auto normal = normalize(cross(seed_point[1], seed_point[2]));
+    return ray_hit(seed->face, seed->uv, seed->point, normal, seed->t, false);
+}
+
+vector<optional<ray_hit>> surface_intersector::intersect(const vector<line>& rays, size_t max_threads) const {
+    vector<optional<ray_hit>> out(rays.size());
+    parallel_for(rays.size(), [&](size_t i) {
+        out[i] = intersect(rays[i]);
+    }, max_threads);
+    return out;
+}
+
+}
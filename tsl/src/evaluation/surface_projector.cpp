@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_projector.hpp"
+#include "tsl/util/parallel.hpp"
+
+using std::clamp;
+using std::max;
+using std::optional;
+using std::nullopt;
+using std::vector;
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+namespace tsl {
+
+surface_projector::surface_projector(const surface_evaluator& evaluator, uint32_t res)
+    : evaluator(evaluator), bvh(evaluator, evaluator.eval_per_face(res)), tolerance(0)
+{
+    auto bounds = bvh.get_bounds();
+    if (!bounds.is_empty()) {
+        tolerance = TOLERANCE * max(length(bounds.max_corner - bounds.min_corner), 1.0);
+    }
+}
+
+optional<surface_projection> surface_projector::project(const vec3& point) const {
+    auto seed = bvh.closest_point(point);
+    if (!seed) {
+        return nullopt;
+    }
+
+    auto best = refine(point, seed->face, seed->uv);
+    auto on_border = [](const vec2& uv) {
+        return uv.x == 0 || uv.x == 1 || uv.y == 0 || uv.y == 1;
+    };
+    if (!on_border(best.uv) || best.distance == 0) {
+        return best;
+    }
+
+    // The closest point may lie in a neighbouring face, so check all faces, which could contain a closer point
+    for (const auto& hit: bvh.closest_points(point, best.distance)) {
+        if (hit.face == seed->face) {
+            continue;
+        }
+        auto candidate = refine(point, hit.face, hit.uv);
+        if (candidate.distance < best.distance) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+surface_projection surface_projector::refine(const vec3& point, face_handle face, const vec2& start) const {
+    // Minimize |S(u, v) - point|^2 with (u, v) in [0, 1]^2 with newton iterations
+    auto uv = start;
+    auto best_uv = uv;
+    auto best = evaluator.eval_point(face, uv);
+    auto best_dist = length(best[0] - point);
+    auto converged = false;
+    for (int i = 0; i < MAX_ITERATIONS; ++i) {
+        if (i != 0) {
+            auto current = evaluator.eval_point(face, uv);
+            auto dist = length(current[0] - point);
+            if (dist > best_dist) {
+                // The step overshot, go back half the way
+                auto back = (uv - best_uv) * 0.5;
+                if (length(back.x * best[1] + back.y * best[2]) < tolerance) {
+                    converged = true;
+                    break;
+                }
+                uv = best_uv + back;
+                continue;
+            }
+            best_uv = uv;
+            best = current;
+            best_dist = dist;
+        }
+
+        // Gradient of the squared distance (divided by 2)
+        const auto& [p, du, dv] = best;
+        auto diff = p - point;
+        auto g_u = dot(du, diff);
+        auto g_v = dot(dv, diff);
+
+        // A parameter on the border of the face is fixed, if the distance decreases outside of the face
+        auto fix_u = (uv.x <= 0 && g_u > 0) || (uv.x >= 1 && g_u < 0);
+        auto fix_v = (uv.y <= 0 && g_v > 0) || (uv.y >= 1 && g_v < 0);
+
+        // Hessian of the squared distance (divided by 2). The gauss-newton part J^T J with J = [du dv] is exact, the
+        // curvature part is calculated from the differences of the first derivatives.
+        auto h_uu = dot(du, du);
+        auto h_uv = dot(du, dv);
+        auto h_vv = dot(dv, dv);
+        auto offset_u = uv.x + DIFF_STEP <= 1 ? DIFF_STEP : -DIFF_STEP;
+        auto offset_v = uv.y + DIFF_STEP <= 1 ? DIFF_STEP : -DIFF_STEP;
+        auto next_u = evaluator.eval_point(face, vec2(uv.x + offset_u, uv.y));
+        auto next_v = evaluator.eval_point(face, vec2(uv.x, uv.y + offset_v));
+        auto curv_uu = dot(diff, next_u[1] - du) / offset_u;
+        auto curv_uv = (dot(diff, next_u[2] - dv) / offset_u + dot(diff, next_v[1] - du) / offset_v) * 0.5;
+        auto curv_vv = dot(diff, next_v[2] - dv) / offset_v;
+
+        // Away from a minimum the hessian may be indefinite, then only the gauss-newton part is used
+        if (h_uu + curv_uu > 0 && (h_uu + curv_uu) * (h_vv + curv_vv) - (h_uv + curv_uv) * (h_uv + curv_uv) > 0) {
+            h_uu += curv_uu;
+            h_uv += curv_uv;
+            h_vv += curv_vv;
+        }
+
+        // Solve H * step = -g for the free parameters
+        double step_u = 0;
+        double step_v = 0;
+        if (!fix_u && !fix_v) {
+            auto det = h_uu * h_vv - h_uv * h_uv;
+            if (det == 0) {
+                break;
+            }
+            step_u = -(h_vv * g_u - h_uv * g_v) / det;
+            step_v = -(h_uu * g_v - h_uv * g_u) / det;
+        } else if (!fix_u) {
+            step_u = -g_u / h_uu;
+        } else if (!fix_v) {
+            step_v = -g_v / h_vv;
+        }
+
+        auto next = vec2(clamp(uv.x + step_u, 0.0, 1.0), clamp(uv.y + step_v, 0.0, 1.0));
+        auto step = next - uv;
+        if (length(step.x * du + step.y * dv) < tolerance) {
+            converged = true;
+            break;
+        }
+        uv = next;
+    }
+
+    auto normal = normalize(cross(best[1], best[2]));
+    return surface_projection(face, best_uv, best[0], normal, best_dist, converged);
+}
+
+vector<optional<surface_projection>> surface_projector::project(const vector<vec3>& points, size_t max_threads) const {
+    vector<optional<surface_projection>> out(points.size());
+    parallel_for(points.size(), [&](size_t i) {
+        out[i] = project(points[i]);
+    }, max_threads);
+    return out;
+}
+
+}
@@ -0,0 +1,554 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/tessellation.hpp"
+#include "tsl/attrmaps/attr_maps.hpp"
+#include "tsl/util/parallel.hpp"
+#include "tsl/util/trace.hpp"
+
+using std::array;
+using std::cos;
+using std::lower_bound;
+using std::map;
+using std::max;
+using std::min;
+using std::optional;
+using std::nullopt;
+using std::pair;
+using std::reverse;
+using std::make_pair;
+using std::set;
+using std::sort;
+using std::unique;
+using std::unordered_map;
+using std::vector;
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+namespace tsl {
+
+namespace {
+
+/// Marks the indices of vertices, which only belong to a single face and are numbered per face.
+constexpr uint32_t LOCAL_VERTEX = 1u << 31;
+/// Params, which are closer than this, are considered equal.
+constexpr double PARAM_EPSILON = 1e-9;
+/// Max depth of the quadtrees, so the lattice coords fit into 32 bits.
+constexpr uint32_t MAX_DEPTH = 20;
+
+/**
+ * @brief A square cell in the lattice of the smallest possible cells of a face.
+ */
+struct cell {
+    uint32_t x;
+    uint32_t y;
+    uint32_t size;
+
+    cell(uint32_t x, uint32_t y, uint32_t size) : x(x), y(y), size(size) {}
+};
+
+/**
+ * @brief A vertex on a side of a face.
+ */
+struct side_vertex {
+    /// Coord along the side (u for the sides 0 and 2, v for the sides 1 and 3).
+    double t;
+    uint32_t index;
+
+    side_vertex(double t, uint32_t index) : t(t), index(index) {}
+};
+
+/**
+ * @brief The tessellation of a single face.
+ */
+struct face_tessellation {
+    /// False, if the face can't be evaluated.
+    bool valid;
+    vector<face_segment> segments;
+    vector<cell> leaves;
+    /// Fractions (along the half edge) of the samples on each segment, which are corners of leaves.
+    vector<vector<double>> samples;
+    /// The shared vertices on each side of the face sorted by their coord along the side.
+    array<vector<side_vertex>, 4> sides;
+    /// Params of the vertices, which only belong to this face.
+    vector<vec2> local_params;
+    /// Vertex indices of the triangles. Indices of local vertices are marked with `LOCAL_VERTEX`.
+    vector<uint32_t> indices;
+
+    face_tessellation() : valid(false) {}
+};
+
+/**
+ * @brief All samples on an edge of the tmesh, which are shared by both adjacent faces.
+ */
+struct edge_samples {
+    /// Fractions of the samples along the half edge, which is used as key.
+    vector<double> fractions;
+    /// Indices of the vertices of the samples.
+    vector<uint32_t> indices;
+    /// Index of the face and the segment, which is used to evaluate the samples.
+    size_t face;
+    size_t segment;
+    /// True, if the segment has the opposite direction as the key.
+    bool reversed;
+
+    edge_samples() : face(0), segment(0), reversed(false) {}
+};
+
+double get_side_coord(uint8_t side, const vec2& uv) {
+    return side % 2 == 0 ? uv.x : uv.y;
+}
+
+/**
+ * @brief Evaluates the points of a face on the lattice of its smallest cells and caches them.
+ */
+class lattice_evaluator {
+public:
+    lattice_evaluator(const surface_evaluator& evaluator, face_handle face, uint32_t size)
+        : evaluator(evaluator), face(face), size(size) {}
+
+    /**
+     * @brief Returns the point and the normal at the given lattice coords.
+     */
+    const pair<vec3, vec3>& operator()(uint32_t x, uint32_t y) {
+        auto key = (static_cast<uint64_t>(y) << 32) | x;
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        auto [point, du, dv] = evaluator.eval_point(face, vec2(static_cast<double>(x) / size, static_cast<double>(y) / size));
+        return cache.emplace(key, make_pair(point, normalize(cross(du, dv)))).first->second;
+    }
+
+private:
+    const surface_evaluator& evaluator;
+    face_handle face;
+    uint32_t size;
+    unordered_map<uint64_t, pair<vec3, vec3>> cache;
+};
+
+/**
+ * @brief Returns true, if the surface in the given cell deviates too much from the two triangles of the cell.
+ */
+bool needs_split(lattice_evaluator& eval, const cell& c, const tessellation_config& config, double min_cos) {
+    auto h = c.size / 2;
+    const auto& c00 = eval(c.x, c.y);
+    const auto& c10 = eval(c.x + c.size, c.y);
+    const auto& c01 = eval(c.x, c.y + c.size);
+    const auto& c11 = eval(c.x + c.size, c.y + c.size);
+    const auto& center = eval(c.x + h, c.y + h);
+
+    auto chord = [](const vec3& a, const vec3& mid, const vec3& b) {
+        return length(mid - (a + b) * 0.5);
+    };
+    auto error = length(center.first - (c00.first + c10.first + c01.first + c11.first) * 0.25);
+    error = max(error, chord(c00.first, eval(c.x + h, c.y).first, c10.first));
+    error = max(error, chord(c10.first, eval(c.x + c.size, c.y + h).first, c11.first));
+    error = max(error, chord(c01.first, eval(c.x + h, c.y + c.size).first, c11.first));
+    error = max(error, chord(c00.first, eval(c.x, c.y + h).first, c01.first));
+    if (error > config.max_chord_error) {
+        return true;
+    }
+
+    // Degenerated normals (e.g. at extraordinary vertices) are NaN and never trigger a split
+    for (const auto* corner: {&c00, &c10, &c01, &c11}) {
+        if (dot(corner->second, center.second) < min_cos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Splits the parameter domain of the given face into a quadtree, until all cells meet the tolerances.
+ */
+void build_quadtree(
+    const surface_evaluator& evaluator,
+    face_handle handle,
+    const tessellation_config& config,
+    uint32_t size,
+    face_tessellation& out
+) {
+    lattice_evaluator eval(evaluator, handle, size);
+    auto min_cos = cos(config.max_normal_angle);
+    vector<cell> stack;
+    stack.emplace_back(0, 0, size);
+    while (!stack.empty()) {
+        auto current = stack.back();
+        stack.pop_back();
+        if (current.size > 1 && needs_split(eval, current, config, min_cos)) {
+            auto h = current.size / 2;
+            stack.emplace_back(current.x, current.y, h);
+            stack.emplace_back(current.x + h, current.y, h);
+            stack.emplace_back(current.x, current.y + h, h);
+            stack.emplace_back(current.x + h, current.y + h, h);
+        } else {
+            out.leaves.push_back(current);
+        }
+    }
+}
+
+/**
+ * @brief Collects the corners of the leaves on the border of the face as samples of its half edges.
+ */
+void collect_samples(uint32_t size, face_tessellation& face) {
+    face.samples.resize(face.segments.size());
+    auto add_sample = [&](uint8_t side, double t) {
+        for (size_t i = 0; i < face.segments.size(); ++i) {
+            const auto& segment = face.segments[i];
+            if (segment.side != side) {
+                continue;
+            }
+            auto start = get_side_coord(side, segment.start);
+            auto end = get_side_coord(side, segment.end);
+            if (t > min(start, end) + PARAM_EPSILON && t < max(start, end) - PARAM_EPSILON) {
+                face.samples[i].push_back((t - start) / (end - start));
+                return;
+            }
+        }
+    };
+
+    set<pair<uint32_t, uint32_t>> border_points;
+    for (const auto& leaf: face.leaves) {
+        for (auto x: {leaf.x, leaf.x + leaf.size}) {
+            for (auto y: {leaf.y, leaf.y + leaf.size}) {
+                auto on_x_border = x == 0 || x == size;
+                auto on_y_border = y == 0 || y == size;
+                // Corners of the face are vertices of the tmesh
+                if (on_x_border != on_y_border) {
+                    border_points.emplace(x, y);
+                }
+            }
+        }
+    }
+    for (const auto& [x, y]: border_points) {
+        if (y == 0 || y == size) {
+            add_sample(y == 0 ? 0 : 2, static_cast<double>(x) / size);
+        } else {
+            add_sample(x == size ? 1 : 3, static_cast<double>(y) / size);
+        }
+    }
+}
+
+/**
+ * @brief Triangulates the leaves of the given face. The shared vertices on its sides have to be known.
+ */
+void triangulate(uint32_t size, face_tessellation& face) {
+    // All corners of leaves sorted by rows and by columns to find the corners on the sides of other leaves
+    set<pair<uint32_t, uint32_t>> by_row;
+    set<pair<uint32_t, uint32_t>> by_col;
+    for (const auto& leaf: face.leaves) {
+        for (auto x: {leaf.x, leaf.x + leaf.size}) {
+            for (auto y: {leaf.y, leaf.y + leaf.size}) {
+                by_row.emplace(y, x);
+                by_col.emplace(x, y);
+            }
+        }
+    }
+
+    auto find_shared = [&](uint8_t side, double t) {
+        const auto& vertices = face.sides[side];
+        auto it = lower_bound(vertices.begin(), vertices.end(), t - PARAM_EPSILON, [](const side_vertex& v, double value) {
+            return v.t < value;
+        });
+        if (it == vertices.end()) {
+            --it;
+        }
+        return it->index;
+    };
+
+    unordered_map<uint64_t, uint32_t> local_indices;
+    auto get_index = [&](uint32_t x, uint32_t y) {
+        if (y == 0 || y == size) {
+            return find_shared(y == 0 ? 0 : 2, static_cast<double>(x) / size);
+        }
+        if (x == 0 || x == size) {
+            return find_shared(x == size ? 1 : 3, static_cast<double>(y) / size);
+        }
+
+        auto key = (static_cast<uint64_t>(y) << 32) | x;
+        auto it = local_indices.find(key);
+        if (it != local_indices.end()) {
+            return it->second;
+        }
+        auto index = LOCAL_VERTEX | static_cast<uint32_t>(face.local_params.size());
+        face.local_params.emplace_back(static_cast<double>(x) / size, static_cast<double>(y) / size);
+        local_indices.emplace(key, index);
+        return index;
+    };
+
+    vector<uint32_t> polygon;
+    // Adds the vertices on the side of a leaf from corner a (included) to corner b (excluded)
+    auto add_side = [&](uint32_t ax, uint32_t ay, uint32_t bx, uint32_t by) {
+        optional<uint8_t> border;
+        if (ay == by && (ay == 0 || ay == size)) {
+            border = ay == 0 ? 0 : 2;
+        } else if (ax == bx && (ax == 0 || ax == size)) {
+            border = ax == size ? 1 : 3;
+        }
+
+        if (border) {
+            // The shared vertices include the samples requested by the neighbouring face
+            auto ta = get_side_coord(*border, vec2(ax, ay)) / size;
+            auto tb = get_side_coord(*border, vec2(bx, by)) / size;
+            auto lo = min(ta, tb) - PARAM_EPSILON;
+            auto hi = max(ta, tb) + PARAM_EPSILON;
+            auto first = polygon.size();
+            for (const auto& v: face.sides[*border]) {
+                if (v.t >= lo && v.t <= hi) {
+                    polygon.push_back(v.index);
+                }
+            }
+            if (ta > tb) {
+                reverse(polygon.begin() + first, polygon.end());
+            }
+            polygon.pop_back();
+            return;
+        }
+
+        polygon.push_back(get_index(ax, ay));
+        auto first = polygon.size();
+        if (ay == by) {
+            auto begin = by_row.upper_bound(make_pair(ay, min(ax, bx)));
+            auto end = by_row.lower_bound(make_pair(ay, max(ax, bx)));
+            for (auto it = begin; it != end; ++it) {
+                polygon.push_back(get_index(it->second, ay));
+            }
+            if (ax > bx) {
+                reverse(polygon.begin() + first, polygon.end());
+            }
+        } else {
+            auto begin = by_col.upper_bound(make_pair(ax, min(ay, by)));
+            auto end = by_col.lower_bound(make_pair(ax, max(ay, by)));
+            for (auto it = begin; it != end; ++it) {
+                polygon.push_back(get_index(ax, it->second));
+            }
+            if (ay > by) {
+                reverse(polygon.begin() + first, polygon.end());
+            }
+        }
+    };
+
+    for (const auto& leaf: face.leaves) {
+        auto x0 = leaf.x;
+        auto y0 = leaf.y;
+        auto x1 = leaf.x + leaf.size;
+        auto y1 = leaf.y + leaf.size;
+
+        // Counter clockwise in the parameter domain
+        polygon.clear();
+        add_side(x0, y0, x1, y0);
+        add_side(x1, y0, x1, y1);
+        add_side(x1, y1, x0, y1);
+        add_side(x0, y1, x0, y0);
+
+        if (polygon.size() == 4) {
+            face.indices.insert(face.indices.end(), {polygon[0], polygon[1], polygon[2]});
+            face.indices.insert(face.indices.end(), {polygon[0], polygon[2], polygon[3]});
+            continue;
+        }
+
+        // Vertices on the sides of the leaf are connected to its center
+        auto center = LOCAL_VERTEX | static_cast<uint32_t>(face.local_params.size());
+        face.local_params.emplace_back((x0 + leaf.size * 0.5) / size, (y0 + leaf.size * 0.5) / size);
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            face.indices.insert(face.indices.end(), {center, polygon[i], polygon[(i + 1) % polygon.size()]});
+        }
+    }
+}
+
+/**
+ * @brief Tessellates all faces of the given evaluator. `build_leaves` splits the parameter domain of a face into
+ *        cells in a lattice with `size` x `size` cells.
+ */
+template<typename build_leaves_t>
+triangle_mesh tessellate(
+    const surface_evaluator& evaluator,
+    uint32_t size,
+    build_leaves_t build_leaves,
+    size_t max_threads
+) {
+    const auto& mesh = evaluator.get_frozen_tmesh();
+    vector<face_handle> handles;
+    handles.reserve(mesh.num_faces());
+    for (const auto& fh: mesh.get_faces()) {
+        handles.push_back(fh);
+    }
+
+    // Split each face independently
+    vector<face_tessellation> faces(handles.size());
+    parallel_for(handles.size(), [&](size_t i) {
+        vector<vertex_handle> control_vertices;
+        evaluator.get_control_vertices(handles[i], control_vertices);
+        if (control_vertices.empty()) {
+            return;
+        }
+        faces[i].segments = evaluator.get_face_segments(handles[i]);
+        if (faces[i].segments.empty()) {
+            return;
+        }
+        faces[i].valid = true;
+        build_leaves(handles[i], faces[i]);
+        collect_samples(size, faces[i]);
+    }, max_threads);
+
+    // Every vertex of the tmesh and every sample on an edge becomes a single shared vertex. The samples of both
+    // adjacent faces are merged, so both faces contain the same vertices on the edge.
+    vector<pair<face_handle, vec2>> shared_params;
+    dense_vertex_map<uint32_t> vertex_indices;
+    map<half_edge_handle, edge_samples> edges;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const auto& face = faces[i];
+        if (!face.valid) {
+            continue;
+        }
+        for (size_t j = 0; j < face.segments.size(); ++j) {
+            const auto& segment = face.segments[j];
+            auto target = mesh.get_target(segment.handle);
+            if (!vertex_indices.contains_key(target)) {
+                vertex_indices.insert(target, static_cast<uint32_t>(shared_params.size()));
+                shared_params.emplace_back(handles[i], segment.end);
+            }
+
+            auto key = min(segment.handle, mesh.get_twin(segment.handle));
+            auto reversed = key != segment.handle;
+            auto inserted = edges.find(key) == edges.end();
+            auto& edge = edges[key];
+            if (inserted) {
+                edge.face = i;
+                edge.segment = j;
+                edge.reversed = reversed;
+            }
+            for (auto f: face.samples[j]) {
+                edge.fractions.push_back(reversed ? 1 - f : f);
+            }
+        }
+    }
+    for (auto& [key, edge]: edges) {
+        auto& fractions = edge.fractions;
+        sort(fractions.begin(), fractions.end());
+        fractions.erase(unique(fractions.begin(), fractions.end(), [](double a, double b) {
+            return b - a < PARAM_EPSILON;
+        }), fractions.end());
+
+        const auto& segment = faces[edge.face].segments[edge.segment];
+        for (auto f: fractions) {
+            auto t = edge.reversed ? 1 - f : f;
+            edge.indices.push_back(static_cast<uint32_t>(shared_params.size()));
+            shared_params.emplace_back(handles[edge.face], segment.start + (segment.end - segment.start) * t);
+        }
+    }
+
+    // Collect the shared vertices on the sides of each face and triangulate it
+    const auto& shared_vertices = vertex_indices;
+    const auto& shared_edges = edges;
+    parallel_for(faces.size(), [&](size_t i) {
+        auto& face = faces[i];
+        if (!face.valid) {
+            return;
+        }
+        for (const auto& segment: face.segments) {
+            auto start = get_side_coord(segment.side, segment.start);
+            auto end = get_side_coord(segment.side, segment.end);
+            auto& side = face.sides[segment.side];
+            auto source = mesh.get_target(mesh.get_twin(segment.handle));
+            side.emplace_back(start, shared_vertices[source]);
+            side.emplace_back(end, shared_vertices[mesh.get_target(segment.handle)]);
+
+            auto key = min(segment.handle, mesh.get_twin(segment.handle));
+            const auto& edge = shared_edges.at(key);
+            for (size_t j = 0; j < edge.fractions.size(); ++j) {
+                auto f = key == segment.handle ? edge.fractions[j] : 1 - edge.fractions[j];
+                side.emplace_back(start + (end - start) * f, edge.indices[j]);
+            }
+        }
+        for (auto& side: face.sides) {
+            sort(side.begin(), side.end(), [](const side_vertex& a, const side_vertex& b) {
+                return a.t < b.t;
+            });
+            side.erase(unique(side.begin(), side.end(), [](const side_vertex& a, const side_vertex& b) {
+                return a.index == b.index;
+            }), side.end());
+        }
+        triangulate(size, face);
+    }, max_threads);
+
+    // Number the local vertices of all faces after the shared ones
+    vector<uint32_t> offsets(faces.size());
+    auto num_vertices = shared_params.size();
+    size_t num_indices = 0;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        offsets[i] = static_cast<uint32_t>(num_vertices);
+        num_vertices += faces[i].local_params.size();
+        num_indices += faces[i].indices.size();
+    }
+
+    triangle_mesh out;
+    out.positions.resize(num_vertices);
+    out.normals.resize(num_vertices);
+    out.indices.reserve(num_indices);
+    out.faces.reserve(num_indices / 3);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        for (auto index: faces[i].indices) {
+            out.indices.push_back(index & LOCAL_VERTEX ? offsets[i] + (index & ~LOCAL_VERTEX) : index);
+        }
+        out.faces.insert(out.faces.end(), faces[i].indices.size() / 3, handles[i]);
+    }
+
+    auto eval = [&](size_t index, face_handle face, const vec2& uv) {
+        auto [point, du, dv] = evaluator.eval_point(face, uv);
+        out.positions[index] = point;
+        out.normals[index] = normalize(cross(du, dv));
+    };
+    parallel_for(shared_params.size(), [&](size_t i) {
+        eval(i, shared_params[i].first, shared_params[i].second);
+    }, max_threads);
+    parallel_for(faces.size(), [&](size_t i) {
+        for (size_t j = 0; j < faces[i].local_params.size(); ++j) {
+            eval(offsets[i] + j, handles[i], faces[i].local_params[j]);
+        }
+    }, max_threads);
+
+    return out;
+}
+
+}
+
+triangle_mesh tessellate_adaptive(const surface_evaluator& evaluator, const tessellation_config& config, size_t max_threads) {
+    TSL_TRACE_ZONE("tessellate_adaptive");
+    auto size = 1u << min(config.max_depth, MAX_DEPTH);
+    return tessellate(evaluator, size, [&](face_handle handle, face_tessellation& face) {
+        build_quadtree(evaluator, handle, config, size, face);
+    }, max_threads);
+}
+
+triangle_mesh tessellate_uniform(const surface_evaluator& evaluator, uint32_t res, size_t max_threads) {
+    TSL_TRACE_ZONE("tessellate_uniform");
+    if (res == 0) {
+        return triangle_mesh();
+    }
+    return tessellate(evaluator, res, [&](face_handle handle, face_tessellation& face) {
+        face.leaves.reserve(res * res);
+        for (uint32_t y = 0; y < res; ++y) {
+            for (uint32_t x = 0; x < res; ++x) {
+                face.leaves.emplace_back(x, y, 1);
+            }
+        }
+    }, max_threads);
+}
+
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include <tsl/geometry/box.hpp>
+
+using std::max;
+using std::min;
+using std::swap;
+using std::numeric_limits;
+using std::optional;
+using std::nullopt;
+
+namespace tsl {
+
+aa_box::aa_box() :
+    min_corner(numeric_limits<double>::infinity()),
+    max_corner(-numeric_limits<double>::infinity())
+{}
+
+aa_box::aa_box(const vec3& p1, const vec3& p2) {
+    min_corner = vec3(min(p1.x, p2.x), min(p1.y, p2.y), min(p1.z, p2.z));
+    max_corner = vec3(max(p1.x, p2.x), max(p1.y, p2.y), max(p1.z, p2.z));
+}
+
+bool aa_box::is_empty() const {
+    return min_corner.x > max_corner.x || min_corner.y > max_corner.y || min_corner.z > max_corner.z;
+}
+
+vec3 aa_box::get_center() const {
+    return (min_corner + max_corner) * 0.5;
+}
+
+void aa_box::extend(const vec3& point) {
+    min_corner = vec3(min(min_corner.x, point.x), min(min_corner.y, point.y), min(min_corner.z, point.z));
+    max_corner = vec3(max(max_corner.x, point.x), max(max_corner.y, point.y), max(max_corner.z, point.z));
+}
+
+void aa_box::extend(const aa_box& box) {
+    extend(box.min_corner);
+    extend(box.max_corner);
+}
+
+double aa_box::squared_distance(const vec3& point) const {
+    double out = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        auto diff = max(min_corner[axis] - point[axis], 0.0) + max(point[axis] - max_corner[axis], 0.0);
+        out += diff * diff;
+    }
+    return out;
+}
+
+optional<double> aa_box::intersect(const line& line, double t_min, double t_max) const {
+    // Slab test: clip the parameter range against the three pairs of planes
+    for (int axis = 0; axis < 3; ++axis) {
+        auto origin = line.support_vector[axis];
+        auto dir = line.normal[axis];
+        if (dir == 0) {
+            if (origin < min_corner[axis] || origin > max_corner[axis]) {
+                return nullopt;
+            }
+            continue;
+        }
+
+        auto t1 = (min_corner[axis] - origin) / dir;
+        auto t2 = (max_corner[axis] - origin) / dir;
+        if (t1 > t2) {
+            swap(t1, t2);
+        }
+        t_min = max(t_min, t1);
+        t_max = min(t_max, t2);
+        if (t_min > t_max) {
+            return nullopt;
+        }
+    }
+
+    return t_min;
+}
+
+}
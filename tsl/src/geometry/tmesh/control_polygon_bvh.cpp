@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/geometry/tmesh/control_polygon_bvh.hpp"
+#include "tsl/util/panic.hpp"
+#include "tsl/util/trace.hpp"
+
+using std::clamp;
+using std::nth_element;
+using std::numeric_limits;
+using std::optional;
+using std::vector;
+
+using glm::dot;
+using glm::length;
+
+namespace tsl {
+
+namespace {
+
+/**
+ * @brief Visits the elements of all leaves of the given nodes, whose bounding box grown by `radius` is hit by the
+ *        given ray within [0, t_max()]. `t_max` is called again for each node, so the range can shrink while
+ *        visiting. Nearer children are visited first.
+ */
+template<typename node_t, typename t_max_t, typename visit_t>
+void visit_hit_leaves(
+    const vector<node_t>& nodes,
+    const vector<uint32_t>& order,
+    const line& ray,
+    double radius,
+    t_max_t t_max,
+    visit_t visit
+) {
+    if (nodes.empty()) {
+        return;
+    }
+
+    auto grow = vec3(radius, radius, radius);
+    auto enter = [&](uint32_t idx) {
+        aa_box grown(nodes[idx].bounds.min_corner - grow, nodes[idx].bounds.max_corner + grow);
+        return grown.intersect(ray, 0, t_max());
+    };
+
+    vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        auto idx = stack.back();
+        stack.pop_back();
+
+        const auto& current = nodes[idx];
+        if (!enter(idx)) {
+            continue;
+        }
+
+        if (current.count != 0) {
+            for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+                visit(order[i]);
+            }
+            continue;
+        }
+
+        auto left = idx + 1;
+        auto right = current.first;
+        auto t_left = enter(left);
+        auto t_right = enter(right);
+        if (t_left && t_right && *t_right < *t_left) {
+            stack.push_back(left);
+            stack.push_back(right);
+        } else {
+            if (t_right) {
+                stack.push_back(right);
+            }
+            if (t_left) {
+                stack.push_back(left);
+            }
+        }
+    }
+}
+
+}
+
+control_polygon_bvh::control_polygon_bvh(const tmesh& mesh) {
+    TSL_TRACE_ZONE("build_control_polygon_bvh");
+    vertices.reserve(mesh.num_vertices());
+    positions.reserve(mesh.num_vertices());
+    for (const auto& vh: mesh.get_vertices()) {
+        vertex_indices.insert(vh, static_cast<uint32_t>(vertices.size()));
+        vertices.push_back(vh);
+        positions.push_back(mesh.get_vertex_position(vh));
+    }
+
+    edges.reserve(mesh.num_edges());
+    edge_vertices.reserve(mesh.num_edges());
+    for (const auto& eh: mesh.get_edges()) {
+        auto [first, second] = mesh.get_vertices_of_edge(eh);
+        edge_indices.insert(eh, static_cast<uint32_t>(edges.size()));
+        edges.push_back(eh);
+        edge_vertices.push_back({vertex_indices[first], vertex_indices[second]});
+    }
+
+    vertex_hierarchy.bounds.reserve(vertices.size());
+    for (const auto& pos: positions) {
+        vertex_hierarchy.bounds.emplace_back(pos, pos);
+    }
+    vertex_hierarchy.build();
+
+    edge_hierarchy.bounds.reserve(edges.size());
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        edge_hierarchy.bounds.push_back(calc_edge_bounds(i));
+    }
+    edge_hierarchy.build();
+}
+
+void control_polygon_bvh::refit(const tmesh& mesh, const set<vertex_handle>& moved) {
+    TSL_TRACE_ZONE("refit_control_polygon_bvh");
+    vector<bool> dirty_vertex_nodes(vertex_hierarchy.nodes.size(), false);
+    vector<bool> dirty_edge_nodes(edge_hierarchy.nodes.size(), false);
+    vector<edge_handle> vertex_edges;
+    for (const auto& vh: moved) {
+        if (!vertex_indices.contains_key(vh)) {
+            panic("vertex {} is not contained in the bvh!", vh.get_idx());
+        }
+
+        auto vertex = vertex_indices[vh];
+        positions[vertex] = mesh.get_vertex_position(vh);
+        vertex_hierarchy.bounds[vertex] = aa_box(positions[vertex], positions[vertex]);
+        vertex_hierarchy.mark_dirty(vertex, dirty_vertex_nodes);
+
+        vertex_edges.clear();
+        mesh.get_edges_of_vertex(vh, vertex_edges);
+        for (const auto& eh: vertex_edges) {
+            if (!edge_indices.contains_key(eh)) {
+                panic("edge {} is not contained in the bvh!", eh.get_idx());
+            }
+            auto edge = edge_indices[eh];
+            edge_hierarchy.bounds[edge] = calc_edge_bounds(edge);
+            edge_hierarchy.mark_dirty(edge, dirty_edge_nodes);
+        }
+    }
+    vertex_hierarchy.update_dirty_nodes(dirty_vertex_nodes);
+    edge_hierarchy.update_dirty_nodes(dirty_edge_nodes);
+}
+
+optional<control_vertex_hit> control_polygon_bvh::pick_vertex(const line& ray, double radius) const {
+    optional<control_vertex_hit> closest;
+    auto t_max = [&]() { return closest ? closest->t : numeric_limits<double>::infinity(); };
+    visit_hit_leaves(vertex_hierarchy.nodes, vertex_hierarchy.order, ray, radius, t_max, [&](uint32_t vertex) {
+        const auto& point = positions[vertex];
+        auto t = dot(point - ray.support_vector, ray.normal);
+        if (t < 0 || (closest && (t > closest->t || (t == closest->t && closest->handle < vertices[vertex])))) {
+            return;
+        }
+        if (length(ray.support_vector + t * ray.normal - point) <= radius) {
+            closest = control_vertex_hit(vertices[vertex], point, t);
+        }
+    });
+    return closest;
+}
+
+optional<control_edge_hit> control_polygon_bvh::pick_edge(const line& ray, double radius, double t_max) const {
+    optional<control_edge_hit> closest;
+    auto current_t_max = [&]() { return closest ? closest->t : t_max; };
+    visit_hit_leaves(edge_hierarchy.nodes, edge_hierarchy.order, ray, radius, current_t_max, [&](uint32_t edge) {
+        auto start = positions[edge_vertices[edge][0]];
+        auto dir = positions[edge_vertices[edge][1]] - start;
+        auto dir_length2 = dot(dir, dir);
+        if (dir_length2 == 0) {
+            return;
+        }
+
+        // Closest points of the ray and the line through the edge, clamped to the edge
+        auto w = ray.support_vector - start;
+        auto b = dot(ray.normal, dir);
+        auto d = dot(ray.normal, w);
+        auto e = dot(dir, w);
+        auto denom = dir_length2 - b * b;
+        auto s = denom > 0 ? clamp((e - b * d) / denom, 0.0, 1.0) : 0.0;
+        auto t = s * b - d;
+        s = clamp(dot(ray.support_vector + t * ray.normal - start, dir) / dir_length2, 0.0, 1.0);
+        auto point = start + s * dir;
+        t = dot(point - ray.support_vector, ray.normal);
+
+        if (t < 0 || t > t_max) {
+            return;
+        }
+        if (closest && (t > closest->t || (t == closest->t && closest->handle < edges[edge]))) {
+            return;
+        }
+        if (length(ray.support_vector + t * ray.normal - point) <= radius) {
+            closest = control_edge_hit(edges[edge], point, t);
+        }
+    });
+    return closest;
+}
+
+size_t control_polygon_bvh::num_vertices() const {
+    return vertices.size();
+}
+
+size_t control_polygon_bvh::num_edges() const {
+    return edges.size();
+}
+
+aa_box control_polygon_bvh::calc_edge_bounds(uint32_t edge) const {
+    return aa_box(positions[edge_vertices[edge][0]], positions[edge_vertices[edge][1]]);
+}
+
+void control_polygon_bvh::hierarchy::build() {
+    if (bounds.empty()) {
+        return;
+    }
+
+    order.resize(bounds.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    leaves.resize(bounds.size());
+    nodes.reserve(2 * bounds.size() / MAX_LEAF_SIZE + 1);
+    build(0, static_cast<uint32_t>(bounds.size()), 0);
+}
+
+uint32_t control_polygon_bvh::hierarchy::build(uint32_t first, uint32_t count, uint32_t parent) {
+    auto idx = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(node());
+    nodes[idx].parent = parent;
+
+    if (count <= MAX_LEAF_SIZE) {
+        nodes[idx].first = first;
+        nodes[idx].count = count;
+        for (uint32_t i = first; i < first + count; ++i) {
+            leaves[order[i]] = idx;
+        }
+        update_node_bounds(idx);
+        return idx;
+    }
+
+    // Split at the median of the element centers along the longest axis
+    aa_box centers;
+    for (uint32_t i = first; i < first + count; ++i) {
+        centers.extend(bounds[order[i]].get_center());
+    }
+    auto extent = centers.max_corner - centers.min_corner;
+    int axis = 0;
+    if (extent.y > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+
+    auto half = count / 2;
+    auto begin = order.begin() + first;
+    nth_element(begin, begin + half, begin + count, [&](uint32_t a, uint32_t b) {
+        auto center_a = bounds[a].get_center()[axis];
+        auto center_b = bounds[b].get_center()[axis];
+        return center_a < center_b || (center_a == center_b && a < b);
+    });
+
+    build(first, half, idx);
+    auto right = build(first + half, count - half, idx);
+    nodes[idx].first = right;
+    nodes[idx].count = 0;
+    update_node_bounds(idx);
+    return idx;
+}
+
+void control_polygon_bvh::hierarchy::mark_dirty(uint32_t element, vector<bool>& dirty) const {
+    auto node_idx = leaves[element];
+    while (!dirty[node_idx]) {
+        dirty[node_idx] = true;
+        node_idx = nodes[node_idx].parent;
+    }
+}
+
+void control_polygon_bvh::hierarchy::update_dirty_nodes(const vector<bool>& dirty) {
+    // Children are stored behind their parents, so they are updated first
+    for (auto i = nodes.size(); i-- > 0;) {
+        if (dirty[i]) {
+            update_node_bounds(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void control_polygon_bvh::hierarchy::update_node_bounds(uint32_t idx) {
+    auto& current = nodes[idx];
+    current.bounds = aa_box();
+    if (current.count == 0) {
+        current.bounds.extend(nodes[idx + 1].bounds);
+        current.bounds.extend(nodes[current.first].bounds);
+    } else {
+        for (uint32_t i = current.first; i < current.first + current.count; ++i) {
+            current.bounds.extend(bounds[order[i]]);
+        }
+    }
+}
+
+}
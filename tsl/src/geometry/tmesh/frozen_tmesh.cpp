@@ -0,0 +1,323 @@
+#include <optional>
+
+#include "tsl/geometry/tmesh/frozen_tmesh.hpp"
+#include "tsl/geometry/tmesh/tmesh.hpp"
+
+using std::nullopt;
+
+namespace tsl {
+
+frozen_tmesh::frozen_tmesh(const tmesh& mesh) {
+    // Half edges
+    auto num_edge_slots = mesh.edges.size();
+    edge_next.assign(num_edge_slots, NONE);
+    edge_prev.assign(num_edge_slots, NONE);
+    edge_target.assign(num_edge_slots, NONE);
+    edge_face.assign(num_edge_slots, NONE);
+    edge_knot.assign(num_edge_slots, 0);
+    edge_has_knot.assign(num_edge_slots, 0);
+    edge_corner.assign(num_edge_slots, NO_CORNER);
+    half_edge_handles.reserve(mesh.edges.num_used());
+    for (index i = 0; i < num_edge_slots; ++i) {
+        half_edge_handle eh(i);
+        auto e = mesh.edges.get(eh);
+        if (!e) {
+            continue;
+        }
+        const half_edge& edge = *e;
+        half_edge_handles.push_back(eh);
+        edge_next[i] = edge.next.get_idx();
+        edge_prev[i] = edge.prev.get_idx();
+        edge_target[i] = edge.target.get_idx();
+        if (edge.face) {
+            edge_face[i] = edge.face.unwrap().get_idx();
+        }
+        if (edge.knot) {
+            edge_knot[i] = *edge.knot;
+            edge_has_knot[i] = 1;
+        }
+        if (edge.corner) {
+            edge_corner[i] = static_cast<uint8_t>(*edge.corner);
+        }
+    }
+
+    // Faces
+    auto num_face_slots = mesh.faces.size();
+    face_edge.assign(num_face_slots, NONE);
+    face_handles.reserve(mesh.faces.num_used());
+    for (index i = 0; i < num_face_slots; ++i) {
+        face_handle fh(i);
+        auto f = mesh.faces.get(fh);
+        if (!f) {
+            continue;
+        }
+        face_handles.push_back(fh);
+        face_edge[i] = (*f).get().edge.get_idx();
+    }
+
+    // Vertices
+    auto num_vertex_slots = mesh.vertices.size();
+    vertex_out.assign(num_vertex_slots, NONE);
+    vertex_valence.assign(num_vertex_slots, 0);
+    vertex_extended_valence.assign(num_vertex_slots, 0);
+    pos_x.assign(num_vertex_slots, 0);
+    pos_y.assign(num_vertex_slots, 0);
+    pos_z.assign(num_vertex_slots, 0);
+    vertex_handles.reserve(mesh.vertices.num_used());
+    for (index i = 0; i < num_vertex_slots; ++i) {
+        vertex_handle vh(i);
+        auto v = mesh.vertices.get(vh);
+        if (!v) {
+            continue;
+        }
+        const vertex& vert = *v;
+        vertex_handles.push_back(vh);
+        pos_x[i] = vert.pos.x;
+        pos_y[i] = vert.pos.y;
+        pos_z[i] = vert.pos.z;
+        if (!vert.outgoing) {
+            continue;
+        }
+        vertex_out[i] = vert.outgoing.unwrap().get_idx();
+
+        // The topology of the half edges is complete, so the valences can be precalculated
+        uint32_t valence = 0;
+        uint32_t extended_valence = 0;
+        for (const auto& eh: get_half_edges_of_vertex(vh, edge_direction::ingoing)) {
+            valence += 1;
+            extended_valence += 1;
+            if (corner(eh) && !*corner(eh)) {
+                extended_valence += 1;
+            }
+        }
+        vertex_valence[i] = valence;
+        vertex_extended_valence[i] = extended_valence;
+    }
+}
+
+// ========================================================================
+// = Get numbers
+// ========================================================================
+size_t frozen_tmesh::num_vertices() const {
+    return vertex_handles.size();
+}
+
+size_t frozen_tmesh::num_faces() const {
+    return face_handles.size();
+}
+
+size_t frozen_tmesh::num_half_edges() const {
+    return half_edge_handles.size();
+}
+
+size_t frozen_tmesh::vertex_index_bound() const {
+    return vertex_out.size();
+}
+
+size_t frozen_tmesh::face_index_bound() const {
+    return face_edge.size();
+}
+
+size_t frozen_tmesh::half_edge_index_bound() const {
+    return edge_next.size();
+}
+
+size_t frozen_tmesh::get_valence(vertex_handle handle) const {
+    return vertex_valence[handle.get_idx()];
+}
+
+size_t frozen_tmesh::get_extended_valence(vertex_handle handle) const {
+    return vertex_extended_valence[handle.get_idx()];
+}
+
+bool frozen_tmesh::is_extraordinary(vertex_handle handle) const {
+    return get_extended_valence(handle) != 4;
+}
+
+// ========================================================================
+// = Get attributes
+// ========================================================================
+vec3 frozen_tmesh::get_vertex_position(vertex_handle handle) const {
+    auto i = handle.get_idx();
+    return vec3(pos_x[i], pos_y[i], pos_z[i]);
+}
+
+void frozen_tmesh::set_vertex_position(vertex_handle handle, const vec3& pos) {
+    auto i = handle.get_idx();
+    pos_x[i] = pos.x;
+    pos_y[i] = pos.y;
+    pos_z[i] = pos.z;
+}
+
+optional<double> frozen_tmesh::get_knot_interval(half_edge_handle handle) const {
+    if (!edge_has_knot[handle.get_idx()]) {
+        return nullopt;
+    }
+    return edge_knot[handle.get_idx()];
+}
+
+optional<bool> frozen_tmesh::corner(half_edge_handle handle) const {
+    auto corner = edge_corner[handle.get_idx()];
+    if (corner == NO_CORNER) {
+        return nullopt;
+    }
+    return corner != 0;
+}
+
+optional<bool> frozen_tmesh::from_corner(half_edge_handle handle) const {
+    return corner(get_prev(handle));
+}
+
+optional<double> frozen_tmesh::get_knot_factor(half_edge_handle handle) const {
+    auto twin = get_twin(handle);
+    if (!edge_has_knot[handle.get_idx()] || !edge_has_knot[twin.get_idx()]) {
+        return nullopt;
+    }
+    return edge_knot[handle.get_idx()] / edge_knot[twin.get_idx()];
+}
+
+// ========================================================================
+// = Follow pointer
+// ========================================================================
+half_edge_handle frozen_tmesh::get_twin(half_edge_handle handle) const {
+    return half_edge_handle(handle.get_idx() ^ 1);
+}
+
+half_edge_handle frozen_tmesh::get_next(half_edge_handle handle) const {
+    return half_edge_handle(edge_next[handle.get_idx()]);
+}
+
+half_edge_handle frozen_tmesh::get_prev(half_edge_handle handle) const {
+    return half_edge_handle(edge_prev[handle.get_idx()]);
+}
+
+vertex_handle frozen_tmesh::get_target(half_edge_handle handle) const {
+    return vertex_handle(edge_target[handle.get_idx()]);
+}
+
+optional_half_edge_handle frozen_tmesh::get_out(vertex_handle handle) const {
+    auto out = vertex_out[handle.get_idx()];
+    return out == NONE ? optional_half_edge_handle() : optional_half_edge_handle(out);
+}
+
+half_edge_handle frozen_tmesh::get_edge(face_handle handle) const {
+    return half_edge_handle(face_edge[handle.get_idx()]);
+}
+
+optional_face_handle frozen_tmesh::get_face_of_half_edge(half_edge_handle handle) const {
+    auto face = edge_face[handle.get_idx()];
+    return face == NONE ? optional_face_handle() : optional_face_handle(face);
+}
+
+// ========================================================================
+// = Get elements around elements
+// ========================================================================
+void frozen_tmesh::get_vertices_of_face(face_handle handle, vector<vertex_handle>& vertices_out) const {
+    auto start = face_edge[handle.get_idx()];
+    auto current = start;
+    do {
+        vertices_out.emplace_back(edge_target[current]);
+        current = edge_next[current];
+    } while (current != start);
+}
+
+vector<half_edge_handle> frozen_tmesh::get_half_edges_of_face(face_handle handle) const {
+    vector<half_edge_handle> out;
+    out.reserve(4);
+    auto start = face_edge[handle.get_idx()];
+    auto current = start;
+    do {
+        out.emplace_back(current);
+        current = edge_next[current];
+    } while (current != start);
+    return out;
+}
+
+vector<half_edge_handle> frozen_tmesh::get_half_edges_of_vertex(vertex_handle handle, edge_direction way) const {
+    vector<half_edge_handle> out;
+    auto outgoing = vertex_out[handle.get_idx()];
+    if (outgoing == NONE) {
+        return out;
+    }
+
+    switch (way) {
+        case edge_direction::ingoing: {
+            auto start = outgoing ^ 1;
+            auto current = start;
+            do {
+                out.emplace_back(current);
+                current = edge_next[current] ^ 1;
+            } while (current != start);
+            break;
+        }
+        case edge_direction::outgoing: {
+            auto current = outgoing;
+            do {
+                out.emplace_back(current);
+                current = edge_next[current ^ 1];
+            } while (current != outgoing);
+            break;
+        }
+    }
+    return out;
+}
+
+optional_half_edge_handle frozen_tmesh::get_half_edge_between(face_handle ah, face_handle bh) const {
+    auto start = face_edge[ah.get_idx()];
+    auto current = start;
+    do {
+        if (edge_face[current ^ 1] == bh.get_idx()) {
+            return optional_half_edge_handle(current);
+        }
+        current = edge_next[current];
+    } while (current != start);
+    return optional_half_edge_handle();
+}
+
+// ========================================================================
+// = Iterator helper
+// ========================================================================
+const vector<vertex_handle>& frozen_tmesh::get_vertices() const {
+    return vertex_handles;
+}
+
+const vector<face_handle>& frozen_tmesh::get_faces() const {
+    return face_handles;
+}
+
+const vector<half_edge_handle>& frozen_tmesh::get_half_edges() const {
+    return half_edge_handles;
+}
+
+memory_usage_report frozen_tmesh::memory_report() const {
+    memory_usage half_edges;
+    half_edges += get_memory_usage(edge_next);
+    half_edges += get_memory_usage(edge_prev);
+    half_edges += get_memory_usage(edge_target);
+    half_edges += get_memory_usage(edge_face);
+    half_edges += get_memory_usage(edge_knot);
+    half_edges += get_memory_usage(edge_has_knot);
+    half_edges += get_memory_usage(edge_corner);
+
+    memory_usage vertices;
+    vertices += get_memory_usage(vertex_out);
+    vertices += get_memory_usage(vertex_valence);
+    vertices += get_memory_usage(vertex_extended_valence);
+    vertices += get_memory_usage(pos_x);
+    vertices += get_memory_usage(pos_y);
+    vertices += get_memory_usage(pos_z);
+
+    memory_usage handles;
+    handles += get_memory_usage(vertex_handles);
+    handles += get_memory_usage(face_handles);
+    handles += get_memory_usage(half_edge_handles);
+
+    memory_usage_report out;
+    out.add("half_edges", half_edges);
+    out.add("faces", get_memory_usage(face_edge));
+    out.add("vertices", vertices);
+    out.add("handles", handles);
+    return out;
+}
+
+}
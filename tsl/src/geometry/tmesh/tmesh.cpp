@@ -3,10 +3,11 @@
 #include <algorithm>
 #include <optional>
 
+#include "tsl/util/parallel.hpp"
 #include "tsl/util/println.hpp"
 #include "tsl/geometry/tmesh/tmesh.hpp"
 #include "tsl/geometry/tmesh/iterator.hpp"
-#include "tsl/algorithm/get_vertices.hpp"
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
 
 using std::make_unique;
 using std::min;
@@ -18,6 +19,8 @@ using std::find;
 using std::make_pair;
 using std::find_if;
 using std::distance;
+using std::stable_sort;
+using std::move;
 
 namespace tsl {
 
@@ -375,38 +378,83 @@ face_handle tmesh::add_face(const array<vertex_handle, 4>& new_vertices) {
 }
 
 bool tmesh::remove_edge(edge_handle handle, bool keep_vertices) {
-    // TODO: Check this implementation for edge cases.
-    auto [half_edge_1_h, half_edge_2_h] = get_half_edges_of_edge(handle);
-    const auto& half_edge_1 = get_e(half_edge_1_h);
-    const auto& half_edge_2 = get_e(half_edge_2_h);
-
     // We may not delete edges near extraordinary vertices
-    {
-        if (is_extraordinary(half_edge_1.target) || is_extraordinary(half_edge_2.target)) {
-            return false;
-        }
+    auto [vertex_1_h, vertex_2_h] = get_vertices_of_edge(handle);
+    if (is_near_extraordinary_vertex(*this, vertex_1_h, vertex_2_h, EXTRAORDINARY_RINGS)) {
+        return false;
+    }
 
-        // find extraordinary vertices around one vertex
-        auto vertices1 = get_extraordinary_vertices_in_regular_rings_around_vertex(*this, half_edge_1.target, 3);
-        bool found = false;
-
-        // if one extraordinary vertex is near both vertices of the edge, the edge is too close to that vertex
-        // and we are not allowed to remove it
-        visit_regular_rings(*this, half_edge_2.target, 3, [this, &vertices1, &found](auto handle, auto ring) {
-            if (is_extraordinary(handle)) {
-                auto in_vertices = find(vertices1.begin(), vertices1.end(), handle);
-                if (vertices1.end() != in_vertices) {
-                    found = true;
-                    return false;
-                }
+    return static_cast<bool>(try_remove_edge(handle, keep_vertices));
+}
+
+bool tmesh::remove_edge(edge_handle handle, extraordinary_distance_field& field, bool keep_vertices) {
+    auto [vertex_1_h, vertex_2_h] = get_vertices_of_edge(handle);
+    if (field.is_near_both(vertex_1_h, vertex_2_h)) {
+        return false;
+    }
+
+    auto merged_face_h = try_remove_edge(handle, keep_vertices);
+    if (!merged_face_h) {
+        return false;
+    }
+    field.update_face(*this, merged_face_h.unwrap());
+    return true;
+}
+
+bool tmesh::can_remove_edge(
+    edge_handle handle,
+    const extraordinary_distance_field& field,
+    bool keep_vertices
+) const {
+    auto [vertex_1_h, vertex_2_h] = get_vertices_of_edge(handle);
+    return !field.is_near_both(vertex_1_h, vertex_2_h) && is_removable(handle, keep_vertices);
+}
+
+size_t tmesh::remove_independent_edges(
+    const vector<edge_handle>& handles,
+    extraordinary_distance_field& field,
+    size_t max_threads,
+    bool keep_vertices
+) {
+    // The edges don't share any elements, so only erasing the removed ones has to wait until all threads are done
+    vector<optional_face_handle> merged_faces(handles.size());
+    vector<removed_elements> removed(get_num_chunks(handles.size(), max_threads));
+    parallel_chunks(handles.size(), [&](size_t begin, size_t end, size_t chunk) {
+        for (auto i = begin; i < end; ++i) {
+            auto [vertex_1_h, vertex_2_h] = get_vertices_of_edge(handles[i]);
+            if (!field.is_near_both(vertex_1_h, vertex_2_h)) {
+                merged_faces[i] = try_remove_edge(handles[i], keep_vertices, &removed[chunk]);
             }
-            return true;
-        });
+        }
+    }, max_threads);
 
-        if (found) {
-            return false;
+    for (const auto& elements: removed) {
+        for (const auto& eh: elements.half_edges) {
+            edges.erase(eh);
+        }
+        for (const auto& fh: elements.faces) {
+            faces.erase(fh);
+        }
+        for (const auto& vh: elements.vertices) {
+            vertices.erase(vh);
+        }
+    }
+
+    size_t out = 0;
+    for (const auto& merged_face_h: merged_faces) {
+        if (merged_face_h) {
+            field.update_face(*this, merged_face_h.unwrap());
+            out += 1;
         }
     }
+    return out;
+}
+
+bool tmesh::is_removable(edge_handle handle, bool keep_vertices) const {
+    // TODO: Check this implementation for edge cases.
+    auto [half_edge_1_h, half_edge_2_h] = get_half_edges_of_edge(handle);
+    const auto& half_edge_1 = get_e(half_edge_1_h);
+    const auto& half_edge_2 = get_e(half_edge_2_h);
 
     // we cannot remove edges pointing to vertices which have 2 or less edges connected
     if (get_valence(half_edge_1.target) < 3 || get_valence(half_edge_2.target) < 3) {
@@ -429,6 +477,17 @@ bool tmesh::remove_edge(edge_handle handle, bool keep_vertices) {
     if (!half_edge_1.face || !half_edge_2.face) {
         return false;
     }
+    return true;
+}
+
+optional_face_handle tmesh::try_remove_edge(edge_handle handle, bool keep_vertices, removed_elements* removed) {
+    if (!is_removable(handle, keep_vertices)) {
+        return optional_face_handle();
+    }
+
+    auto [half_edge_1_h, half_edge_2_h] = get_half_edges_of_edge(handle);
+    const auto& half_edge_1 = get_e(half_edge_1_h);
+    const auto& half_edge_2 = get_e(half_edge_2_h);
     auto face1_h = half_edge_1.face.unwrap();
     auto face2_h = half_edge_2.face.unwrap();
 
@@ -496,9 +555,15 @@ bool tmesh::remove_edge(edge_handle handle, bool keep_vertices) {
     }
 
     // actually delete the edge and face 1
-    edges.erase(half_edge_1_h);
-    edges.erase(half_edge_2_h);
-    faces.erase(face1_h);
+    if (removed) {
+        removed->half_edges.push_back(half_edge_1_h);
+        removed->half_edges.push_back(half_edge_2_h);
+        removed->faces.push_back(face1_h);
+    } else {
+        edges.erase(half_edge_1_h);
+        edges.erase(half_edge_2_h);
+        faces.erase(face1_h);
+    }
 
     // we need to fix invalid edges created because of removed t-edges
     // the situation we end up in looks like this: with vertex_1_h or vertex_2_h beeing v4
@@ -569,13 +634,145 @@ bool tmesh::remove_edge(edge_handle handle, bool keep_vertices) {
             }
 
             // actually delete the vertex and half edges
-            edges.erase(he11_h);
-            edges.erase(he12_h);
-            vertices.erase(v4_h);
+            if (removed) {
+                removed->half_edges.push_back(he11_h);
+                removed->half_edges.push_back(he12_h);
+                removed->vertices.push_back(v4_h);
+            } else {
+                edges.erase(he11_h);
+                edges.erase(he12_h);
+                vertices.erase(v4_h);
+            }
         }
     }
 
-    return true;
+    return optional_face_handle(face2_h);
+}
+
+void tmesh::reorder() {
+    const index NONE = static_cast<index>(-1);
+
+    auto get_degree = [this](face_handle fh) {
+        index degree = 0;
+        circulate_in_face(fh, [&, this](auto eh) {
+            if (get_e(get_twin(eh)).face) {
+                degree += 1;
+            }
+            return true;
+        });
+        return degree;
+    };
+
+    // Order faces breadth first, starting a new search for each connected component
+    vector<index> new_face_idx(faces.size(), NONE);
+    vector<face_handle> face_order;
+    face_order.reserve(faces.num_used());
+    vector<pair<index, face_handle>> neighbours;
+    for (const auto& start: faces) {
+        if (new_face_idx[start.get_idx()] != NONE) {
+            continue;
+        }
+        new_face_idx[start.get_idx()] = static_cast<index>(face_order.size());
+        face_order.push_back(start);
+        for (size_t head = face_order.size() - 1; head < face_order.size(); ++head) {
+            neighbours.clear();
+            circulate_in_face(face_order[head], [&, this](auto eh) {
+                auto twin_face = get_e(get_twin(eh)).face;
+                if (twin_face && new_face_idx[twin_face.unwrap().get_idx()] == NONE) {
+                    neighbours.emplace_back(get_degree(twin_face.unwrap()), twin_face.unwrap());
+                }
+                return true;
+            });
+            stable_sort(neighbours.begin(), neighbours.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+            for (const auto& [degree, fh]: neighbours) {
+                if (new_face_idx[fh.get_idx()] == NONE) {
+                    new_face_idx[fh.get_idx()] = static_cast<index>(face_order.size());
+                    face_order.push_back(fh);
+                }
+            }
+        }
+    }
+
+    // Number vertices and edges in the order they are reached from the faces. Edges are numbered as pairs, because
+    // the twin of a half edge is determined by its index.
+    vector<index> new_vertex_idx(vertices.size(), NONE);
+    vector<vertex_handle> vertex_order;
+    vertex_order.reserve(vertices.num_used());
+    vector<index> new_pair_idx(edges.size() / 2, NONE);
+    vector<index> pair_order;
+    pair_order.reserve(edges.num_used() / 2);
+    auto add_vertex_to_order = [&](vertex_handle vh) {
+        if (new_vertex_idx[vh.get_idx()] == NONE) {
+            new_vertex_idx[vh.get_idx()] = static_cast<index>(vertex_order.size());
+            vertex_order.push_back(vh);
+        }
+    };
+    auto add_pair_to_order = [&](index pair_idx) {
+        if (new_pair_idx[pair_idx] == NONE) {
+            new_pair_idx[pair_idx] = static_cast<index>(pair_order.size());
+            pair_order.push_back(pair_idx);
+        }
+    };
+    for (const auto& fh: face_order) {
+        circulate_in_face(fh, [&, this](auto eh) {
+            add_vertex_to_order(get_e(eh).target);
+            add_pair_to_order(eh.get_idx() / 2);
+            return true;
+        });
+    }
+
+    // Elements which are not part of any face are appended in their old order
+    for (const auto& vh: vertices) {
+        add_vertex_to_order(vh);
+    }
+    for (const auto& eh: edges) {
+        add_pair_to_order(eh.get_idx() / 2);
+    }
+
+    auto remap_edge = [&](half_edge_handle eh) {
+        return half_edge_handle(new_pair_idx[eh.get_idx() / 2] * 2 + eh.get_idx() % 2);
+    };
+
+    // Rebuild all element vectors in the new order
+    stable_vector<half_edge_handle, half_edge> new_edges;
+    for (const auto& pair_idx: pair_order) {
+        for (index side = 0; side < 2; ++side) {
+            auto edge = get_e(half_edge_handle(pair_idx * 2 + side));
+            if (edge.face) {
+                edge.face = optional_face_handle(new_face_idx[edge.face.unwrap().get_idx()]);
+            }
+            edge.target = vertex_handle(new_vertex_idx[edge.target.get_idx()]);
+            edge.next = remap_edge(edge.next);
+            edge.prev = remap_edge(edge.prev);
+            new_edges.push(move(edge));
+        }
+    }
+
+    stable_vector<face_handle, face> new_faces;
+    for (const auto& fh: face_order) {
+        new_faces.push(face(remap_edge(get_f(fh).edge)));
+    }
+
+    stable_vector<vertex_handle, vertex> new_vertices;
+    for (const auto& vh: vertex_order) {
+        auto v = get_v(vh);
+        if (v.outgoing) {
+            v.outgoing = optional_half_edge_handle(remap_edge(v.outgoing.unwrap()));
+        }
+        new_vertices.push(move(v));
+    }
+
+    edges = move(new_edges);
+    faces = move(new_faces);
+    vertices = move(new_vertices);
+}
+
+void tmesh::reserve(size_t num_vertices, size_t num_faces, size_t num_edges) {
+    vertices.reserve(num_vertices);
+    faces.reserve(num_faces);
+    edges.reserve(2 * num_edges);
 }
 
 // ========================================================================
@@ -601,6 +798,15 @@ size_t tmesh::num_half_edges() const
     return edges.num_used();
 }
 
+memory_usage_report tmesh::memory_report() const
+{
+    memory_usage_report out;
+    out.add("half_edges", edges.get_memory_usage());
+    out.add("faces", faces.get_memory_usage());
+    out.add("vertices", vertices.get_memory_usage());
+    return out;
+}
+
 uint8_t tmesh::num_adjacent_faces(edge_handle handle) const
 {
     auto faces_of_edge = get_faces_of_edge(handle);
@@ -635,6 +841,11 @@ bool tmesh::is_extraordinary(vertex_handle handle) const {
 // ========================================================================
 // = Get attributes
 // ========================================================================
+bool tmesh::contains(vertex_handle handle) const
+{
+    return static_cast<bool>(vertices.get(handle));
+}
+
 vec3 tmesh::get_vertex_position(vertex_handle handle) const
 {
     return get_v(handle).pos;
@@ -0,0 +1,123 @@
+// Replaces the global allocation functions to count all heap allocations (see `tsl/util/alloc_stats.hpp`). This file
+// is not part of the library, it's only compiled into the executables, if the CMake option `TSL_ALLOC_HOOKS` is
+// enabled.
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "tsl/util/alloc_stats.hpp"
+
+namespace {
+
+void* allocate(size_t size) {
+    tsl::record_alloc(size);
+    // malloc(0) may return null, but operator new has to return a unique pointer
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocate_aligned(size_t size, std::align_val_t alignment) {
+    tsl::record_alloc(size);
+    auto align = static_cast<size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment
+    auto padded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+    return std::aligned_alloc(align, padded);
+}
+
+struct tracking_enabler {
+    tracking_enabler() {
+        tsl::enable_alloc_tracking();
+    }
+};
+
+tracking_enabler enabler;
+
+}
+
+void* operator new(size_t size) {
+    auto ptr = allocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    auto ptr = allocate_aligned(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,36 @@
+#include <atomic>
+
+#include "tsl/util/alloc_stats.hpp"
+
+using std::atomic;
+using std::memory_order_relaxed;
+
+namespace tsl {
+
+namespace {
+
+// Constant initialized, so the hooks can be called before any dynamic initialization
+atomic<bool> tracking_enabled(false);
+atomic<uint64_t> alloc_count(0);
+atomic<uint64_t> alloc_bytes(0);
+
+}
+
+bool is_alloc_tracking_enabled() {
+    return tracking_enabled.load(memory_order_relaxed);
+}
+
+alloc_stats get_alloc_stats() {
+    return alloc_stats(alloc_count.load(memory_order_relaxed), alloc_bytes.load(memory_order_relaxed));
+}
+
+void record_alloc(size_t bytes) {
+    alloc_count.fetch_add(1, memory_order_relaxed);
+    alloc_bytes.fetch_add(bytes, memory_order_relaxed);
+}
+
+void enable_alloc_tracking() {
+    tracking_enabled.store(true, memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,72 @@
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tsl/util/memory_report.hpp"
+
+using std::max;
+
+using fmt::format;
+
+namespace tsl {
+
+memory_usage& memory_usage::operator+=(const memory_usage& other) {
+    used_bytes += other.used_bytes;
+    deleted_bytes += other.deleted_bytes;
+    reserved_bytes += other.reserved_bytes;
+    return *this;
+}
+
+void memory_usage_report::add(const string& name, const memory_usage& usage) {
+    entries.emplace_back(name, usage);
+}
+
+void memory_usage_report::add(const string& prefix, const memory_usage_report& report) {
+    for (const auto& [name, usage]: report.entries) {
+        entries.emplace_back(prefix + "/" + name, usage);
+    }
+}
+
+memory_usage memory_usage_report::get(const string& name) const {
+    memory_usage out;
+    for (const auto& [entry_name, usage]: entries) {
+        if (entry_name == name) {
+            out += usage;
+        }
+    }
+    return out;
+}
+
+memory_usage memory_usage_report::get_total() const {
+    memory_usage out;
+    for (const auto& entry: entries) {
+        out += entry.second;
+    }
+    return out;
+}
+
+string memory_usage_report::to_string() const {
+    size_t width = 5;
+    for (const auto& entry: entries) {
+        width = max(width, entry.first.size());
+    }
+
+    auto out = format("{:<{}}  {:>14}  {:>14}  {:>14}\n", "name", width, "used", "deleted", "reserved");
+    auto add_line = [&](const string& name, const memory_usage& usage) {
+        out += format(
+            "{:<{}}  {:>14}  {:>14}  {:>14}\n",
+            name,
+            width,
+            usage.used_bytes,
+            usage.deleted_bytes,
+            usage.reserved_bytes
+        );
+    };
+    for (const auto& [name, usage]: entries) {
+        add_line(name, usage);
+    }
+    add_line("total", get_total());
+    return out;
+}
+
+}
@@ -0,0 +1,210 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "tsl/util/trace.hpp"
+
+using std::array;
+using std::atomic;
+using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::mutex;
+using std::ofstream;
+using std::unique_ptr;
+using std::vector;
+
+using fmt::format;
+
+namespace tsl {
+
+namespace {
+
+/// Number of zones stored in one chunk of a thread buffer.
+constexpr size_t CHUNK_SIZE = 1024;
+
+/**
+ * @brief POD type to hold a recorded zone.
+ */
+struct trace_event {
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+/**
+ * @brief Part of a thread buffer. Only the owning thread writes to it, the size is published with release semantics,
+ *        so readers see all events up to the size they read.
+ */
+struct trace_chunk {
+    array<trace_event, CHUNK_SIZE> events;
+    atomic<size_t> size;
+    atomic<trace_chunk*> next;
+
+    trace_chunk() : size(0), next(nullptr) {}
+};
+
+/**
+ * @brief The zones recorded by one thread. When a thread exits, its buffer is reused by the next new thread, so
+ *        short-living threads (e.g. of `parallel_for`) don't need a buffer each.
+ */
+struct trace_buffer {
+    /// Id of the buffer, which is used as thread id in the trace.
+    size_t id;
+    trace_chunk head;
+    /// Last chunk, only used by the owning thread.
+    trace_chunk* tail;
+    atomic<bool> in_use;
+
+    explicit trace_buffer(size_t id) : id(id), tail(&head), in_use(true) {}
+
+    ~trace_buffer() {
+        auto chunk = head.next.load(memory_order_acquire);
+        while (chunk != nullptr) {
+            auto next = chunk->next.load(memory_order_acquire);
+            delete chunk;
+            chunk = next;
+        }
+    }
+};
+
+/**
+ * @brief Owns the buffers of all threads, so their zones survive the threads.
+ */
+struct trace_registry {
+    /// Only locked to add or reuse buffers and to export them.
+    mutex lock;
+    vector<unique_ptr<trace_buffer>> buffers;
+};
+
+trace_registry& get_registry() {
+    static trace_registry registry;
+    return registry;
+}
+
+atomic<bool> tracing(false);
+
+/// Zones, which started before this time, were discarded by `clear_trace`.
+atomic<int64_t> cleared_at(-1);
+
+const auto ORIGIN = std::chrono::steady_clock::now();
+
+/**
+ * @brief Releases the buffer of a thread, when the thread exits.
+ */
+struct thread_slot {
+    trace_buffer* buffer = nullptr;
+
+    ~thread_slot() {
+        if (buffer != nullptr) {
+            buffer->in_use.store(false, memory_order_release);
+        }
+    }
+};
+
+thread_local thread_slot slot;
+
+trace_buffer& get_thread_buffer() {
+    if (slot.buffer != nullptr) {
+        return *slot.buffer;
+    }
+
+    auto& registry = get_registry();
+    lock_guard<mutex> guard(registry.lock);
+    for (auto& buffer: registry.buffers) {
+        auto expected = false;
+        if (buffer->in_use.compare_exchange_strong(expected, true, memory_order_acquire)) {
+            slot.buffer = buffer.get();
+            return *slot.buffer;
+        }
+    }
+    registry.buffers.push_back(std::make_unique<trace_buffer>(registry.buffers.size()));
+    slot.buffer = registry.buffers.back().get();
+    return *slot.buffer;
+}
+
+}
+
+void start_trace() {
+    tracing.store(TRACE_COMPILED, memory_order_relaxed);
+}
+
+void stop_trace() {
+    tracing.store(false, memory_order_relaxed);
+}
+
+bool is_tracing() {
+    return tracing.load(memory_order_relaxed);
+}
+
+void clear_trace() {
+    cleared_at.store(get_trace_time(), memory_order_relaxed);
+}
+
+string trace_to_json() {
+    string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    auto first = true;
+    auto min_begin = cleared_at.load(memory_order_relaxed);
+
+    auto& registry = get_registry();
+    lock_guard<mutex> guard(registry.lock);
+    for (const auto& buffer: registry.buffers) {
+        const trace_chunk* chunk = &buffer->head;
+        while (chunk != nullptr) {
+            auto size = chunk->size.load(memory_order_acquire);
+            for (size_t i = 0; i < size; ++i) {
+                const auto& event = chunk->events[i];
+                if (event.begin < min_begin) {
+                    continue;
+                }
+                out += first ? "\n" : ",\n";
+                out += format(
+                    "{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+                    event.name,
+                    buffer->id,
+                    event.begin / 1e3,
+                    (event.end - event.begin) / 1e3
+                );
+                first = false;
+            }
+            chunk = chunk->next.load(memory_order_acquire);
+        }
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool write_trace(const string& path) {
+    ofstream out(path);
+    out << trace_to_json();
+    return static_cast<bool>(out);
+}
+
+int64_t get_trace_time() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ORIGIN).count();
+}
+
+void record_trace_zone(const char* name, int64_t begin, int64_t end) {
+    auto& buffer = get_thread_buffer();
+    auto chunk = buffer.tail;
+    auto size = chunk->size.load(memory_order_relaxed);
+    if (size == CHUNK_SIZE) {
+        auto next = new trace_chunk();
+        chunk->next.store(next, memory_order_release);
+        buffer.tail = next;
+        chunk = next;
+        size = 0;
+    }
+    chunk->events[size] = {name, begin, end};
+    chunk->size.store(size + 1, memory_order_release);
+}
+
+}
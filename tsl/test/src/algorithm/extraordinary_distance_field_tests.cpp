@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "tsl/algorithm/extraordinary_distance_field.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+tmesh get_mesh() {
+    synthetic_tmesh_config config;
+    config.width = 24;
+    config.height = 24;
+    config.t_junction_density = 0.2;
+    config.valences = {3, 5};
+    config.max_knot_ratio = 2.0;
+    config.seed = 7;
+    return tmesh_synthetic(config);
+}
+
+void expect_same_field(
+    const tmesh& mesh,
+    const extraordinary_distance_field& expected,
+    const extraordinary_distance_field& actual
+) {
+    for (auto vh: mesh.get_vertices()) {
+        EXPECT_EQ(expected.get_nearest(vh).distance, actual.get_nearest(vh).distance);
+        EXPECT_EQ(expected.get_nearest(vh).vertices, actual.get_nearest(vh).vertices);
+    }
+}
+
+}
+
+TEST(ExtraordinaryDistanceFieldTest, DistancesAroundExtraordinaryVertices) {
+    auto mesh = get_mesh();
+    extraordinary_distance_field field(mesh);
+    EXPECT_EQ(field.get_rings(), EXTRAORDINARY_RINGS);
+
+    size_t num_extraordinary = 0;
+    size_t counts[EXTRAORDINARY_RINGS + 2] = {};
+    for (auto vh: mesh.get_vertices()) {
+        const auto& nearest = field.get_nearest(vh);
+        ASSERT_LE(nearest.distance, EXTRAORDINARY_RINGS + 1);
+        counts[nearest.distance] += 1;
+        if (mesh.is_extraordinary(vh)) {
+            num_extraordinary += 1;
+            EXPECT_EQ(nearest.distance, 0);
+            EXPECT_EQ(nearest.vertices, vector<vertex_handle>{vh});
+        } else if (nearest.distance > EXTRAORDINARY_RINGS) {
+            EXPECT_TRUE(nearest.vertices.empty());
+        } else {
+            EXPECT_FALSE(nearest.vertices.empty());
+        }
+    }
+    EXPECT_GE(num_extraordinary, 2);
+    EXPECT_EQ(counts[0], num_extraordinary);
+    for (auto& count: counts) {
+        EXPECT_GT(count, 0);
+    }
+
+    // The field has to agree with searching the rings around the vertices of each edge
+    for (auto eh: mesh.get_edges()) {
+        auto [first, second] = mesh.get_vertices_of_edge(eh);
+        EXPECT_EQ(
+            field.is_near_both(first, second),
+            is_near_extraordinary_vertex(mesh, first, second, EXTRAORDINARY_RINGS)
+        );
+    }
+}
+
+TEST(ExtraordinaryDistanceFieldTest, UpdateMatchesRebuild) {
+    auto mesh = get_mesh();
+    extraordinary_distance_field field(mesh);
+
+    size_t removed = 0;
+    size_t count = 0;
+    for (auto eh: mesh.get_edges()) {
+        if (++count % 2 == 0 && mesh.remove_edge(eh, field)) {
+            removed += 1;
+        }
+    }
+    ASSERT_GT(removed, 0);
+
+    expect_same_field(mesh, extraordinary_distance_field(mesh), field);
+}
+
+TEST(ExtraordinaryDistanceFieldTest, RemoveEdgeWithFieldMatchesRemoveEdge) {
+    auto with_field = get_mesh();
+    auto without_field = get_mesh();
+    extraordinary_distance_field field(with_field);
+
+    size_t count = 0;
+    for (auto eh: with_field.get_edges()) {
+        if (++count % 3 == 0) {
+            auto removed = with_field.remove_edge(eh, field);
+            EXPECT_EQ(removed, without_field.remove_edge(eh));
+        }
+    }
+    EXPECT_EQ(with_field.num_faces(), without_field.num_faces());
+    EXPECT_EQ(with_field.num_edges(), without_field.num_edges());
+    EXPECT_EQ(with_field.num_vertices(), without_field.num_vertices());
+}
+
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/evaluation/subdevision.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/util/panic.hpp"
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Returns the sum of 4 minus the extended valence over all vertices, which is 0 for every closed quad mesh of genus 1.
+int64_t get_valence_deficit(const tmesh& mesh) {
+    int64_t out = 0;
+    for (auto vh: mesh.get_vertices()) {
+        out += 4 - static_cast<int64_t>(mesh.get_extended_valence(vh));
+    }
+    return out;
+}
+
+size_t count_valence(const tmesh& mesh, size_t valence) {
+    size_t out = 0;
+    for (auto vh: mesh.get_vertices()) {
+        if (mesh.get_valence(vh) == valence) {
+            out += 1;
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(GeneratorTest, SyntheticTorusIsRegular) {
+    synthetic_tmesh_config config;
+    config.width = 8;
+    config.height = 5;
+    auto mesh = tmesh_synthetic(config);
+
+    EXPECT_EQ(mesh.num_faces(), 40);
+    EXPECT_EQ(mesh.num_vertices(), 40);
+    EXPECT_EQ(mesh.num_edges(), 80);
+    for (auto vh: mesh.get_vertices()) {
+        EXPECT_FALSE(mesh.is_extraordinary(vh));
+    }
+}
+
+TEST(GeneratorTest, SyntheticTorusHasTJunctions) {
+    synthetic_tmesh_config config;
+    config.width = 20;
+    config.height = 20;
+    config.t_junction_density = 0.3;
+    config.max_knot_ratio = 3.0;
+    auto mesh = tmesh_synthetic(config);
+
+    EXPECT_GT(mesh.num_faces(), 400);
+    EXPECT_EQ(mesh.num_edges(), mesh.num_vertices() + mesh.num_faces());
+
+    size_t num_t_junctions = 0;
+    for (auto vh: mesh.get_vertices()) {
+        EXPECT_FALSE(mesh.is_extraordinary(vh));
+        if (mesh.get_valence(vh) == 3) {
+            num_t_junctions += 1;
+        }
+    }
+    EXPECT_GT(num_t_junctions, 0);
+
+    // Opposite sides of each face have the same sum of knot intervals
+    for (auto fh: mesh.get_faces()) {
+        double sums[4] = {0, 0, 0, 0};
+        auto side = 0;
+        auto edges = mesh.get_half_edges_of_face(fh);
+        for (auto eh: edges) {
+            auto twin_knot = mesh.get_knot_interval(mesh.get_twin(eh));
+            EXPECT_DOUBLE_EQ(*mesh.get_knot_interval(eh), *twin_knot);
+            sums[side] += *mesh.get_knot_interval(eh);
+            if (*mesh.corner(eh)) {
+                side += 1;
+            }
+        }
+        EXPECT_DOUBLE_EQ(sums[0], sums[2]);
+        EXPECT_DOUBLE_EQ(sums[1], sums[3]);
+    }
+}
+
+TEST(GeneratorTest, SyntheticTorusHasExtraordinaryVertices) {
+    synthetic_tmesh_config config;
+    config.width = 120;
+    config.height = 40;
+    config.t_junction_density = 0.2;
+    config.valences = {6, 12, MAX_VALENCE};
+    config.max_knot_ratio = 2.0;
+    config.sector_size = 1;
+    auto mesh = tmesh_synthetic(config);
+
+    EXPECT_EQ(get_valence_deficit(mesh), 0);
+    EXPECT_EQ(count_valence(mesh, 6), 1);
+    EXPECT_EQ(count_valence(mesh, 12), 1);
+    EXPECT_EQ(count_valence(mesh, MAX_VALENCE), 1);
+
+    auto num_faces = mesh.num_faces();
+    surface_evaluator evaluator(std::move(mesh));
+    auto grids = evaluator.eval_per_face(2);
+    EXPECT_EQ(grids.size(), num_faces);
+}
+
+TEST(GeneratorTest, SyntheticTorusIsDeterministic) {
+    synthetic_tmesh_config config;
+    config.width = 16;
+    config.height = 12;
+    config.t_junction_density = 0.5;
+    config.valences = {5};
+    config.max_knot_ratio = 4.0;
+    config.seed = 42;
+    auto first = tmesh_synthetic(config);
+    auto second = tmesh_synthetic(config);
+
+    ASSERT_EQ(first.num_vertices(), second.num_vertices());
+    ASSERT_EQ(first.num_faces(), second.num_faces());
+    for (auto vh: first.get_vertices()) {
+        EXPECT_EQ(first.get_vertex_position(vh), second.get_vertex_position(vh));
+    }
+
+    config.seed = 43;
+    auto other = tmesh_synthetic(config);
+    EXPECT_NE(first.num_faces(), other.num_faces());
+}
+
+TEST(GeneratorTest, SyntheticTorusPanicsOnInvalidConfig) {
+    synthetic_tmesh_config config;
+    config.width = 2;
+    EXPECT_THROW(tmesh_synthetic(config), panic_exception);
+
+    config = synthetic_tmesh_config();
+    config.valences = {MAX_VALENCE + 1};
+    EXPECT_THROW(tmesh_synthetic(config), panic_exception);
+
+    // The sectors of valence 3 don't fit onto the block, if the sector size is odd
+    config.valences = {3};
+    config.sector_size = 1;
+    EXPECT_THROW(tmesh_synthetic(config), panic_exception);
+
+    // The block of valence 64 needs 66x66 cells
+    config = synthetic_tmesh_config();
+    config.valences = {MAX_VALENCE};
+    EXPECT_THROW(tmesh_synthetic(config), panic_exception);
+}
+
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <utility>
+
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/algorithm/reduction.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+tmesh get_mesh() {
+    synthetic_tmesh_config config;
+    config.width = 40;
+    config.height = 40;
+    config.t_junction_density = 0.1;
+    config.valences = {3, 5, 6};
+    config.max_knot_ratio = 2.0;
+    config.seed = 3;
+    return tmesh_synthetic(config);
+}
+
+vector<tsl::index> get_face_indices(const tmesh& mesh) {
+    vector<tsl::index> out;
+    for (auto fh: mesh.get_faces()) {
+        out.push_back(fh.get_idx());
+    }
+    return out;
+}
+
+void expect_same_mesh(const tmesh& expected, const tmesh& actual) {
+    ASSERT_EQ(expected.num_faces(), actual.num_faces());
+    ASSERT_EQ(expected.num_half_edges(), actual.num_half_edges());
+    for (auto fh: expected.get_faces()) {
+        EXPECT_EQ(expected.get_half_edges_of_face(fh), actual.get_half_edges_of_face(fh));
+    }
+    for (auto eh: expected.get_half_edges()) {
+        EXPECT_EQ(expected.get_knot_interval(eh), actual.get_knot_interval(eh));
+    }
+}
+
+}
+
+TEST(ReductionTest, BatchRemovesPercentageOfRegularMesh) {
+    synthetic_tmesh_config config;
+    config.width = 40;
+    config.height = 40;
+    auto mesh = tmesh_synthetic(config);
+    auto num_edges = mesh.num_edges();
+
+    batch_reduction_config batch_config;
+    batch_config.percent = 10;
+    auto deleted = remove_edges_batch(mesh, batch_config);
+
+    EXPECT_EQ(deleted, num_edges / 10);
+    EXPECT_EQ(mesh.num_edges(), num_edges - deleted);
+    EXPECT_EQ(mesh.num_faces(), 1600 - deleted);
+}
+
+TEST(ReductionTest, BatchIsIndependentOfThreads) {
+    batch_reduction_config config;
+    config.percent = 50;
+    config.seed = 11;
+
+    auto sequential = get_mesh();
+    config.num_threads = 1;
+    auto deleted = remove_edges_batch(sequential, config);
+    EXPECT_GT(deleted, 0);
+
+    auto parallel = get_mesh();
+    config.num_threads = 4;
+    EXPECT_EQ(remove_edges_batch(parallel, config), deleted);
+    expect_same_mesh(sequential, parallel);
+
+    auto other_seed = get_mesh();
+    config.seed = 12;
+    remove_edges_batch(other_seed, config);
+    EXPECT_NE(get_face_indices(sequential), get_face_indices(other_seed));
+}
+
+TEST(ReductionTest, BatchKeepsSurfaceEvaluable) {
+    surface_evaluator evaluator(get_mesh());
+    batch_reduction_config config;
+    config.percent = 30;
+    config.num_threads = 4;
+    auto deleted = evaluator.remove_edges_batch(config);
+    EXPECT_GT(deleted, 0);
+
+    auto grids = evaluator.eval_per_face(2);
+    EXPECT_EQ(grids.size(), evaluator.get_tmesh().num_faces());
+}
+
+}
@@ -0,0 +1,75 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cert-err58-cpp"
+
+#include <gtest/gtest.h>
+
+#include <tsl/attrmaps/csr_map.hpp>
+#include <tsl/util/base_handle.hpp>
+
+#include <tsl_tests/mocks.hpp>
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+TEST(CsrMapTest, BuildCreatesLayout) {
+    csr_map<test_handle, dummy> map;
+    map.build({2, 0, 3}, {7});
+
+    EXPECT_EQ(3, map.num_keys());
+    EXPECT_EQ(5, map.num_values());
+    EXPECT_EQ(2, map[test_handle(0)].size());
+    EXPECT_TRUE(map[test_handle(1)].empty());
+    EXPECT_EQ(3, map[test_handle(2)].size());
+    EXPECT_EQ(0, map.get_offset(test_handle(0)));
+    EXPECT_EQ(2, map.get_offset(test_handle(1)));
+    EXPECT_EQ(2, map.get_offset(test_handle(2)));
+    for (const auto& value: map.get_values()) {
+        EXPECT_EQ(7, value.val);
+    }
+}
+
+TEST(CsrMapTest, ValuesOfKeysAreSeparated) {
+    csr_map<test_handle, dummy> map;
+    map.build({2, 3}, {0});
+
+    map[test_handle(0)][1].val = 1;
+    map[test_handle(1)][0].val = 2;
+
+    const auto& cmap = map;
+    EXPECT_EQ(0, cmap[test_handle(0)][0].val);
+    EXPECT_EQ(1, cmap[test_handle(0)][1].val);
+    EXPECT_EQ(2, cmap[test_handle(1)][0].val);
+    EXPECT_EQ(0, cmap[test_handle(1)][2].val);
+}
+
+TEST(CsrMapTest, BuildWithLayoutOfOtherMap) {
+    csr_map<test_handle, dummy> map;
+    map.build({1, 4, 2}, {0});
+
+    csr_map<test_handle, double> other;
+    other.build(map, 1.5);
+
+    EXPECT_EQ(map.num_keys(), other.num_keys());
+    EXPECT_EQ(map.num_values(), other.num_values());
+    EXPECT_EQ(4, other[test_handle(1)].size());
+    EXPECT_EQ(1.5, other[test_handle(2)][1]);
+}
+
+TEST(CsrMapTest, ContainsKey) {
+    csr_map<test_handle, dummy> map;
+    EXPECT_FALSE(map.contains_key(test_handle(0)));
+
+    map.build({0, 1}, {0});
+    EXPECT_TRUE(map.contains_key(test_handle(0)));
+    EXPECT_TRUE(map.contains_key(test_handle(1)));
+    EXPECT_FALSE(map.contains_key(test_handle(2)));
+
+    map.clear();
+    EXPECT_FALSE(map.contains_key(test_handle(0)));
+    EXPECT_EQ(0, map.num_values());
+}
+
+}
+
+#pragma clang diagnostic pop
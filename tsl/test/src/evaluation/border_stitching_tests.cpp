@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/border_stitching.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::vector;
+
+using glm::dot;
+using glm::length;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Returns the border vertices of the given grid in counter clockwise order.
+vector<vec3> get_border(const regular_grid& grid) {
+    auto res = grid.num_points_x - 1;
+    vector<vec3> out;
+    for (size_t x = 0; x < res; ++x) {
+        out.push_back(grid.points[0][x]);
+    }
+    for (size_t y = 0; y < res; ++y) {
+        out.push_back(grid.points[y][res]);
+    }
+    for (size_t x = res; x > 0; --x) {
+        out.push_back(grid.points[res][x]);
+    }
+    for (size_t y = res; y > 0; --y) {
+        out.push_back(grid.points[y][0]);
+    }
+    return out;
+}
+
+double get_distance(const vec3& p, const vec3& a, const vec3& b) {
+    auto ab = b - a;
+    auto len = dot(ab, ab);
+    auto t = len == 0 ? 0.0 : min(max(dot(p - a, ab) / len, 0.0), 1.0);
+    return length(p - (a + ab * t));
+}
+
+/// Checks, that every border vertex of each grid lies on the border of another grid.
+void expect_closed(const vector<regular_grid>& grids) {
+    vector<vector<vec3>> borders;
+    for (const auto& grid: grids) {
+        borders.push_back(get_border(grid));
+    }
+
+    for (size_t i = 0; i < borders.size(); ++i) {
+        for (const auto& p: borders[i]) {
+            auto closest = numeric_limits<double>::max();
+            for (size_t j = 0; j < borders.size(); ++j) {
+                if (j == i) {
+                    continue;
+                }
+                const auto& border = borders[j];
+                for (size_t k = 0; k < border.size(); ++k) {
+                    closest = min(closest, get_distance(p, border[k], border[(k + 1) % border.size()]));
+                }
+            }
+            EXPECT_LT(closest, 1e-9) << "face " << i;
+        }
+    }
+}
+
+/// Evaluates all faces of the given evaluator, each with the resolution returned by `get_res` for its index.
+template<typename get_res_t>
+vector<regular_grid> eval_with_res(const surface_evaluator& evaluator, get_res_t get_res, vector<face_handle>& faces, vector<uint32_t>& res) {
+    vector<regular_grid> out;
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        auto r = get_res(fh, faces.size());
+        auto grids = evaluator.eval_faces(r, {fh});
+        if (grids.empty()) {
+            continue;
+        }
+        faces.push_back(fh);
+        res.push_back(r);
+        out.push_back(grids[0]);
+    }
+    return out;
+}
+
+}
+
+TEST(BorderStitchingTest, MinStitchResOfRegularFacesIsOne) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        EXPECT_EQ(1u, get_min_stitch_res(evaluator, fh, 16));
+    }
+}
+
+TEST(BorderStitchingTest, MinStitchResMatchesTJunctions) {
+    surface_evaluator evaluator(tmesh_cube(5));
+    evaluator.remove_edges(0.2);
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        auto res = get_min_stitch_res(evaluator, fh, 16);
+        EXPECT_GE(res, 1u);
+        EXPECT_LE(res, 16u);
+        EXPECT_EQ(0u, res & (res - 1));
+    }
+}
+
+TEST(BorderStitchingTest, KeepsMatchingBorders) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    vector<face_handle> faces;
+    vector<uint32_t> res;
+    auto grids = eval_with_res(evaluator, [](face_handle, size_t) { return 4u; }, faces, res);
+    auto stitched = grids;
+    stitch_grids(get_border_stitches(evaluator, faces, res), stitched);
+
+    // Faces evaluated by subdevision and their regular neighbours only differ slightly on their common border
+    for (size_t i = 0; i < grids.size(); ++i) {
+        for (size_t y = 0; y < grids[i].num_points_y; ++y) {
+            for (size_t x = 0; x < grids[i].num_points_x; ++x) {
+                EXPECT_LT(length(grids[i].points[y][x] - stitched[i].points[y][x]), 1e-6);
+            }
+        }
+    }
+    expect_closed(stitched);
+}
+
+TEST(BorderStitchingTest, ClosesBordersOfDifferentResolutions) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    vector<face_handle> faces;
+    vector<uint32_t> res;
+    auto grids = eval_with_res(evaluator, [](face_handle, size_t i) { return 1u << (i % 4); }, faces, res);
+    stitch_grids(get_border_stitches(evaluator, faces, res), grids);
+    expect_closed(grids);
+}
+
+TEST(BorderStitchingTest, ClosesBordersAtTJunctions) {
+    surface_evaluator evaluator(tmesh_cube(5));
+    evaluator.remove_edges(0.2);
+    vector<face_handle> faces;
+    vector<uint32_t> res;
+    auto get_res = [&](face_handle handle, size_t i) {
+        return max(get_min_stitch_res(evaluator, handle, 16), i % 2 == 0 ? 8u : 16u);
+    };
+    auto grids = eval_with_res(evaluator, get_res, faces, res);
+    stitch_grids(get_border_stitches(evaluator, faces, res), grids);
+    expect_closed(grids);
+}
+
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tsl/evaluation/eval_cache.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using std::vector;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+void expect_same_grids(const vector<regular_grid>& expected, const vector<regular_grid>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].handle, actual[i].handle);
+        EXPECT_EQ(expected[i].points, actual[i].points);
+        EXPECT_EQ(expected[i].normals, actual[i].normals);
+    }
+}
+
+}
+
+TEST(EvalCacheTest, RepeatedEvaluationIsServedFromCache) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto num_faces = evaluator.get_tmesh().num_faces();
+    eval_cache cache;
+
+    auto first = cache.eval_per_face(evaluator, 4);
+    EXPECT_EQ(0, cache.num_hits());
+    EXPECT_EQ(num_faces, cache.num_misses());
+
+    auto second = cache.eval_per_face(evaluator, 4);
+    EXPECT_EQ(num_faces, cache.num_hits());
+    EXPECT_EQ(num_faces, cache.num_misses());
+
+    // Another resolution is not mixed up with the cached one
+    cache.eval_per_face(evaluator, 2);
+    EXPECT_EQ(2 * num_faces, cache.num_misses());
+
+    auto expected = evaluator.eval_per_face(4);
+    expect_same_grids(expected, first);
+    expect_same_grids(expected, second);
+}
+
+TEST(EvalCacheTest, MovingVertexOnlyReevaluatesDependentFaces) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    eval_cache cache;
+    cache.eval_per_face(evaluator, 3);
+    auto misses = cache.num_misses();
+
+    auto vh = *evaluator.get_tmesh().get_vertices().begin();
+    auto affected = evaluator.get_affected_faces({vh});
+    ASSERT_FALSE(affected.empty());
+    ASSERT_LT(affected.size(), evaluator.get_tmesh().num_faces());
+    evaluator.set_vertex_pos(vh, evaluator.get_vertex_pos(vh) + vec3(0.1, 0.2, 0.3));
+
+    auto grids = cache.eval_per_face(evaluator, 3);
+    EXPECT_EQ(misses + affected.size(), cache.num_misses());
+    expect_same_grids(evaluator.eval_per_face(3), grids);
+}
+
+TEST(EvalCacheTest, RemovingEdgeKeepsVersionsOfDistantFaces) {
+    // Edges can only be removed far enough from the extraordinary vertices at the corners of the cube
+    surface_evaluator evaluator(tmesh_cube(8));
+    eval_cache cache;
+    cache.eval_per_face(evaluator, 3);
+
+    vector<face_handle> faces;
+    vector<uint64_t> versions;
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        faces.push_back(fh);
+        versions.push_back(evaluator.get_face_version(fh));
+    }
+
+    auto removed = false;
+    for (const auto& eh: evaluator.get_tmesh().get_edges()) {
+        if (evaluator.remove_edge(eh)) {
+            removed = true;
+            break;
+        }
+    }
+    ASSERT_TRUE(removed);
+
+    size_t num_kept = 0;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        if (evaluator.get_face_version(faces[i]) == versions[i]) {
+            num_kept += 1;
+        }
+    }
+    EXPECT_GT(num_kept, 0);
+    EXPECT_LT(num_kept, faces.size());
+
+    auto misses = cache.num_misses();
+    auto grids = cache.eval_per_face(evaluator, 3);
+    EXPECT_EQ(misses + evaluator.get_tmesh().num_faces() - num_kept, cache.num_misses());
+    expect_same_grids(evaluator.eval_per_face(3), grids);
+}
+
+TEST(EvalCacheTest, EvaluatesSnapshotDuringEditTransaction) {
+    surface_evaluator evaluator(tmesh_cube(8));
+    auto expected = evaluator.eval_per_face(3);
+
+    // The removed face and its half edges are only erased from the tmesh, the snapshot keeps them until the commit
+    evaluator.begin_edits();
+    auto removed = false;
+    for (const auto& eh: evaluator.get_tmesh().get_edges()) {
+        if (evaluator.remove_edge(eh, false)) {
+            removed = true;
+            break;
+        }
+    }
+    ASSERT_TRUE(removed);
+    ASSERT_LT(evaluator.get_tmesh().num_faces(), evaluator.get_frozen_tmesh().num_faces());
+
+    eval_cache cache;
+    expect_same_grids(expected, cache.eval_per_face(evaluator, 3));
+    evaluator.commit_edits();
+}
+
+TEST(EvalCacheTest, EvictsLeastRecentlyUsedGrids) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    vector<face_handle> faces;
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        faces.push_back(fh);
+    }
+
+    eval_cache measure;
+    measure.eval_faces(evaluator, 4, {faces[0]});
+    auto grid_bytes = measure.get_size_bytes();
+
+    eval_cache cache(2 * grid_bytes);
+    cache.eval_faces(evaluator, 4, {faces[0], faces[1], faces[0], faces[2]});
+    EXPECT_EQ(1, cache.num_hits());
+    EXPECT_EQ(2 * grid_bytes, cache.get_size_bytes());
+
+    // `faces[1]` was used least recently, when `faces[2]` was added
+    cache.eval_faces(evaluator, 4, {faces[0]});
+    EXPECT_EQ(2, cache.num_hits());
+    cache.eval_faces(evaluator, 4, {faces[1]});
+    EXPECT_EQ(2, cache.num_hits());
+
+    // Grids, which don't fit into the cache, are still returned
+    eval_cache tiny(1);
+    auto grids = tiny.eval_faces(evaluator, 4, {faces[0]});
+    EXPECT_EQ(0, tiny.get_size_bytes());
+    expect_same_grids(evaluator.eval_faces(4, {faces[0]}), grids);
+}
+
+}
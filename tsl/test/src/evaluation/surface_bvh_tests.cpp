@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_bvh.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+using std::move;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Returns the parameter of the closest intersection of the ray with all triangles of the given grids.
+optional<double> intersect_brute_force(const line& ray, const vector<regular_grid>& grids) {
+    optional<double> closest;
+    auto test = [&](const vec3& v0, const vec3& v1, const vec3& v2) {
+        auto e1 = v1 - v0;
+        auto e2 = v2 - v0;
+        auto p = cross(ray.normal, e2);
+        auto det = dot(e1, p);
+        if (det == 0) {
+            return;
+        }
+        auto s = ray.support_vector - v0;
+        auto b1 = dot(s, p) / det;
+        auto q = cross(s, e1);
+        auto b2 = dot(ray.normal, q) / det;
+        auto t = dot(e2, q) / det;
+        if (b1 >= 0 && b2 >= 0 && b1 + b2 <= 1 && t >= 0 && (!closest || t < *closest)) {
+            closest = t;
+        }
+    };
+
+    for (const auto& grid: grids) {
+        for (size_t i = 0; i + 1 < grid.num_points_y; ++i) {
+            for (size_t j = 0; j + 1 < grid.num_points_x; ++j) {
+                test(grid.points[i][j], grid.points[i + 1][j], grid.points[i][j + 1]);
+                test(grid.points[i][j + 1], grid.points[i + 1][j], grid.points[i + 1][j + 1]);
+            }
+        }
+    }
+    return closest;
+}
+
+/// Rays from all around the bounds towards its center.
+vector<line> get_rays(const aa_box& bounds) {
+    vector<line> out;
+    auto center = bounds.get_center();
+    auto radius = length(bounds.max_corner - bounds.min_corner);
+    for (int x = -2; x <= 2; ++x) {
+        for (int y = -2; y <= 2; ++y) {
+            for (int z = -2; z <= 2; ++z) {
+                if (x == 0 && y == 0 && z == 0) {
+                    continue;
+                }
+                auto dir = normalize(vec3(x, y, z + 0.1));
+                out.emplace_back(center + radius * dir, -dir);
+            }
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(SurfaceBvhTest, IntersectMatchesBruteForce) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto grids = evaluator.eval_per_face(3);
+    surface_bvh bvh(evaluator, grids);
+    ASSERT_EQ(grids.size(), bvh.num_faces());
+
+    for (const auto& ray: get_rays(bvh.get_bounds())) {
+        auto expected = intersect_brute_force(ray, grids);
+        auto hit = bvh.intersect(ray);
+        ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(hit));
+        if (hit) {
+            EXPECT_NEAR(*expected, hit->t, 1e-9);
+            EXPECT_GE(hit->uv.x, 0);
+            EXPECT_LE(hit->uv.x, 1);
+            EXPECT_GE(hit->uv.y, 0);
+            EXPECT_LE(hit->uv.y, 1);
+        }
+    }
+}
+
+TEST(SurfaceBvhTest, SegmentEndsBeforeSurface) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto grids = evaluator.eval_per_face(3);
+    surface_bvh bvh(evaluator, grids);
+
+    auto ray = get_rays(bvh.get_bounds()).front();
+    auto hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit);
+
+    auto end = ray.support_vector + ray.normal * (hit->t * 0.99);
+    EXPECT_FALSE(bvh.intersect(ray.support_vector, end));
+    auto through = bvh.intersect(ray.support_vector, ray.support_vector + ray.normal * (hit->t * 2));
+    ASSERT_TRUE(through);
+    EXPECT_EQ(hit->face, through->face);
+    EXPECT_NEAR(0.5, through->t, 1e-9);
+}
+
+TEST(SurfaceBvhTest, RefitMatchesRebuild) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_bvh bvh(evaluator, evaluator.eval_per_face(3));
+
+    set<vertex_handle> moved = {vertex_handle(0), vertex_handle(7)};
+    for (const auto& vh: moved) {
+        evaluator.set_vertex_pos(vh, evaluator.get_vertex_pos(vh) * 1.5);
+    }
+    bvh.refit(evaluator, evaluator.eval_faces(3, evaluator.get_affected_faces(moved)));
+
+    auto grids = evaluator.eval_per_face(3);
+    surface_bvh rebuilt(evaluator, grids);
+    EXPECT_EQ(rebuilt.get_bounds().min_corner, bvh.get_bounds().min_corner);
+    EXPECT_EQ(rebuilt.get_bounds().max_corner, bvh.get_bounds().max_corner);
+
+    for (const auto& ray: get_rays(rebuilt.get_bounds())) {
+        auto expected = intersect_brute_force(ray, grids);
+        auto hit = bvh.intersect(ray);
+        ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(hit));
+        if (hit) {
+            EXPECT_NEAR(*expected, hit->t, 1e-9);
+        }
+    }
+}
+
+TEST(SurfaceBvhTest, PackedGridsMatchGrids) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto pack = [](const vector<regular_grid>& grids, vector<face_handle>& handles, vector<size_t>& sizes) {
+        vector<vec3> points;
+        for (const auto& grid: grids) {
+            handles.push_back(grid.handle);
+            sizes.push_back(grid.num_points_x);
+            for (const auto& row: grid.points) {
+                points.insert(points.end(), row.begin(), row.end());
+            }
+        }
+        return points;
+    };
+
+    vector<face_handle> handles;
+    vector<size_t> sizes;
+    auto points = pack(evaluator.eval_per_face(3), handles, sizes);
+    surface_bvh bvh(evaluator, handles, sizes, move(points));
+    EXPECT_EQ(handles.size(), bvh.num_faces());
+
+    set<vertex_handle> moved = {vertex_handle(0), vertex_handle(7)};
+    for (const auto& vh: moved) {
+        evaluator.set_vertex_pos(vh, evaluator.get_vertex_pos(vh) * 1.5);
+    }
+    vector<face_handle> moved_handles;
+    vector<size_t> moved_sizes;
+    auto moved_points = pack(evaluator.eval_faces(3, evaluator.get_affected_faces(moved)), moved_handles, moved_sizes);
+    bvh.refit(evaluator, moved_handles, moved_points);
+
+    auto grids = evaluator.eval_per_face(3);
+    surface_bvh rebuilt(evaluator, grids);
+    EXPECT_EQ(rebuilt.get_bounds().min_corner, bvh.get_bounds().min_corner);
+    EXPECT_EQ(rebuilt.get_bounds().max_corner, bvh.get_bounds().max_corner);
+
+    for (const auto& ray: get_rays(rebuilt.get_bounds())) {
+        auto expected = rebuilt.intersect(ray);
+        auto hit = bvh.intersect(ray);
+        ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(hit));
+        if (hit) {
+            EXPECT_NEAR(expected->t, hit->t, 1e-9);
+        }
+    }
+}
+
+TEST(SurfaceBvhTest, ClosestPointIsOnTriangles) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto grids = evaluator.eval_per_face(3);
+    surface_bvh bvh(evaluator, grids);
+    auto bounds = bvh.get_bounds();
+    auto radius = length(bounds.max_corner - bounds.min_corner);
+
+    // Points outside and inside of the surface
+    for (const auto& ray: get_rays(bounds)) {
+        for (auto t: {0.0, 0.5, 0.8, 0.9, 1.0}) {
+            auto point = ray.support_vector + t * radius * ray.normal;
+            auto hit = bvh.closest_point(point);
+            ASSERT_TRUE(hit);
+            EXPECT_NEAR(length(hit->point - point), hit->t, 1e-12);
+
+            // The closest point on the triangles is at least as close as all grid points
+            for (const auto& grid: grids) {
+                for (const auto& row: grid.points) {
+                    for (const auto& p: row) {
+                        EXPECT_LE(hit->t, length(p - point) + 1e-12);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
@@ -1,13 +1,305 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <optional>
+
 #include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/util/panic.hpp"
 #include "tsl_tests/evaluation/surface_evaluator_fixtures.hpp"
 
+using std::optional;
+using std::string;
+using std::vector;
+
 using namespace tsl;
 
 namespace tsl_tests {
 
+namespace {
+
+/// Records the begin and end of all stages.
+class recording_observer : public stage_observer {
+public:
+    void begin_stage(const char* name) override { events.push_back(string("begin ") + name); }
+    void end_stage(const char* name) override { events.push_back(string("end ") + name); }
+
+    vector<string> events;
+};
+
+/// Sink which writes all points into one flat vector, like a vertex buffer.
+class flat_sink : public eval_sink {
+public:
+    vector<face_handle> faces;
+    vector<vec3> points;
+    vector<vec3> normals;
+
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override {
+        faces.push_back(handle);
+        offset = points.size();
+        width = num_points_x;
+        points.resize(points.size() + num_points_x * num_points_y);
+        normals.resize(points.size());
+    }
+
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override {
+        points[offset + y * width + x] = pos;
+        normals[offset + y * width + x] = normal;
+    }
+
+private:
+    size_t offset = 0;
+    size_t width = 0;
+};
+
+}
+
+TEST(SurfaceEvaluatorTest, ReportsCacheStagesToObserver) {
+    recording_observer observer;
+    evaluator_config config;
+    config.observer = &observer;
+    surface_evaluator evaluator(tmesh_cube(3), config);
+
+    vector<string> stages = {
+        "freeze", "local_coords", "edge_trans", "basis_funs", "knots", "support", "dependent_faces", "face_versions"
+    };
+    vector<string> expected;
+    for (const auto& stage: stages) {
+        expected.push_back("begin " + stage);
+        expected.push_back("end " + stage);
+    }
+    EXPECT_EQ(expected, observer.events);
+}
+
+TEST(SurfaceEvaluatorTest, CacheIsIndependentOfThreadCount) {
+    evaluator_config sequential_config;
+    sequential_config.num_threads = 1;
+    evaluator_config parallel_config;
+    parallel_config.num_threads = 4;
+
+    surface_evaluator sequential(tmesh_cube(10), sequential_config);
+    surface_evaluator parallel(tmesh_cube(10), parallel_config);
+    sequential.remove_edges(0.1);
+    parallel.remove_edges(0.1);
+
+    const auto& mesh = sequential.get_tmesh();
+    for (const auto& eh: mesh.get_half_edges()) {
+        EXPECT_EQ(sequential.get_coord_map()[eh], parallel.get_coord_map()[eh]);
+        EXPECT_EQ(sequential.get_dir_map()[eh], parallel.get_dir_map()[eh]);
+        EXPECT_EQ(sequential.get_edge_trans_map()[eh].t, parallel.get_edge_trans_map()[eh].t);
+    }
+
+    for (const auto& fh: mesh.get_faces()) {
+        const auto& expected = sequential.get_support_map()[fh];
+        const auto& actual = parallel.get_support_map()[fh];
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i].vertex, actual[i].vertex);
+            EXPECT_EQ(expected[i].handle_index, actual[i].handle_index);
+            EXPECT_EQ(expected[i].basis_fun, actual[i].basis_fun);
+            EXPECT_EQ(expected[i].trans.r, actual[i].trans.r);
+            EXPECT_EQ(expected[i].trans.f, actual[i].trans.f);
+            EXPECT_EQ(expected[i].trans.t, actual[i].trans.t);
+        }
+    }
+}
+
+TEST(SurfaceEvaluatorTest, EvalPerFaceCanBeCancelled) {
+    surface_evaluator evaluator(tmesh_cube(5));
+
+    atomic<bool> cancelled(false);
+    auto grids = evaluator.eval_per_face(2, cancelled);
+    EXPECT_EQ(evaluator.get_tmesh().num_faces(), grids.size());
+
+    cancelled = true;
+    EXPECT_TRUE(evaluator.eval_per_face(2, cancelled).empty());
+}
+
+TEST(SurfaceEvaluatorTest, OnlyAffectedFacesChangeWhenMovingVertices) {
+    surface_evaluator evaluator(tmesh_cube(6));
+    auto before = evaluator.eval_per_face(2);
+
+    // The first vertex is a corner of the cube and thus extraordinary
+    set<vertex_handle> moved = {vertex_handle(0), vertex_handle(20)};
+    for (const auto& vh: moved) {
+        evaluator.set_vertex_pos(vh, evaluator.get_vertex_pos(vh) + vec3(0.3, -0.2, 0.1));
+    }
+    auto after = evaluator.eval_per_face(2);
+    auto affected = evaluator.get_affected_faces(moved);
+    ASSERT_FALSE(affected.empty());
+    ASSERT_TRUE(std::is_sorted(affected.begin(), affected.end()));
+
+    auto partial = evaluator.eval_faces(2, affected);
+    ASSERT_EQ(affected.size(), partial.size());
+    size_t next_partial = 0;
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < after.size(); ++i) {
+        if (next_partial < partial.size() && partial[next_partial].handle == after[i].handle) {
+            EXPECT_EQ(after[i].points, partial[next_partial].points);
+            EXPECT_EQ(after[i].normals, partial[next_partial].normals);
+            next_partial += 1;
+        } else {
+            EXPECT_EQ(before[i].points, after[i].points);
+        }
+    }
+    EXPECT_EQ(partial.size(), next_partial);
+}
+
+TEST(SurfaceEvaluatorTest, EditTransactionUpdatesCacheOnce) {
+    recording_observer observer;
+    evaluator_config config;
+    config.observer = &observer;
+    surface_evaluator evaluator(tmesh_cube(8), config);
+    surface_evaluator expected(tmesh_cube(8));
 
+    observer.events.clear();
+    evaluator.begin_edits();
+    evaluator.begin_edits();
+    EXPECT_TRUE(evaluator.is_editing());
+
+    vector<edge_handle> edges;
+    for (const auto& eh: evaluator.get_tmesh().get_edges()) {
+        edges.push_back(eh);
+    }
+    size_t removed = 0;
+    for (size_t i = 0; i < edges.size(); i += 5) {
+        auto res = evaluator.remove_edge(edges[i]);
+        EXPECT_EQ(expected.remove_edge(edges[i]), res);
+        removed += res ? 1 : 0;
+    }
+    ASSERT_GT(removed, 1);
+
+    auto vh = *evaluator.get_tmesh().get_vertices().begin();
+    auto pos = evaluator.get_vertex_pos(vh) + vec3(0.1, 0.2, 0.3);
+    evaluator.set_vertex_pos(vh, pos);
+    expected.set_vertex_pos(vh, pos);
+
+    // Only the outermost transaction updates the caches
+    evaluator.commit_edits();
+    EXPECT_TRUE(observer.events.empty());
+    evaluator.commit_edits();
+    EXPECT_FALSE(evaluator.is_editing());
+    EXPECT_EQ(1, std::count(observer.events.begin(), observer.events.end(), "begin freeze"));
+
+    auto actual_grids = evaluator.eval_per_face(2);
+    auto expected_grids = expected.eval_per_face(2);
+    ASSERT_EQ(expected_grids.size(), actual_grids.size());
+    for (size_t i = 0; i < expected_grids.size(); ++i) {
+        EXPECT_EQ(expected_grids[i].points, actual_grids[i].points);
+    }
+
+    EXPECT_THROW(evaluator.commit_edits(), panic_exception);
+}
+
+TEST(SurfaceEvaluatorTest, EditTransactionWithoutStructureChangeKeepsCache) {
+    recording_observer observer;
+    evaluator_config config;
+    config.observer = &observer;
+    surface_evaluator evaluator(tmesh_cube(3), config);
+
+    observer.events.clear();
+    evaluator.begin_edits();
+    auto vh = *evaluator.get_tmesh().get_vertices().begin();
+    evaluator.set_vertex_pos(vh, evaluator.get_vertex_pos(vh) + vec3(0, 0, 1));
+    evaluator.commit_edits();
+    EXPECT_TRUE(observer.events.empty());
+}
+
+TEST(SurfaceEvaluatorTest, EditTransactionMovesVertexRemovedFromTmesh) {
+    surface_evaluator evaluator(tmesh_cube(8));
+    auto num_grids = evaluator.eval_per_face(2).size();
+
+    // Removing two opposite edges of a vertex turns it into a T-vertex first and removes it afterwards
+    evaluator.begin_edits();
+    optional<vertex_handle> removed;
+    for (const auto& vh: evaluator.get_tmesh().get_vertices()) {
+        auto edges = evaluator.get_tmesh().get_edges_of_vertex(vh);
+        if (edges.size() == 4 && evaluator.remove_edge(edges[0], false) && evaluator.remove_edge(edges[2], false)) {
+            removed = vh;
+            break;
+        }
+    }
+    ASSERT_TRUE(removed);
+    ASSERT_FALSE(evaluator.get_tmesh().contains(*removed));
+
+    auto pos = evaluator.get_vertex_pos(*removed) + vec3(0.1, 0.2, 0.3);
+    evaluator.set_vertex_pos(*removed, pos);
+    EXPECT_EQ(pos, evaluator.get_vertex_pos(*removed));
+    EXPECT_EQ(num_grids, evaluator.eval_per_face(2).size());
+
+    evaluator.commit_edits();
+    EXPECT_LT(evaluator.eval_per_face(2).size(), num_grids);
+}
+
+TEST(SurfaceEvaluatorTest, SinkReceivesSamePointsAsGrids) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto grids = evaluator.eval_per_face(3);
+
+    flat_sink sink;
+    atomic<bool> cancelled(false);
+    evaluator.eval_per_face(3, sink, cancelled);
+
+    ASSERT_EQ(grids.size(), sink.faces.size());
+    size_t next = 0;
+    for (size_t i = 0; i < grids.size(); ++i) {
+        EXPECT_EQ(grids[i].handle, sink.faces[i]);
+        for (size_t y = 0; y < grids[i].num_points_y; ++y) {
+            for (size_t x = 0; x < grids[i].num_points_x; ++x) {
+                EXPECT_EQ(grids[i].points[y][x], sink.points[next]);
+                EXPECT_EQ(grids[i].normals[y][x], sink.normals[next]);
+                next += 1;
+            }
+        }
+    }
+    EXPECT_EQ(sink.points.size(), next);
+}
+
+TEST(SurfaceEvaluatorTest, EvalFaceUsesResolutionOfEachFace) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    vector<face_handle> faces;
+    for (const auto& fh: evaluator.get_tmesh().get_faces()) {
+        faces.push_back(fh);
+    }
+
+    // Evaluate every face with another resolution
+    flat_sink sink;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        evaluator.eval_face(static_cast<uint32_t>(i % 3 + 1), faces[i], sink);
+    }
+
+    ASSERT_EQ(faces.size(), sink.faces.size());
+    size_t next = 0;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        auto grid = evaluator.eval_faces(static_cast<uint32_t>(i % 3 + 1), {faces[i]});
+        ASSERT_EQ(1u, grid.size());
+        EXPECT_EQ(grid[0].handle, sink.faces[i]);
+        for (const auto& row: grid[0].points) {
+            for (const auto& p: row) {
+                EXPECT_EQ(p, sink.points[next]);
+                next += 1;
+            }
+        }
+    }
+    EXPECT_EQ(sink.points.size(), next);
+}
+
+TEST(SurfaceEvaluatorTest, MemoryReportCoversMeshAndCaches) {
+    surface_evaluator evaluator(tmesh_cube(3));
+    auto report = evaluator.memory_report();
+
+    vector<string> names;
+    for (const auto& [name, usage]: report.get_entries()) {
+        names.push_back(name);
+        EXPECT_LE(usage.used_bytes + usage.deleted_bytes, usage.reserved_bytes) << name;
+    }
+    for (const auto& name: {"mesh/half_edges", "frozen/vertices", "uv", "support", "knot_vectors", "face_versions"}) {
+        EXPECT_NE(names.end(), std::find(names.begin(), names.end(), name)) << name;
+        EXPECT_GT(report.get(name).used_bytes, 0) << name;
+    }
+
+    auto total = report.get_total();
+    EXPECT_GE(total.reserved_bytes, total.used_bytes);
+}
 
 }
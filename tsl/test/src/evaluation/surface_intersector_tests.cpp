@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_intersector.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using glm::cross;
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Rays from all around the given point towards it.
+vector<line> get_rays(const vec3& center, double radius) {
+    vector<line> out;
+    for (int x = -2; x <= 2; ++x) {
+        for (int y = -2; y <= 2; ++y) {
+            for (int z = -2; z <= 2; ++z) {
+                if (x == 0 && y == 0 && z == 0) {
+                    continue;
+                }
+                auto dir = normalize(vec3(x + 0.3, y, z + 0.1));
+                out.emplace_back(center + radius * dir, -dir);
+            }
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(SurfaceIntersectorTest, HitsLieOnSurfaceAndRay) {
+    // The corners of the cube are extraordinary, so both evaluation paths are used
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_intersector intersector(evaluator, 4);
+
+    auto grids = evaluator.eval_per_face(1);
+    aa_box bounds;
+    for (const auto& grid: grids) {
+        for (const auto& row: grid.points) {
+            for (const auto& p: row) {
+                bounds.extend(p);
+            }
+        }
+    }
+    auto radius = length(bounds.max_corner - bounds.min_corner);
+
+    // Rays through the small gaps between the tessellations of neighbouring faces miss the surface
+    auto rays = get_rays(bounds.get_center(), radius);
+    size_t num_converged = 0;
+    for (const auto& ray: rays) {
+        auto hit = intersector.intersect(ray);
+        if (!hit || !hit->converged) {
+            continue;
+        }
+
+        num_converged += 1;
+        auto [point, du, dv] = evaluator.eval_point(hit->face, hit->uv);
+        EXPECT_LT(length(point - hit->point), 1e-9);
+        EXPECT_LT(length(ray.support_vector + hit->t * ray.normal - hit->point), 1e-9);
+        EXPECT_NEAR(1, length(hit->normal), 1e-9);
+        EXPECT_NEAR(0, dot(hit->normal, du), 1e-6 * length(du));
+    }
+    EXPECT_GT(num_converged, rays.size() * 9 / 10);
+}
+
+TEST(SurfaceIntersectorTest, BatchMatchesSingleRays) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_intersector intersector(evaluator, 4);
+
+    auto rays = get_rays(vec3(0, 0, 0), 100);
+    auto hits = intersector.intersect(rays, 4);
+    ASSERT_EQ(rays.size(), hits.size());
+    for (size_t i = 0; i < rays.size(); ++i) {
+        auto expected = intersector.intersect(rays[i]);
+        ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(hits[i]));
+        if (expected) {
+            EXPECT_EQ(expected->face, hits[i]->face);
+            EXPECT_EQ(expected->point, hits[i]->point);
+        }
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/surface_projector.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Points around and inside of the given surface.
+vector<vec3> get_points(const surface_evaluator& evaluator) {
+    aa_box bounds;
+    for (const auto& grid: evaluator.eval_per_face(1)) {
+        for (const auto& row: grid.points) {
+            for (const auto& p: row) {
+                bounds.extend(p);
+            }
+        }
+    }
+
+    auto center = bounds.get_center();
+    auto radius = length(bounds.max_corner - bounds.min_corner);
+    vector<vec3> out;
+    for (int x = -2; x <= 2; ++x) {
+        for (int y = -2; y <= 2; ++y) {
+            for (int z = -2; z <= 2; ++z) {
+                auto dir = normalize(vec3(x + 0.3, y, z + 0.1));
+                for (auto scale: {0.1, 0.3, 0.6, 1.0}) {
+                    out.push_back(center + scale * radius * dir);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(SurfaceProjectorTest, ClosestPointsLieOnSurface) {
+    // The corners of the cube are extraordinary, so both evaluation paths are used
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_projector projector(evaluator, 4);
+    auto samples = evaluator.eval_per_face(16);
+
+    size_t num_converged = 0;
+    auto points = get_points(evaluator);
+    for (const auto& point: points) {
+        auto proj = projector.project(point);
+        ASSERT_TRUE(proj);
+
+        auto [p, du, dv] = evaluator.eval_point(proj->face, proj->uv);
+        EXPECT_LT(length(p - proj->point), 1e-9);
+        EXPECT_NEAR(length(point - proj->point), proj->distance, 1e-9);
+        EXPECT_NEAR(1, length(proj->normal), 1e-9);
+
+        // No sample of the surface is closer than the projection
+        double min_dist = length(point - p);
+        for (const auto& grid: samples) {
+            for (const auto& row: grid.points) {
+                for (const auto& sample: row) {
+                    min_dist = std::min(min_dist, length(sample - point));
+                }
+            }
+        }
+        EXPECT_LT(proj->distance, min_dist + 1e-9);
+
+        if (!proj->converged) {
+            continue;
+        }
+        num_converged += 1;
+
+        // In the interior of a face the connection to the closest point is perpendicular to the surface
+        auto inside = [](double c) { return c > 0 && c < 1; };
+        if (inside(proj->uv.x) && inside(proj->uv.y)) {
+            EXPECT_NEAR(0, dot(point - p, du), 1e-6 * length(du));
+            EXPECT_NEAR(0, dot(point - p, dv), 1e-6 * length(dv));
+        }
+    }
+    EXPECT_GT(num_converged, points.size() * 9 / 10);
+}
+
+TEST(SurfaceProjectorTest, PointsOnSurfaceAreKept) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_projector projector(evaluator, 4);
+
+    for (const auto& grid: evaluator.eval_per_face(3)) {
+        for (const auto& row: grid.points) {
+            for (const auto& p: row) {
+                auto proj = projector.project(p);
+                ASSERT_TRUE(proj);
+                EXPECT_LT(proj->distance, 1e-9);
+            }
+        }
+    }
+}
+
+TEST(SurfaceProjectorTest, BatchMatchesSinglePoints) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_projector projector(evaluator, 4);
+
+    auto points = get_points(evaluator);
+    auto projections = projector.project(points, 4);
+    ASSERT_EQ(points.size(), projections.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        auto expected = projector.project(points[i]);
+        ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(projections[i]));
+        if (expected) {
+            EXPECT_EQ(expected->face, projections[i]->face);
+            EXPECT_EQ(expected->point, projections[i]->point);
+        }
+    }
+}
+
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "tsl/evaluation/tessellation.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/evaluation/surface_projector.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using std::find_if;
+using std::map;
+using std::max;
+using std::min;
+using std::pair;
+
+using glm::length;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Checks, that every edge of the mesh is shared by exactly two triangles.
+void expect_watertight(const triangle_mesh& mesh) {
+    map<pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        for (size_t j = 0; j < 3; ++j) {
+            auto a = mesh.indices[i + j];
+            auto b = mesh.indices[i + (j + 1) % 3];
+            ASSERT_LT(a, mesh.positions.size());
+            edges[{min(a, b), max(a, b)}] += 1;
+        }
+    }
+    for (const auto& [edge, count]: edges) {
+        EXPECT_EQ(2, count) << "edge " << edge.first << " - " << edge.second;
+    }
+}
+
+/// Max distance between the surface and the centroids of the triangles.
+double get_max_error(const surface_projector& projector, const vector<vec3>& positions, const vector<uint32_t>& indices) {
+    vector<vec3> points;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        points.push_back((positions[indices[i]] + positions[indices[i + 1]] + positions[indices[i + 2]]) / 3.0);
+    }
+
+    double out = 0;
+    for (const auto& projection: projector.project(points)) {
+        out = max(out, projection->distance);
+    }
+    return out;
+}
+
+}
+
+TEST(AdaptiveTessellationTest, IsWatertight) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto mesh = tessellate_adaptive(evaluator);
+
+    ASSERT_GT(mesh.num_triangles(), 0);
+    EXPECT_EQ(mesh.num_triangles(), mesh.faces.size());
+    EXPECT_EQ(mesh.positions.size(), mesh.normals.size());
+    expect_watertight(mesh);
+}
+
+TEST(AdaptiveTessellationTest, IsWatertightAtTJunctions) {
+    surface_evaluator evaluator(tmesh_cube(5));
+    evaluator.remove_edges(0.2);
+    auto mesh = tessellate_adaptive(evaluator);
+
+    ASSERT_GT(mesh.num_triangles(), 0);
+    expect_watertight(mesh);
+}
+
+TEST(AdaptiveTessellationTest, VerticesLieOnSurface) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_projector projector(evaluator);
+    tessellation_config config;
+    config.max_chord_error = 1e-2;
+    auto mesh = tessellate_adaptive(evaluator, config);
+
+    auto projections = projector.project(mesh.positions);
+    for (size_t i = 0; i < projections.size(); ++i) {
+        ASSERT_TRUE(projections[i]);
+        EXPECT_LT(projections[i]->distance, 1e-6);
+        EXPECT_NEAR(1, length(mesh.normals[i]), 1e-9);
+    }
+}
+
+TEST(AdaptiveTessellationTest, NeedsFewerTrianglesThanUniformGrids) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    surface_projector projector(evaluator);
+    tessellation_config config;
+    config.max_chord_error = 0.1;
+    config.max_normal_angle = 4;
+    auto mesh = tessellate_adaptive(evaluator, config);
+    auto error = get_max_error(projector, mesh.positions, mesh.indices);
+    EXPECT_LT(error, config.max_chord_error);
+
+    // Find the smallest uniform resolution, which is as accurate as the adaptive tessellation
+    for (uint32_t res = 1; res <= 64; res *= 2) {
+        vector<vec3> positions;
+        vector<uint32_t> indices;
+        for (const auto& grid: evaluator.eval_per_face(res)) {
+            auto first = static_cast<uint32_t>(positions.size());
+            for (const auto& row: grid.points) {
+                positions.insert(positions.end(), row.begin(), row.end());
+            }
+            for (uint32_t y = 0; y < res; ++y) {
+                for (uint32_t x = 0; x < res; ++x) {
+                    auto i = first + y * (res + 1) + x;
+                    indices.insert(indices.end(), {i, i + 1, i + res + 1, i + 1, i + res + 2, i + res + 1});
+                }
+            }
+        }
+        if (get_max_error(projector, positions, indices) <= error) {
+            EXPECT_LT(mesh.num_triangles(), indices.size() / 3);
+            return;
+        }
+    }
+    FAIL() << "no uniform resolution is as accurate as the adaptive tessellation";
+}
+
+TEST(UniformTessellationTest, SharesSamplesOnEdgesAndCorners) {
+    surface_evaluator evaluator(tmesh_cube(4));
+    const auto& tmesh = evaluator.get_tmesh();
+    uint32_t res = 4;
+    auto mesh = tessellate_uniform(evaluator, res);
+
+    // Every vertex of the tmesh, every inner sample of an edge and every inner sample of a face is contained once
+    auto num_vertices = tmesh.num_vertices() + tmesh.num_edges() * (res - 1) + tmesh.num_faces() * (res - 1) * (res - 1);
+    EXPECT_EQ(num_vertices, mesh.positions.size());
+    EXPECT_EQ(tmesh.num_faces() * res * res * 2, mesh.num_triangles());
+    expect_watertight(mesh);
+
+    // The samples are the same as in the grids
+    for (const auto& grid: evaluator.eval_per_face(res)) {
+        for (const auto& row: grid.points) {
+            for (const auto& p: row) {
+                auto found = find_if(mesh.positions.begin(), mesh.positions.end(), [&](const vec3& pos) {
+                    return length(pos - p) < 1e-9;
+                });
+                EXPECT_NE(mesh.positions.end(), found);
+            }
+        }
+    }
+}
+
+TEST(UniformTessellationTest, IsWatertightAtTJunctions) {
+    surface_evaluator evaluator(tmesh_cube(5));
+    evaluator.remove_edges(0.2);
+    auto mesh = tessellate_uniform(evaluator, 3);
+
+    ASSERT_GT(mesh.num_triangles(), 0);
+    expect_watertight(mesh);
+}
+
+TEST(UniformTessellationTest, TessellatesSnapshotDuringEditTransaction) {
+    surface_evaluator evaluator(tmesh_cube(8));
+    auto expected = tessellate_uniform(evaluator, 3);
+
+    // The removed face and its half edges are only erased from the tmesh, the snapshot keeps them until the commit
+    evaluator.begin_edits();
+    auto removed = false;
+    for (const auto& eh: evaluator.get_tmesh().get_edges()) {
+        if (evaluator.remove_edge(eh, false)) {
+            removed = true;
+            break;
+        }
+    }
+    ASSERT_TRUE(removed);
+
+    auto mesh = tessellate_uniform(evaluator, 3);
+    EXPECT_EQ(expected.positions, mesh.positions);
+    EXPECT_EQ(expected.indices, mesh.indices);
+    EXPECT_EQ(expected.faces, mesh.faces);
+    evaluator.commit_edits();
+}
+
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tsl/geometry/tmesh/control_polygon_bvh.hpp"
+#include "tsl/algorithm/generator.hpp"
+
+using std::clamp;
+using std::numeric_limits;
+using std::optional;
+using std::set;
+using std::vector;
+
+using glm::dot;
+using glm::length;
+using glm::normalize;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Radius, which is larger than in the editor, so rays hit multiple vertices and edges.
+constexpr double RADIUS = 0.05;
+
+/// Tests all vertices of the mesh like `control_polygon_bvh::pick_vertex`.
+optional<control_vertex_hit> pick_vertex_brute_force(const tmesh& mesh, const line& ray, double radius) {
+    optional<control_vertex_hit> closest;
+    for (const auto& vh: mesh.get_vertices()) {
+        auto point = mesh.get_vertex_position(vh);
+        auto t = dot(point - ray.support_vector, ray.normal);
+        if (t < 0 || (closest && t >= closest->t)) {
+            continue;
+        }
+        if (length(ray.support_vector + t * ray.normal - point) <= radius) {
+            closest = control_vertex_hit(vh, point, t);
+        }
+    }
+    return closest;
+}
+
+/// Tests all edges of the mesh like `control_polygon_bvh::pick_edge`.
+optional<control_edge_hit> pick_edge_brute_force(const tmesh& mesh, const line& ray, double radius, double t_max) {
+    optional<control_edge_hit> closest;
+    for (const auto& eh: mesh.get_edges()) {
+        auto [first, second] = mesh.get_vertices_of_edge(eh);
+        auto start = mesh.get_vertex_position(first);
+        auto dir = mesh.get_vertex_position(second) - start;
+        auto dir_length2 = dot(dir, dir);
+        if (dir_length2 == 0) {
+            continue;
+        }
+
+        auto w = ray.support_vector - start;
+        auto b = dot(ray.normal, dir);
+        auto d = dot(ray.normal, w);
+        auto e = dot(dir, w);
+        auto denom = dir_length2 - b * b;
+        auto s = denom > 0 ? clamp((e - b * d) / denom, 0.0, 1.0) : 0.0;
+        auto t = s * b - d;
+        s = clamp(dot(ray.support_vector + t * ray.normal - start, dir) / dir_length2, 0.0, 1.0);
+        auto point = start + s * dir;
+        t = dot(point - ray.support_vector, ray.normal);
+
+        if (t < 0 || t > t_max || (closest && t >= closest->t)) {
+            continue;
+        }
+        if (length(ray.support_vector + t * ray.normal - point) <= radius) {
+            closest = control_edge_hit(eh, point, t);
+        }
+    }
+    return closest;
+}
+
+/// Rays from different directions towards all vertices and the midpoints of all edges, slightly offset.
+vector<line> get_rays(const tmesh& mesh) {
+    vector<vec3> targets;
+    for (const auto& vh: mesh.get_vertices()) {
+        targets.push_back(mesh.get_vertex_position(vh));
+    }
+    for (const auto& eh: mesh.get_edges()) {
+        auto [first, second] = mesh.get_vertices_of_edge(eh);
+        targets.push_back((mesh.get_vertex_position(first) + mesh.get_vertex_position(second)) * 0.5);
+    }
+
+    vector<vec3> dirs = {
+        normalize(vec3(1, 0.3, 0.2)),
+        normalize(vec3(-0.4, 1, 0.1)),
+        normalize(vec3(0.2, -0.3, -1)),
+        normalize(vec3(-1, -1, 1)),
+    };
+    vector<line> out;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const auto& dir = dirs[i % dirs.size()];
+        auto offset = vec3(0.01, -0.02, 0.015) * static_cast<double>(i % 3);
+        out.emplace_back(targets[i] + offset - 20.0 * dir, dir);
+    }
+    return out;
+}
+
+void expect_same_picks(const tmesh& mesh, const control_polygon_bvh& bvh) {
+    size_t num_vertex_hits = 0;
+    size_t num_edge_hits = 0;
+    for (const auto& ray: get_rays(mesh)) {
+        auto expected_vertex = pick_vertex_brute_force(mesh, ray, RADIUS);
+        auto vertex = bvh.pick_vertex(ray, RADIUS);
+        ASSERT_EQ(static_cast<bool>(expected_vertex), static_cast<bool>(vertex));
+        if (vertex) {
+            EXPECT_EQ(expected_vertex->handle, vertex->handle);
+            EXPECT_EQ(expected_vertex->t, vertex->t);
+            num_vertex_hits += 1;
+        }
+
+        // Limit the edges to the front half of the mesh, like the surface does in the editor
+        for (auto t_max: {numeric_limits<double>::infinity(), 20.0}) {
+            auto expected_edge = pick_edge_brute_force(mesh, ray, RADIUS, t_max);
+            auto edge = bvh.pick_edge(ray, RADIUS, t_max);
+            ASSERT_EQ(static_cast<bool>(expected_edge), static_cast<bool>(edge));
+            if (edge) {
+                EXPECT_EQ(expected_edge->handle, edge->handle);
+                EXPECT_EQ(expected_edge->t, edge->t);
+                num_edge_hits += 1;
+            }
+        }
+    }
+    EXPECT_GT(num_vertex_hits, 0);
+    EXPECT_GT(num_edge_hits, 0);
+}
+
+}
+
+TEST(ControlPolygonBvhTest, PicksMatchBruteForce) {
+    auto mesh = tmesh_cube(6);
+    control_polygon_bvh bvh(mesh);
+    EXPECT_EQ(mesh.num_vertices(), bvh.num_vertices());
+    EXPECT_EQ(mesh.num_edges(), bvh.num_edges());
+    expect_same_picks(mesh, bvh);
+}
+
+TEST(ControlPolygonBvhTest, PicksMatchBruteForceAfterRemovingEdges) {
+    auto mesh = tmesh_cube(8);
+    size_t removed = 0;
+    vector<edge_handle> edges;
+    for (const auto& eh: mesh.get_edges()) {
+        edges.push_back(eh);
+    }
+    for (size_t i = 0; i < edges.size(); i += 7) {
+        removed += mesh.remove_edge(edges[i]) ? 1 : 0;
+    }
+    ASSERT_GT(removed, 0);
+
+    expect_same_picks(mesh, control_polygon_bvh(mesh));
+}
+
+TEST(ControlPolygonBvhTest, RefitMatchesBruteForce) {
+    auto mesh = tmesh_cube(6);
+    control_polygon_bvh bvh(mesh);
+
+    set<vertex_handle> moved;
+    size_t i = 0;
+    for (const auto& vh: mesh.get_vertices()) {
+        if (i++ % 5 == 0) {
+            mesh.get_vertex_position(vh) *= 1.3;
+            moved.insert(vh);
+        }
+    }
+    bvh.refit(mesh, moved);
+
+    expect_same_picks(mesh, bvh);
+}
+
+}
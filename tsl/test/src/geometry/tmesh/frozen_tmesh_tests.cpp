@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "tsl/geometry/tmesh/tmesh.hpp"
+#include "tsl/geometry/tmesh/frozen_tmesh.hpp"
+#include "tsl_tests/geometry/tmesh/tmesh_fixtures.hpp"
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/**
+ * @brief Checks, that the frozen mesh answers all queries exactly like the tmesh.
+ */
+void expect_same_mesh(const tmesh& mesh, const frozen_tmesh& frozen) {
+    ASSERT_EQ(mesh.num_vertices(), frozen.num_vertices());
+    ASSERT_EQ(mesh.num_faces(), frozen.num_faces());
+    ASSERT_EQ(mesh.num_half_edges(), frozen.num_half_edges());
+
+    for (const auto& eh: mesh.get_half_edges()) {
+        EXPECT_EQ(mesh.get_next(eh), frozen.get_next(eh));
+        EXPECT_EQ(mesh.get_prev(eh), frozen.get_prev(eh));
+        EXPECT_EQ(mesh.get_twin(eh), frozen.get_twin(eh));
+        EXPECT_EQ(mesh.get_target(eh), frozen.get_target(eh));
+        EXPECT_EQ(mesh.get_face_of_half_edge(eh), frozen.get_face_of_half_edge(eh));
+        EXPECT_EQ(mesh.get_knot_interval(eh), frozen.get_knot_interval(eh));
+        EXPECT_EQ(mesh.get_knot_factor(eh), frozen.get_knot_factor(eh));
+        EXPECT_EQ(mesh.corner(eh), frozen.corner(eh));
+        EXPECT_EQ(mesh.from_corner(eh), frozen.from_corner(eh));
+    }
+
+    for (const auto& fh: mesh.get_faces()) {
+        EXPECT_EQ(mesh.get_edge(fh), frozen.get_edge(fh));
+        EXPECT_EQ(mesh.get_half_edges_of_face(fh), frozen.get_half_edges_of_face(fh));
+
+        vector<vertex_handle> vertices;
+        frozen.get_vertices_of_face(fh, vertices);
+        EXPECT_EQ(mesh.get_vertices_of_face(fh), vertices);
+
+        for (const auto& nfh: mesh.get_neighbours_of_face(fh)) {
+            EXPECT_EQ(mesh.get_half_edge_between(fh, nfh), frozen.get_half_edge_between(fh, nfh));
+        }
+    }
+
+    for (const auto& vh: mesh.get_vertices()) {
+        EXPECT_EQ(mesh.get_vertex_position(vh), frozen.get_vertex_position(vh));
+        EXPECT_EQ(mesh.get_out(vh), frozen.get_out(vh));
+        EXPECT_EQ(mesh.get_valence(vh), frozen.get_valence(vh));
+        EXPECT_EQ(mesh.get_extended_valence(vh), frozen.get_extended_valence(vh));
+        EXPECT_EQ(mesh.is_extraordinary(vh), frozen.is_extraordinary(vh));
+        EXPECT_EQ(
+            mesh.get_half_edges_of_vertex(vh, edge_direction::ingoing),
+            frozen.get_half_edges_of_vertex(vh, edge_direction::ingoing)
+        );
+        EXPECT_EQ(
+            mesh.get_half_edges_of_vertex(vh, edge_direction::outgoing),
+            frozen.get_half_edges_of_vertex(vh, edge_direction::outgoing)
+        );
+    }
+}
+
+}
+
+TEST_F(TmeshTestWithCubeData, FrozenMeshMatchesTmesh) {
+    expect_same_mesh(mesh, frozen_tmesh(mesh));
+}
+
+TEST_F(TmeshTestWithTfaceTest, FrozenMeshMatchesTmesh) {
+    expect_same_mesh(mesh, frozen_tmesh(mesh));
+}
+
+TEST_F(TmeshTestAsGrid, FrozenMeshMatchesTmeshAfterRemovingEdges) {
+    mesh.remove_edge(edge_handle(0));
+    expect_same_mesh(mesh, frozen_tmesh(mesh));
+}
+
+TEST_F(TmeshTestWithCubeData, FrozenMeshSetVertexPosition) {
+    frozen_tmesh frozen(mesh);
+    frozen.set_vertex_position(vertex_handles[0], vec3(1, 2, 3));
+    EXPECT_EQ(vec3(1, 2, 3), frozen.get_vertex_position(vertex_handles[0]));
+    EXPECT_EQ(mesh.get_vertex_position(vertex_handles[1]), frozen.get_vertex_position(vertex_handles[1]));
+}
+
+}
@@ -642,4 +642,102 @@ TEST_F(TmeshTestWithTfaceTest, GetExtendedValence) {
     EXPECT_EQ(4, mesh.get_extended_valence(vertex_handles[4]));
 }
 
+namespace {
+
+/**
+ * @brief Describes every face by the positions, knots and corners along its half edges, starting at its edge.
+ *
+ * The result is sorted and does not contain any handles, so it can be used to compare meshes with different handles.
+ */
+vector<vector<double>> get_face_descriptions(const tmesh& mesh) {
+    vector<vector<double>> out;
+    for (const auto& fh: mesh.get_faces()) {
+        vector<double> description;
+        for (const auto& eh: mesh.get_half_edges_of_face(fh)) {
+            auto pos = mesh.get_vertex_position(mesh.get_target(eh));
+            auto twin_knot = mesh.get_knot_interval(mesh.get_twin(eh));
+            description.insert(description.end(), {
+                pos.x, pos.y, pos.z,
+                *mesh.get_knot_interval(eh),
+                *mesh.corner(eh) ? 1.0 : 0.0,
+                twin_knot ? *twin_knot : -1.0
+            });
+        }
+        out.push_back(description);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+/**
+ * @brief Checks, that the mesh is compact and every face (except the first one) has a neighbour in front of it.
+ */
+void expect_compact_breadth_first_order(const tmesh& mesh) {
+    tsl::index expected = 0;
+    for (const auto& fh: mesh.get_faces()) {
+        EXPECT_EQ(expected++, fh.get_idx());
+        if (fh.get_idx() == 0) {
+            continue;
+        }
+        auto neighbours = mesh.get_neighbours_of_face(fh);
+        EXPECT_TRUE(std::any_of(neighbours.begin(), neighbours.end(), [&](const auto& nfh) {
+            return nfh.get_idx() < fh.get_idx();
+        }));
+    }
+    expected = 0;
+    for (const auto& vh: mesh.get_vertices()) {
+        EXPECT_EQ(expected++, vh.get_idx());
+    }
+    expected = 0;
+    for (const auto& eh: mesh.get_half_edges()) {
+        EXPECT_EQ(expected++, eh.get_idx());
+    }
+}
+
+}
+
+TEST_F(TmeshTestWithCubeData, Reorder) {
+    auto descriptions = get_face_descriptions(mesh);
+    auto num_vertices = mesh.num_vertices();
+    auto num_half_edges = mesh.num_half_edges();
+
+    mesh.reorder();
+
+    EXPECT_EQ(num_vertices, mesh.num_vertices());
+    EXPECT_EQ(num_half_edges, mesh.num_half_edges());
+    EXPECT_EQ(descriptions, get_face_descriptions(mesh));
+    expect_compact_breadth_first_order(mesh);
+}
+
+TEST_F(TmeshTestAsGrid, ReorderAfterRemovingEdges) {
+    ASSERT_TRUE(mesh.remove_edge(mesh.get_edge_between(vertex_handles[40], vertex_handles[49]).unwrap()));
+    auto descriptions = get_face_descriptions(mesh);
+    auto num_vertices = mesh.num_vertices();
+    auto num_faces = mesh.num_faces();
+    auto num_half_edges = mesh.num_half_edges();
+
+    mesh.reorder();
+
+    EXPECT_EQ(num_vertices, mesh.num_vertices());
+    EXPECT_EQ(num_faces, mesh.num_faces());
+    EXPECT_EQ(num_half_edges, mesh.num_half_edges());
+    EXPECT_EQ(descriptions, get_face_descriptions(mesh));
+    expect_compact_breadth_first_order(mesh);
+}
+
+TEST_F(TmeshTestAsGrid, MemoryReportCountsRemovedElementsAsDeleted) {
+    auto before = mesh.memory_report();
+    EXPECT_EQ(0, before.get_total().deleted_bytes);
+    EXPECT_LE(before.get("faces").used_bytes, before.get("faces").reserved_bytes);
+
+    ASSERT_TRUE(mesh.remove_edge(mesh.get_edge_between(vertex_handles[40], vertex_handles[49]).unwrap()));
+    auto after = mesh.memory_report();
+    EXPECT_GT(after.get("half_edges").deleted_bytes, 0);
+    EXPECT_GT(after.get("faces").deleted_bytes, 0);
+    EXPECT_LT(after.get("faces").used_bytes, before.get("faces").used_bytes);
+
+    mesh.reorder();
+    EXPECT_EQ(0, mesh.memory_report().get_total().deleted_bytes);
+}
+
 }
@@ -28,6 +28,12 @@ TEST_F(EigenCacheTest, Get) {
     EXPECT_TRUE(eigen3.loaded_);
 }
 
+TEST_F(EigenCacheTest, MaxValence) {
+    auto& eigen = cache.get(eigen_handle(MAX_VALENCE));
+    EXPECT_EQ(MAX_VALENCE, eigen.N_);
+    EXPECT_TRUE(eigen.loaded_);
+}
+
 #ifndef NDEBUG
 TEST_F(EigenCacheTest, InvalidValence) {
     EXPECT_THROW(cache.get(eigen_handle(0)), panic_exception);
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/evaluation/eval_sink.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/util/alloc_stats.hpp"
+
+using std::make_unique;
+using std::vector;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+/// Discards all evaluated points.
+class discard_sink : public eval_sink {
+public:
+    void begin_face(face_handle handle, size_t num_points_x, size_t num_points_y) override {}
+    void add_point(size_t x, size_t y, const vec3& pos, const vec3& normal) override {}
+};
+
+/**
+ * @brief Returns the faces of the given evaluator, which don't contain extraordinary vertices and are therefore
+ *        evaluated with b-splines.
+ */
+vector<face_handle> get_bspline_faces(const surface_evaluator& evaluator) {
+    const auto& mesh = evaluator.get_tmesh();
+    vector<face_handle> out;
+    for (const auto& fh: mesh.get_faces()) {
+        auto extraordinary = false;
+        for (const auto& vh: mesh.get_vertices_of_face(fh)) {
+            extraordinary |= mesh.is_extraordinary(vh);
+        }
+        if (!extraordinary) {
+            out.push_back(fh);
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(AllocStatsTest, CountsAllocationsInScope) {
+    if (!is_alloc_tracking_enabled()) {
+        GTEST_SKIP() << "allocations are only counted with TSL_ALLOC_HOOKS";
+    }
+
+    alloc_scope scope;
+    auto values = make_unique<vector<int>>(100);
+    auto stats = scope.get();
+    EXPECT_EQ(2, stats.count);
+    EXPECT_EQ(sizeof(vector<int>) + 100 * sizeof(int), stats.bytes);
+}
+
+TEST(AllocStatsTest, CountsNothingWithoutHooks) {
+    if (is_alloc_tracking_enabled()) {
+        GTEST_SKIP() << "allocations are counted with TSL_ALLOC_HOOKS";
+    }
+
+    alloc_scope scope;
+    auto values = make_unique<vector<int>>(100);
+    EXPECT_EQ(0, scope.get().count);
+    EXPECT_EQ(0, get_alloc_stats().bytes);
+}
+
+TEST(AllocStatsTest, BsplineEvaluationDoesNotAllocatePerPoint) {
+    if (!is_alloc_tracking_enabled()) {
+        GTEST_SKIP() << "allocations are only counted with TSL_ALLOC_HOOKS";
+    }
+
+    surface_evaluator evaluator(tmesh_cube(4));
+    auto faces = get_bspline_faces(evaluator);
+    ASSERT_FALSE(faces.empty());
+
+    discard_sink sink;
+    alloc_scope low_res;
+    evaluator.eval_faces(2, faces, sink);
+    auto low_res_stats = low_res.get();
+
+    alloc_scope high_res;
+    evaluator.eval_faces(32, faces, sink);
+    EXPECT_EQ(low_res_stats.count, high_res.get().count);
+}
+
+}
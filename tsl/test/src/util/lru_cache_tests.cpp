@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <tsl/util/lru_cache.hpp>
+
+using std::string;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsedValues) {
+    lru_cache<int, string> cache(10);
+    cache.insert(1, "one", 4);
+    cache.insert(2, "two", 4);
+    ASSERT_NE(nullptr, cache.find(1));
+
+    cache.insert(3, "three", 4);
+    EXPECT_EQ(2, cache.num_values());
+    EXPECT_EQ(8, cache.get_size());
+    EXPECT_EQ(nullptr, cache.find(2));
+    ASSERT_NE(nullptr, cache.find(1));
+    EXPECT_EQ("one", *cache.find(1));
+    ASSERT_NE(nullptr, cache.find(3));
+    EXPECT_EQ("three", *cache.find(3));
+}
+
+TEST(LruCacheTest, ReplacesValuesOfSameKey) {
+    lru_cache<int, string> cache(10);
+    cache.insert(1, "one", 4);
+    cache.insert(1, "uno", 6);
+    EXPECT_EQ(1, cache.num_values());
+    EXPECT_EQ(6, cache.get_size());
+    EXPECT_EQ("uno", *cache.find(1));
+}
+
+TEST(LruCacheTest, IgnoresValuesLargerThanCache) {
+    lru_cache<int, string> cache(10);
+    cache.insert(1, "one", 4);
+    cache.insert(2, "two", 11);
+    EXPECT_EQ(nullptr, cache.find(2));
+    EXPECT_NE(nullptr, cache.find(1));
+
+    cache.set_max_size(3);
+    EXPECT_EQ(0, cache.num_values());
+    EXPECT_EQ(0, cache.get_size());
+}
+
+}
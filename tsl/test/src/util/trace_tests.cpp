@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "tsl/algorithm/generator.hpp"
+#include "tsl/evaluation/surface_evaluator.hpp"
+#include "tsl/util/trace.hpp"
+
+using std::string;
+using std::thread;
+
+using namespace tsl;
+
+namespace tsl_tests {
+
+namespace {
+
+bool contains(const string& str, const string& part) {
+    return str.find(part) != string::npos;
+}
+
+}
+
+TEST(TraceTest, RecordsZonesOfAllThreads) {
+    if (!TRACE_COMPILED) {
+        GTEST_SKIP() << "trace zones are only compiled in with TSL_TRACE";
+    }
+
+    clear_trace();
+    start_trace();
+    {
+        TSL_TRACE_ZONE("test_main_zone");
+        thread worker([]() { TSL_TRACE_ZONE("test_worker_zone"); });
+        worker.join();
+    }
+    stop_trace();
+
+    auto json = trace_to_json();
+    EXPECT_TRUE(contains(json, "\"name\": \"test_main_zone\", \"ph\": \"X\""));
+    EXPECT_TRUE(contains(json, "\"name\": \"test_worker_zone\", \"ph\": \"X\""));
+}
+
+TEST(TraceTest, RecordsCacheStages) {
+    if (!TRACE_COMPILED) {
+        GTEST_SKIP() << "trace zones are only compiled in with TSL_TRACE";
+    }
+
+    clear_trace();
+    start_trace();
+    surface_evaluator evaluator(tmesh_cube(3));
+    stop_trace();
+
+    auto json = trace_to_json();
+    EXPECT_TRUE(contains(json, "\"update_cache\""));
+    EXPECT_TRUE(contains(json, "\"support\""));
+}
+
+TEST(TraceTest, IgnoresZonesWhileStoppedOrCleared) {
+    clear_trace();
+    start_trace();
+    {
+        TSL_TRACE_ZONE("test_cleared_zone");
+    }
+    stop_trace();
+    clear_trace();
+    {
+        TSL_TRACE_ZONE("test_stopped_zone");
+    }
+
+    auto json = trace_to_json();
+    EXPECT_FALSE(contains(json, "test_cleared_zone"));
+    EXPECT_FALSE(contains(json, "test_stopped_zone"));
+    EXPECT_TRUE(contains(json, "\"traceEvents\""));
+}
+
+}